@@ -14,6 +14,8 @@
 #ifndef CAMERA_H
 #define CAMERA_H
 
+#include "Frustum.h"
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -747,6 +749,16 @@ public:
      */
     bool IsInView(const glm::vec3 &point, float radius = 0.0f) const;
 
+    /**
+     * @brief Get the world space view frustum
+     *
+     * Testing many bounding volumes against the extracted planes is cheaper and
+     * tighter than IsInView() for each of them.
+     *
+     * @return Frustum of GetViewProjectionMatrix()
+     */
+    Frustum GetFrustum() const;
+
 private:
     /**
      * @brief Update camera direction vectors from Euler angles
@@ -0,0 +1,121 @@
+#ifndef COLLISION_BVH_H
+#define COLLISION_BVH_H
+
+#include "SweptCollision.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief Closest hit of one ray traced through a CollisionBVH
+ */
+struct RayHit {
+    uint32_t targetIndex{0};                                // Index of the target in the array it was built from
+    CollisionShapeType targetType{CollisionShapeType::None}; // Which target array targetIndex refers to; None on a miss
+    float distance{0.0f};                                   // Distance along the normalized ray direction
+};
+
+/**
+ * @brief Bounding volume hierarchy over collision spheres, boxes and capsules
+ *
+ * Built once from the target arrays (rebuild it when targets move) and traced
+ * with batches of rays. Rays are grouped into packets of as many rays as the
+ * widest SIMD path reported by simd::GetInstructionSet() has lanes; a packet
+ * walks the tree together, visiting a node if any of its rays may still hit
+ * inside it, and tests leaf shapes against all of its rays at once. Packets of
+ * coherent rays (e.g. a burst of laser shots) therefore share most of their
+ * traversal.
+ */
+class CollisionBVH {
+public:
+    /**
+     * @brief Rebuild the tree from scratch
+     * @param spheres Sphere targets
+     * @param boxes Axis-aligned box targets
+     * @param capsules Capsule targets
+     */
+    void Build(const std::vector<CollisionSphere> &spheres, const std::vector<CollisionAABB> &boxes,
+               const std::vector<CollisionCapsule> &capsules);
+
+    /**
+     * @brief Remove all targets
+     */
+    void Clear();
+
+    /**
+     * @brief Get number of targets in the tree
+     */
+    size_t GetPrimitiveCount() const {
+        return m_primitives.size();
+    }
+
+    /**
+     * @brief Get number of tree nodes
+     */
+    size_t GetNodeCount() const {
+        return m_nodes.size();
+    }
+
+    /**
+     * @brief Find the closest target along each ray
+     * @param origins Ray origins
+     * @param directions Ray directions (need not be normalized)
+     * @param maxDistances Length of each ray along its normalized direction
+     * @param count Number of rays
+     * @param hits Receives one entry per ray (resized to count)
+     */
+    void Trace(const glm::vec3 *origins, const glm::vec3 *directions, const float *maxDistances, size_t count,
+               std::vector<RayHit> &hits);
+
+private:
+    friend struct BVHTraceView;
+
+    struct Node {
+        glm::vec3 min;
+        uint32_t first; // First primitive of a leaf, or index of the left child (right = first + 1)
+        glm::vec3 max;
+        uint16_t count; // Number of primitives; 0 for inner nodes
+        uint16_t axis;  // Split axis of inner nodes, used to order traversal
+    };
+
+    struct Primitive {
+        uint32_t index; // Index into the matching shape array
+        CollisionShapeType type;
+    };
+
+    struct BuildEntry {
+        glm::vec3 min;
+        glm::vec3 max;
+        glm::vec3 centroid;
+        Primitive primitive;
+    };
+
+    /**
+     * @brief Fill node nodeIndex with build entries [first, first + count), splitting recursively
+     */
+    void BuildNode(uint32_t nodeIndex, uint32_t first, uint32_t count);
+
+    std::vector<CollisionSphere> m_spheres;
+    std::vector<CollisionAABB> m_boxes;
+    std::vector<CollisionCapsule> m_capsules;
+
+    std::vector<Node> m_nodes;
+    std::vector<Primitive> m_primitives; // Ordered so every leaf owns a contiguous range
+
+    std::vector<BuildEntry> m_buildEntries; // Build scratch
+
+    // Trace scratch (structure-of-arrays rays, padded to the widest lane count)
+    std::vector<float> m_startX, m_startY, m_startZ;
+    std::vector<float> m_deltaX, m_deltaY, m_deltaZ;
+    std::vector<float> m_inverseDeltaX, m_inverseDeltaY, m_inverseDeltaZ;
+    std::vector<float> m_lengthSquared;
+    std::vector<float> m_times;
+    std::vector<uint32_t> m_targets;
+    std::vector<CollisionShapeType> m_types;
+};
+
+} // namespace agl
+
+#endif // COLLISION_BVH_H
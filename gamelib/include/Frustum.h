@@ -0,0 +1,44 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+namespace agl {
+
+/**
+ * @brief View frustum as six planes, for culling bounding volumes
+ *
+ * Planes point inward and are normalized, so dot(plane.xyz, p) + plane.w is
+ * the signed distance of p from the plane, positive on the inside. The tests
+ * are conservative: volumes near a frustum corner may pass although they are
+ * outside, but visible volumes are never rejected.
+ */
+struct Frustum {
+    enum Plane { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    glm::vec4 planes[PlaneCount];
+
+    /**
+     * @brief Extract the planes of a view-projection matrix (Gribb and Hartmann)
+     *
+     * The planes are in the space the matrix transforms from: pass
+     * projection * view for world space, or projection * view * model to test
+     * object space volumes without transforming them.
+     * @param viewProjection Matrix mapping into OpenGL clip space
+     */
+    static Frustum FromMatrix(const glm::mat4 &viewProjection);
+
+    /**
+     * @brief Check whether a sphere is at least partly inside
+     */
+    bool IntersectsSphere(const glm::vec3 &center, float radius) const;
+
+    /**
+     * @brief Check whether an axis-aligned box is at least partly inside
+     */
+    bool IntersectsBox(const glm::vec3 &min, const glm::vec3 &max) const;
+};
+
+} // namespace agl
+
+#endif // FRUSTUM_H
@@ -0,0 +1,77 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <cstddef>
+
+namespace agl {
+
+/**
+ * @brief Kinds of memory tracked by MemoryStats
+ */
+enum class MemoryCategory {
+    MeshCPU = 0, // System memory copies of mesh geometry
+    MeshGPU = 1, // Mesh vertex and index buffers
+    Count
+};
+
+/**
+ * @brief Counters of one memory category, in bytes
+ */
+struct MemoryCategoryStats {
+    size_t current{0};  // Currently allocated
+    size_t peak{0};     // Highest value of current since start or ResetPeaks()
+    size_t released{0}; // Freed early because the owner no longer needed it (see MemoryStats::Release)
+};
+
+/**
+ * @brief Engine-wide memory counters
+ *
+ * Systems report their allocations by category; the counters are atomic, so
+ * reporting from worker threads is safe. They are statistics, not an allocator:
+ * each owner is responsible for freeing exactly what it allocated.
+ */
+class MemoryStats {
+public:
+    /**
+     * @brief Record an allocation
+     */
+    static void Allocate(MemoryCategory category, size_t bytes);
+
+    /**
+     * @brief Record memory returned at the end of its owner's life
+     */
+    static void Free(MemoryCategory category, size_t bytes);
+
+    /**
+     * @brief Record memory dropped while its owner lives on, such as geometry discarded after upload
+     *
+     * Frees the bytes and adds them to the category's released total, which
+     * tells how much a policy like MeshResidency saves.
+     */
+    static void Release(MemoryCategory category, size_t bytes);
+
+    /**
+     * @brief Get the counters of a category
+     */
+    static MemoryCategoryStats Get(MemoryCategory category);
+
+    /**
+     * @brief Get the memory currently allocated in all categories
+     */
+    static size_t GetTotal();
+
+    /**
+     * @brief Restart peak tracking from the current values
+     */
+    static void ResetPeaks();
+
+    /**
+     * @brief Get a printable name for a category
+     * @return Name such as "Mesh CPU"
+     */
+    static const char *GetCategoryName(MemoryCategory category);
+};
+
+} // namespace agl
+
+#endif // MEMORY_STATS_H
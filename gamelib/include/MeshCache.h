@@ -0,0 +1,229 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "mesh.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace agl {
+
+constexpr uint32_t MeshCacheMagic = 0x4D4C4741u; // "AGLM" in file order
+constexpr uint32_t MeshCacheVersion = 3;
+constexpr uint32_t MeshCacheAlignment = 64; // Section alignment within the file
+
+/**
+ * @brief Sections of a mesh cache file
+ */
+enum class MeshCacheSection : uint32_t {
+    GpuVertices, // Vertices in the stored vertex format, ready for VertexBuffer::SetData
+    CpuVertices, // Full Vertex records for compact formats (empty for Standard, which shares GpuVertices)
+    Indices,     // Full-detail indices followed by every LOD's indices, ready for IndexBuffer::SetData
+    LODs,        // MeshLOD records of levels 1..N
+    Meshlets,    // Meshlet records over the full-detail indices
+    Material,    // One MeshCacheMaterial
+    Strings,     // Null-terminated texture paths referenced by the material
+    Count
+};
+
+/**
+ * @brief Byte range of a section, relative to the start of the file
+ */
+struct MeshCacheSectionRange {
+    uint64_t offset;
+    uint64_t size;
+};
+
+/**
+ * @brief Fixed-size header at the start of a mesh cache file
+ *
+ * The file is written in native byte order; endianMarker and vertexSize reject
+ * files produced on an incompatible platform or with a different Vertex layout.
+ */
+struct MeshCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t endianMarker; // 0x01020304 as written by the producer
+    uint32_t vertexSize;   // sizeof(Vertex) of the producer
+    uint32_t vertexFormat; // VertexFormat of GpuVertices
+    uint32_t vertexCount;
+    uint32_t indexCount; // Full-detail indices; the LOD indices follow them in the same section
+    uint32_t lodIndexCount;
+    uint32_t lodCount;
+    uint32_t meshletCount;
+    uint32_t reserved; // Zero; keeps the section table 8-byte aligned
+    float boundsMin[3];
+    float boundsMax[3];
+    float boundingSphere[4]; // Center and radius
+    float quantizationMin[3]; // Position decode box of CompactQuantized data
+    float quantizationMax[3];
+    MeshCacheSectionRange sections[static_cast<size_t>(MeshCacheSection::Count)];
+};
+
+/**
+ * @brief Material record of a mesh cache file
+ */
+struct MeshCacheMaterial {
+    float ambient[3];
+    float diffuse[3];
+    float specular[3];
+    float shininess;
+    uint32_t diffuseTexture; // Offsets into the Strings section, or MeshCacheNoString
+    uint32_t specularTexture;
+    uint32_t normalTexture;
+};
+
+constexpr uint32_t MeshCacheNoString = 0xFFFFFFFFu;
+
+/**
+ * @brief Texture files referenced by a cached mesh's material
+ *
+ * Textures do not remember where they were loaded from, so the writer is told.
+ * Empty paths are not stored. The loader resolves paths through TextureManager.
+ */
+struct MeshCacheTextures {
+    std::string diffuse;
+    std::string specular;
+    std::string normal;
+};
+
+/**
+ * @brief Read-only memory mapping of a mesh cache file
+ *
+ * Opening validates the header and section ranges but does not touch the
+ * geometry, so the pages are only read when the data is used (typically by the
+ * GPU upload). Pointers stay valid until the file is closed.
+ */
+class MeshCacheFile {
+public:
+    MeshCacheFile() = default;
+    ~MeshCacheFile();
+
+    // Non-copyable but movable
+    MeshCacheFile(const MeshCacheFile &) = delete;
+    MeshCacheFile &operator=(const MeshCacheFile &) = delete;
+    MeshCacheFile(MeshCacheFile &&other) noexcept;
+    MeshCacheFile &operator=(MeshCacheFile &&other) noexcept;
+
+    /**
+     * @brief Map a file and validate it
+     * @return True if the file is a compatible mesh cache
+     */
+    bool Open(const std::string &filepath);
+
+    /**
+     * @brief Unmap the file
+     */
+    void Close();
+
+    bool IsOpen() const {
+        return m_header != nullptr;
+    }
+
+    const MeshCacheHeader &GetHeader() const {
+        return *m_header;
+    }
+
+    VertexFormat GetVertexFormat() const {
+        return static_cast<VertexFormat>(m_header->vertexFormat);
+    }
+
+    /**
+     * @brief Get a section's data, or null if it is empty
+     */
+    const void *GetSection(MeshCacheSection section) const;
+
+    /**
+     * @brief Get a section's size in bytes
+     */
+    size_t GetSectionSize(MeshCacheSection section) const;
+
+    /**
+     * @brief Full Vertex records (the GpuVertices section for Standard meshes)
+     */
+    const Vertex *GetVertices() const;
+
+    const uint32_t *GetIndices() const {
+        return static_cast<const uint32_t *>(GetSection(MeshCacheSection::Indices));
+    }
+
+    const MeshLOD *GetLODs() const {
+        return static_cast<const MeshLOD *>(GetSection(MeshCacheSection::LODs));
+    }
+
+    const Meshlet *GetMeshlets() const {
+        return static_cast<const Meshlet *>(GetSection(MeshCacheSection::Meshlets));
+    }
+
+    const MeshCacheMaterial *GetMaterial() const {
+        return static_cast<const MeshCacheMaterial *>(GetSection(MeshCacheSection::Material));
+    }
+
+    /**
+     * @brief Get a string from the Strings section (empty for MeshCacheNoString)
+     */
+    std::string GetString(uint32_t offset) const;
+
+    size_t GetFileSize() const {
+        return m_size;
+    }
+
+private:
+    bool Validate() const;
+
+    const uint8_t *m_data{nullptr};
+    const MeshCacheHeader *m_header{nullptr};
+    size_t m_size{0};
+#if defined(_WIN32)
+    void *m_fileHandle{nullptr};
+    void *m_mappingHandle{nullptr};
+#endif
+};
+
+/**
+ * @brief Versioned binary cache of Mesh geometry
+ *
+ * Files hold the vertex buffer in the mesh's GPU vertex format, the index buffer
+ * with every level of detail, meshlets, bounds, and the material with its texture
+ * paths.
+ * Sections are aligned so a mapped file is uploaded with VertexBuffer::SetData
+ * and IndexBuffer::SetData directly from the mapping; nothing is parsed or
+ * converted on load.
+ */
+class MeshCache {
+public:
+    /**
+     * @brief Write a mesh to a cache file
+     * @param mesh Mesh to store, with its LODs, meshlets and vertex format; needs its CPU vertices (see
+     *        Mesh::SetResidency)
+     * @param filepath Destination file
+     * @param textures Texture files of the mesh's material
+     * @return True on success
+     */
+    static bool Write(const Mesh &mesh, const std::string &filepath, const MeshCacheTextures &textures = {});
+
+    /**
+     * @brief Load a cache file into a mesh, replacing its geometry and material
+     *
+     * The GPU buffers are filled from the mapped file, and only the CPU copies the
+     * mesh's residency policy keeps are made, so a GpuOnly load never holds the
+     * geometry in memory twice.
+     * @return True on success; the mesh is unchanged on failure
+     */
+    static bool Load(const std::string &filepath, Mesh &mesh);
+
+    /**
+     * @brief Load a cached mesh, or build it and write the cache if the file is missing or stale
+     * @param filepath Cache file
+     * @param build Generates the mesh when the cache cannot be used
+     * @param textures Texture files of the built mesh's material
+     */
+    static Mesh LoadOrBuild(const std::string &filepath, const std::function<Mesh()> &build,
+                            const MeshCacheTextures &textures = {});
+};
+
+} // namespace agl
+
+#endif // MESH_CACHE_H
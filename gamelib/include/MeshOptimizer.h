@@ -0,0 +1,114 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include "mesh.h"
+#include <cstdint>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief Post-transform vertex cache efficiency of an index buffer
+ */
+struct VertexCacheStats {
+    float acmr{0.0f};              // Average cache miss ratio: shaded vertices per triangle (0.5 ideal, 3 worst)
+    float atvr{0.0f};              // Average transform to vertex ratio: shaded vertices per used vertex (1 ideal)
+    size_t transformedVertices{0}; // Vertex shader invocations
+};
+
+/**
+ * @brief Which MeshOptimizer passes to run
+ */
+struct MeshOptimizerSettings {
+    bool weldVertices{true};        // Merge bitwise identical vertices
+    bool optimizeVertexCache{true}; // Reorder triangles for post-transform cache hits
+    bool optimizeOverdraw{true};    // Reorder triangle clusters so outward-facing ones draw first
+    bool optimizeVertexFetch{true}; // Renumber vertices in first-use order, dropping unused ones
+
+    // Overdraw clusters may cost up to this factor of the optimized ACMR (higher allows more, smaller clusters)
+    float overdrawThreshold{1.05f};
+
+    // Cache size assumed when reporting statistics
+    uint32_t analysisCacheSize{16};
+};
+
+/**
+ * @brief Before and after statistics of MeshOptimizer::Optimize
+ */
+struct MeshOptimizerStats {
+    size_t verticesBefore{0};
+    size_t verticesAfter{0};
+    VertexCacheStats cacheBefore;
+    VertexCacheStats cacheAfter;
+};
+
+/**
+ * @brief Offline reordering of mesh data for faster vertex processing
+ *
+ * The passes run in this order: welding, vertex cache reordering (Forsyth's
+ * linear-speed algorithm), overdraw reordering and vertex fetch remapping. The
+ * overdraw pass follows Tipsify (Sander et al. 2007): it cuts the cache-optimized
+ * triangle order into clusters wherever that costs little cache efficiency, then
+ * sorts the clusters so those facing away from the mesh center draw first. None
+ * of the passes changes what is rendered, only the order and numbering.
+ */
+class MeshOptimizer {
+public:
+    /**
+     * @brief Run the enabled passes on vertex and index data
+     *
+     * Non-indexed data (empty indices) is indexed first.
+     * @param vertices Vertex data, rewritten in place
+     * @param indices Triangle list indices, rewritten in place
+     * @param settings Passes to run
+     * @return Statistics before and after
+     */
+    static MeshOptimizerStats Optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+                                       const MeshOptimizerSettings &settings = MeshOptimizerSettings());
+
+    /**
+     * @brief Run the enabled passes on a mesh and re-upload it
+     */
+    static MeshOptimizerStats Optimize(Mesh &mesh, const MeshOptimizerSettings &settings = MeshOptimizerSettings());
+
+    /**
+     * @brief Merge bitwise identical vertices
+     * @return Number of vertices after welding
+     */
+    static size_t WeldVertices(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+    /**
+     * @brief Reorder triangles for the post-transform vertex cache (Forsyth)
+     * @param indices Triangle list indices, reordered in place
+     * @param vertexCount Number of vertices the indices refer to
+     */
+    static void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+
+    /**
+     * @brief Reorder triangle clusters to reduce overdraw (run after OptimizeVertexCache)
+     * @param indices Triangle list indices, reordered in place
+     * @param vertices Vertex data the indices refer to
+     * @param threshold Allowed ACMR growth factor; higher values allow more, smaller clusters
+     */
+    static void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<Vertex> &vertices,
+                                 float threshold = 1.05f);
+
+    /**
+     * @brief Renumber vertices in the order the indices first use them, dropping unused ones
+     * @return Number of vertices after remapping
+     */
+    static size_t OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+    /**
+     * @brief Simulate a FIFO post-transform cache over an index buffer
+     * @param indices Triangle list indices
+     * @param vertexCount Number of vertices the indices refer to
+     * @param cacheSize Number of cache entries
+     */
+    static VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount,
+                                               uint32_t cacheSize = 16);
+};
+
+} // namespace agl
+
+#endif // MESH_OPTIMIZER_H
@@ -0,0 +1,50 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include "mesh.h"
+#include <cstdint>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief Quadric error mesh simplification that keeps the vertex buffer
+ *
+ * Implements Garland and Heckbert's quadric error metric with half-edge
+ * collapses: a vertex is always collapsed onto a neighbouring existing vertex,
+ * so the result is a new index buffer over the unchanged vertices and several
+ * levels of detail can share one vertex buffer.
+ *
+ * Vertices sharing a position (UV or normal seams) move together. A seam vertex
+ * only collapses along the seam, where every copy has a matching copy at the
+ * target, so attributes never smear across a seam. Open borders and non-manifold
+ * edges are locked, and collapses that would flip a triangle are rejected.
+ */
+class MeshSimplifier {
+public:
+    /**
+     * @brief Simplify a triangle list
+     * @param vertices Vertex data (only positions are read)
+     * @param indices Triangle list indices to simplify
+     * @param targetIndexCount Stop once at most this many indices remain
+     * @param maxError Stop before any collapse whose error exceeds this, relative to the mesh extent
+     * @param result Receives the simplified indices (may be larger than the target if the error limit or
+     *        locked vertices prevent further collapses)
+     * @return Largest error introduced, relative to the mesh extent
+     */
+    static float Simplify(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+                          size_t targetIndexCount, float maxError, std::vector<uint32_t> &result);
+
+    /**
+     * @brief Group vertices that share an exact position (UV, normal or hard-edge seams)
+     * @param vertices Vertex data (only positions are read)
+     * @param positionOf Receives, per vertex, the first vertex with the same position
+     * @param nextWedge Receives, per vertex, the next vertex in a ring linking all vertices sharing its position
+     */
+    static void WeldPositions(const std::vector<Vertex> &vertices, std::vector<uint32_t> &positionOf,
+                              std::vector<uint32_t> &nextWedge);
+};
+
+} // namespace agl
+
+#endif // MESH_SIMPLIFIER_H
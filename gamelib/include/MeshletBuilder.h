@@ -0,0 +1,75 @@
+#ifndef MESHLET_BUILDER_H
+#define MESHLET_BUILDER_H
+
+#include "Frustum.h"
+#include "mesh.h"
+#include <cstdint>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief Splits meshes into small triangle clusters and culls them on the CPU
+ *
+ * Large meshes such as hulls and terrain are rarely visible as a whole: part
+ * of them is outside the view and, for closed surfaces, about half faces away
+ * from the camera. Clusters of up to a hundred or so neighbouring triangles are
+ * small enough to be rejected individually, but large enough that testing them
+ * costs far less than drawing them.
+ *
+ * Clusters grow greedily from a seed triangle over shared positions (vertices
+ * split by UV or normal seams count as one, so flat-shaded and seamed meshes
+ * still form full clusters), preferring triangles that add the fewest new
+ * positions and face the same way as the cluster, which keeps clusters compact
+ * and their normal cones narrow. Each
+ * cluster gets a bounding sphere for frustum tests and a normal cone for
+ * back-face tests (the bounds-based cone test of meshoptimizer).
+ */
+class MeshletBuilder {
+public:
+    /**
+     * @brief Reorder triangle list indices into clusters and compute their bounds
+     *
+     * Within a cluster, triangles keep their original relative order, so a vertex
+     * cache order from MeshOptimizer mostly survives.
+     * @param vertices Vertex data the indices refer to
+     * @param indices Triangle list indices, reordered in place
+     * @param maxTriangles Maximum triangles per cluster
+     * @param coneWeight Preference for triangles facing the same way over sharing vertices (0 to 1)
+     * @return Clusters in index buffer order; empty if an index is out of range
+     */
+    static std::vector<Meshlet> Build(const std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+                                      uint32_t maxTriangles = 128, float coneWeight = 0.5f);
+
+    /**
+     * @brief Compute the bounding sphere and normal cone of a cluster's index range
+     * @param vertices Vertex data the indices refer to
+     * @param indices Triangle list indices containing the cluster's range
+     * @param meshlet Cluster whose firstIndex and indexCount are set; receives the bounds
+     */
+    static void ComputeBounds(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+                              Meshlet &meshlet);
+
+    /**
+     * @brief Check whether every triangle of a cluster faces away from a viewpoint
+     * @param meshlet Cluster with bounds
+     * @param cameraPosition Eye position in the cluster's space
+     */
+    static bool IsBackFacing(const Meshlet &meshlet, const glm::vec3 &cameraPosition);
+
+    /**
+     * @brief Collect the clusters inside a frustum that do not face away from the camera
+     * @param meshlets Clusters to test
+     * @param frustum Frustum in the clusters' space (see Frustum::FromMatrix)
+     * @param cameraPosition Eye position in the clusters' space
+     * @param cullBackFaces False to only test against the frustum
+     * @param visible Receives the indices of the visible clusters, in order
+     * @return Counters; ranges is left at zero
+     */
+    static MeshletCullStats Cull(const std::vector<Meshlet> &meshlets, const Frustum &frustum,
+                                 const glm::vec3 &cameraPosition, bool cullBackFaces, std::vector<uint32_t> &visible);
+};
+
+} // namespace agl
+
+#endif // MESHLET_BUILDER_H
@@ -0,0 +1,150 @@
+#ifndef MODEL_LOADER_H
+#define MODEL_LOADER_H
+
+#include "mesh.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace agl {
+
+class ThreadPool;
+
+/**
+ * @brief Material record parsed from an MTL file
+ *
+ * Texture paths are resolved relative to the MTL file; empty when absent.
+ */
+struct ModelMaterial {
+    std::string name;
+    glm::vec3 ambient{0.1f, 0.1f, 0.1f};
+    glm::vec3 diffuse{0.8f, 0.8f, 0.8f};
+    glm::vec3 specular{1.0f, 1.0f, 1.0f};
+    float shininess{32.0f};
+    std::string diffuseMap;
+    std::string specularMap;
+    std::string normalMap;
+};
+
+/**
+ * @brief Indexed geometry of one material of a model, before GPU upload
+ */
+struct ModelMeshData {
+    std::string material; // Name of the ModelMaterial, empty for faces without usemtl
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    bool hasTexCoords{false}; // Some corner had a "vt" reference, so tangents can be derived
+};
+
+/**
+ * @brief Sizes and timings of a model load
+ */
+struct ModelLoadStats {
+    size_t fileBytes{0};
+    size_t chunks{0};     // Pieces the OBJ text was split into for parsing
+    size_t positions{0};  // "v" records in the file
+    size_t vertices{0};   // Unique vertices after deduplication
+    size_t triangles{0};
+    double readMs{0.0};   // Reading the file into memory
+    double parseMs{0.0};  // Parsing, index resolution and deduplication
+    double decodeMs{0.0}; // Decoding the material textures
+    double uploadMs{0.0}; // Creating meshes and textures
+
+    /**
+     * @brief Parse throughput in MB/s (file bytes over parse time)
+     */
+    double GetParseThroughput() const {
+        return parseMs > 0.0 ? static_cast<double>(fileBytes) / (1024.0 * 1024.0) / (parseMs / 1000.0) : 0.0;
+    }
+};
+
+/**
+ * @brief Everything parsed from an OBJ file and its MTL libraries; no GL objects yet
+ */
+struct ModelData {
+    std::vector<ModelMeshData> meshes;
+    std::vector<ModelMaterial> materials;
+    std::unordered_map<std::string, TextureImage> images; // Decoded texture files by path; failures are absent
+    ModelLoadStats stats;
+};
+
+/**
+ * @brief A loaded model: one mesh per material, each carrying that material
+ */
+struct Model {
+    std::vector<std::unique_ptr<Mesh>> meshes;
+    ModelLoadStats stats;
+
+    /**
+     * @brief Render every mesh with its own material
+     */
+    void Render(ShaderProgram &shader, const glm::mat4 &modelMatrix);
+
+    size_t GetTriangleCount() const;
+};
+
+/**
+ * @brief Wavefront OBJ/MTL importer
+ *
+ * The OBJ text is split at line boundaries into chunks that are parsed in
+ * parallel on a ThreadPool; face indices (including negative, relative ones)
+ * are resolved once every chunk's vertex counts are known. Faces are grouped by
+ * usemtl into one mesh per material, polygons are fan-triangulated, and
+ * identical position/texcoord/normal triples are merged through a hash map.
+ * Normals are generated when the file has none, and tangents for meshes whose
+ * material has a normal map.
+ *
+ * Parse() touches no GL state and can run on any thread; it also decodes the
+ * material textures on the pool. CreateModel() only uploads meshes and
+ * textures and must run on the thread owning the GL context.
+ * LoadAsync() does the former on a worker and the latter on DispatchQueue::main().
+ */
+class ModelLoader {
+public:
+    using LoadCallback = std::function<void(std::shared_ptr<Model>)>;
+
+    /**
+     * @brief Parse an OBJ file and the MTL libraries it references, and decode their textures
+     * @param filepath OBJ file
+     * @param data Receives meshes, materials, decoded images and statistics
+     * @param pool Pool the chunks are parsed and the textures decoded on
+     * @return True on success
+     */
+    static bool Parse(const std::string &filepath, ModelData &data, ThreadPool &pool);
+
+    /**
+     * @brief Parse with the shared thread pool
+     */
+    static bool Parse(const std::string &filepath, ModelData &data);
+
+    /**
+     * @brief Parse an MTL file, appending its materials
+     * @return True if the file could be read
+     */
+    static bool ParseMaterials(const std::string &filepath, std::vector<ModelMaterial> &materials);
+
+    /**
+     * @brief Create meshes and textures from parsed data (GL thread only)
+     */
+    static std::unique_ptr<Model> CreateModel(ModelData &&data);
+
+    /**
+     * @brief Parse and create a model on the calling thread (which must own the GL context)
+     * @return The model, or null on failure
+     */
+    static std::unique_ptr<Model> Load(const std::string &filepath);
+
+    /**
+     * @brief Parse on a worker thread, then create the model on the main dispatch queue
+     *
+     * The callback runs on the main thread from DispatchQueue::main().execute(),
+     * which Game calls every frame. It receives null if the file could not be parsed.
+     */
+    static void LoadAsync(const std::string &filepath, LoadCallback onLoaded);
+};
+
+} // namespace agl
+
+#endif // MODEL_LOADER_H
@@ -0,0 +1,283 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include "Shader.h"
+#include "Texture.h"
+#include "VertexArray.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief How particles are blended into the frame
+ */
+enum class ParticleBlendMode {
+    Alpha,   // Standard transparency, sorted back to front (smoke, dust)
+    Additive // Order-independent glow, never sorted (fire, sparks, stars)
+};
+
+/**
+ * @brief Data description of an emitter
+ *
+ * Every value is plain data, so emitters can be built from config files or
+ * tweaked live. Particles launch from a sphere around the emitter position into
+ * a cone around direction, then move under gravity and linear drag while their
+ * color and size blend from the start to the end value over their lifetime.
+ */
+struct ParticleEmitterDesc {
+    uint32_t maxParticles{1024}; // Pool size; spawns beyond it are dropped
+    float spawnRate{50.0f};      // Continuous spawns per second (0 for bursts only)
+
+    glm::vec3 direction{0.0f, 1.0f, 0.0f}; // Center of the launch cone (will be normalized)
+    float spreadAngle{0.5f};               // Half-angle of the launch cone in radians
+    float spawnRadius{0.0f};               // Particles start uniformly inside this sphere
+    float minSpeed{1.0f};
+    float maxSpeed{2.0f};
+    float minLifetime{1.0f};
+    float maxLifetime{2.0f};
+
+    glm::vec3 gravity{0.0f, -9.81f, 0.0f}; // Constant acceleration
+    float drag{0.0f};                      // Linear drag coefficient in 1/s
+
+    glm::vec4 startColor{1.0f};
+    glm::vec4 endColor{1.0f, 1.0f, 1.0f, 0.0f};
+    float startSize{0.5f};
+    float endSize{1.0f};
+
+    uint32_t texture{0}; // Texture page from ParticleSystem::AddTexture (0 = built-in white)
+    ParticleBlendMode blendMode{ParticleBlendMode::Alpha};
+};
+
+/**
+ * @brief Rendering statistics from the last ParticleSystem::Render call
+ */
+struct ParticleRenderStats {
+    uint32_t instanceCount{0}; // Particles drawn
+    uint32_t drawCalls{0};     // Draw calls issued
+};
+
+/**
+ * @brief CPU particle simulation with instanced billboard rendering
+ *
+ * Each emitter owns a structure-of-arrays pool. Update runs one SIMD kernel per
+ * emitter that integrates velocity (gravity and drag) and position and evaluates
+ * color and size over life, then compacts dead particles. Rendering sorts alpha
+ * emitters back to front (a radix sort on view depth per emitter, and emitters by
+ * distance) and issues one instanced billboard draw per texture page and blend mode.
+ */
+class ParticleSystem {
+public:
+    ParticleSystem();
+    ~ParticleSystem() = default;
+
+    /**
+     * @brief Create the GPU resources (requires an OpenGL context)
+     */
+    void Initialize();
+
+    /**
+     * @brief Register a texture page for emitters to use
+     * @param texture Texture (shared with the caller)
+     * @return Page index for ParticleEmitterDesc::texture
+     */
+    uint32_t AddTexture(std::shared_ptr<Texture2D> texture);
+
+    /**
+     * @brief Get number of texture pages, including the built-in white page 0
+     */
+    size_t GetTextureCount() const {
+        return m_textures.size();
+    }
+
+    // ========== Emitters ==========
+
+    static constexpr uint32_t InvalidEmitter = 0xFFFFFFFFu;
+
+    /**
+     * @brief Create an emitter
+     * @param desc Emitter description
+     * @param position Initial emitter position
+     * @return Emitter id, valid until the emitter is destroyed (ids are then reused)
+     */
+    uint32_t CreateEmitter(const ParticleEmitterDesc &desc, const glm::vec3 &position = glm::vec3(0.0f));
+
+    /**
+     * @brief Destroy an emitter and its particles
+     */
+    void DestroyEmitter(uint32_t emitter);
+
+    /**
+     * @brief Destroy the emitter once its particles have died (e.g. after a one-shot burst)
+     *
+     * Stops continuous spawning immediately.
+     */
+    void DestroyEmitterWhenIdle(uint32_t emitter);
+
+    /**
+     * @brief Check if an emitter id refers to a live emitter
+     */
+    bool IsEmitterAlive(uint32_t emitter) const;
+
+    void SetEmitterPosition(uint32_t emitter, const glm::vec3 &position);
+    void SetEmitterDesc(uint32_t emitter, const ParticleEmitterDesc &desc);
+
+    /**
+     * @brief Enable or disable continuous spawning (live particles keep updating)
+     */
+    void SetEmitterActive(uint32_t emitter, bool active);
+
+    /**
+     * @brief Spawn particles immediately
+     * @param emitter Emitter id
+     * @param count Number of particles
+     * @return Number spawned (less than count if the pool is nearly full)
+     */
+    size_t Burst(uint32_t emitter, size_t count);
+
+    /**
+     * @brief Get number of live particles of one emitter
+     */
+    size_t GetParticleCount(uint32_t emitter) const;
+
+    /**
+     * @brief Get number of live particles over all emitters
+     */
+    size_t GetTotalParticleCount() const;
+
+    /**
+     * @brief Get number of live emitters
+     */
+    size_t GetEmitterCount() const;
+
+    /**
+     * @brief Destroy every emitter
+     */
+    void Clear();
+
+    // ========== Simulation & Rendering ==========
+
+    /**
+     * @brief Spawn, simulate and retire particles
+     * @param deltaTime Time step in seconds
+     */
+    void Update(float deltaTime);
+
+    /**
+     * @brief Sort particles for a camera and fill the instance data of every draw batch
+     *
+     * Alpha emitters are ordered back to front and a new batch starts wherever
+     * the texture page changes; additive emitters are grouped by texture page.
+     * Called by Render; exposed so the CPU side can run (or be measured) without
+     * a GL context.
+     * @param viewMatrix Camera view matrix
+     */
+    void BuildDrawBatches(const glm::mat4 &viewMatrix);
+
+    /**
+     * @brief Draw every particle as a camera-facing billboard
+     * @param viewMatrix Camera view matrix
+     * @param projectionMatrix Camera projection matrix
+     */
+    void Render(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+
+    /**
+     * @brief Get statistics from the last Render call
+     */
+    const ParticleRenderStats &GetRenderStats() const {
+        return m_renderStats;
+    }
+
+    /**
+     * @brief Get number of draw batches built by the last BuildDrawBatches call
+     */
+    size_t GetDrawBatchCount() const {
+        return m_batches.size();
+    }
+
+private:
+    /**
+     * @brief One emitter and its structure-of-arrays particle pool
+     *
+     * Arrays are padded to a multiple of the widest lane count so the update
+     * kernel never needs a scalar tail.
+     */
+    struct Emitter {
+        ParticleEmitterDesc desc;
+        glm::vec3 position{0.0f};
+        bool alive{false};
+        bool active{true};
+        bool destroyWhenIdle{false};
+        float spawnAccumulator{0.0f};
+        size_t count{0};
+
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> velocityX, velocityY, velocityZ;
+        std::vector<float> ages, inverseLifetimes;
+        std::vector<float> red, green, blue, alpha;
+        std::vector<float> sizes;
+    };
+
+    /**
+     * @brief Instances sharing one draw call
+     */
+    struct DrawBatch {
+        uint32_t texture;
+        ParticleBlendMode blendMode;
+        size_t firstInstance;
+        size_t instanceCount;
+    };
+
+    /**
+     * @brief Per-instance data streamed to the GPU
+     */
+    struct ParticleInstance {
+        glm::vec4 positionSize;
+        uint32_t color; // RGBA8
+    };
+
+    Emitter *GetEmitter(uint32_t emitter);
+    const Emitter *GetEmitter(uint32_t emitter) const;
+
+    /**
+     * @brief Grow an emitter's arrays to hold at least count particles (lane padded)
+     */
+    static void ReservePool(Emitter &emitter, size_t count);
+
+    size_t Spawn(Emitter &emitter, size_t count);
+    void SimulateEmitter(Emitter &emitter, float deltaTime);
+    void ReleaseEmitter(uint32_t index);
+
+    float NextRandom(); // Uniform in [0, 1)
+
+    static std::unique_ptr<ShaderProgram> CreateBillboardShader();
+
+    // Emitter ids are indices; freed indices are reused
+    std::vector<Emitter> m_emitters;
+    std::vector<uint32_t> m_freeEmitters;
+    uint64_t m_randomState{0x2545F4914F6CDD1Dull};
+
+    // Update scratch: indices of particles that died this step
+    std::vector<uint32_t> m_deadScratch;
+
+    // Draw batch building
+    std::vector<ParticleInstance> m_instances;
+    std::vector<DrawBatch> m_batches;
+    std::vector<uint32_t> m_emitterOrder;
+    std::vector<float> m_emitterDepths;
+    std::vector<uint32_t> m_sortKeys, m_sortKeysScratch;
+    std::vector<uint32_t> m_sortIndices, m_sortIndicesScratch;
+
+    // Rendering
+    std::vector<std::shared_ptr<Texture2D>> m_textures;
+    std::unique_ptr<VertexArray> m_quadVAO;
+    std::shared_ptr<VertexBuffer> m_instanceBuffer;
+    std::unique_ptr<ShaderProgram> m_shader;
+    ParticleRenderStats m_renderStats;
+};
+
+} // namespace agl
+
+#endif // PARTICLE_SYSTEM_H
@@ -0,0 +1,152 @@
+#ifndef PRIMITIVE_CACHE_H
+#define PRIMITIVE_CACHE_H
+
+#include "mesh.h"
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+namespace agl {
+
+/**
+ * @brief Procedural generators of Mesh, one per Mesh::Create* function
+ */
+enum class PrimitiveType {
+    Triangle,
+    Quad,
+    Cube,
+    Sphere,
+    Plane,
+    Cylinder,
+    Capsule,
+    Bullet,
+    Projectile,
+    GroundPlane
+};
+
+/**
+ * @brief A generator and its parameters, the key of PrimitiveCache
+ *
+ * Build it with the factory matching the Mesh::Create* call it replaces; the
+ * parameters are stored in call order and unused ones are zero.
+ */
+struct PrimitiveDesc {
+    PrimitiveType type{PrimitiveType::Cube};
+    float params[4]{};
+
+    static PrimitiveDesc Triangle();
+    static PrimitiveDesc Quad();
+    static PrimitiveDesc Cube();
+    static PrimitiveDesc Sphere(float radius = 1.0f, int segments = 32, int rings = 16);
+    static PrimitiveDesc Plane(float width = 1.0f, float height = 1.0f, int widthSegments = 1, int heightSegments = 1);
+    static PrimitiveDesc Cylinder(float radius = 1.0f, float height = 2.0f, int segments = 32, int rings = 1);
+    static PrimitiveDesc Capsule(float radius = 1.0f, float height = 2.0f, int segments = 32, int rings = 4);
+    static PrimitiveDesc Bullet(float radius = 0.05f, float length = 0.2f);
+    static PrimitiveDesc Projectile(ProjectileType projectileType = ProjectileType::Default, float scale = 1.0f);
+    static PrimitiveDesc GroundPlane(float size = 20.0f, int segments = 10);
+
+    bool operator==(const PrimitiveDesc &other) const;
+    bool operator!=(const PrimitiveDesc &other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Hash of PrimitiveDesc for unordered containers
+ */
+struct PrimitiveDescHash {
+    size_t operator()(const PrimitiveDesc &desc) const;
+};
+
+/**
+ * @brief Lookup counters of PrimitiveCache
+ */
+struct PrimitiveCacheStats {
+    size_t hits{0};   // Requests served by existing geometry
+    size_t misses{0}; // Requests that generated and uploaded geometry
+};
+
+/**
+ * @brief Shared procedural primitives, generated and uploaded once per distinct parameters
+ *
+ * Systems that build the same primitive repeatedly (every ProjectileSystem,
+ * a scene full of identical cubes) get one set of vertex and index buffers.
+ * The cache holds its geometry weakly: it lives as long as some mesh draws it
+ * and is generated again on the next request after that. Like the meshes
+ * themselves, the cache must only be used on the thread owning the GL context.
+ */
+class PrimitiveCache {
+public:
+    static PrimitiveCache &Instance();
+
+    /**
+     * @brief Get the shared geometry of a primitive, generating it on first use
+     * @param desc Generator and parameters
+     * @return Uploaded mesh; treat it as immutable, it is shared by every user
+     */
+    std::shared_ptr<const Mesh> GetGeometry(const PrimitiveDesc &desc);
+
+    /**
+     * @brief Create a mesh drawing the shared geometry of a primitive (see Mesh::CreateShared)
+     *
+     * The mesh has its own material and vertex array, so it can be recolored
+     * and given instance buffers without affecting other users.
+     * @param desc Generator and parameters
+     * @param material Material of the new mesh
+     */
+    Mesh CreateMesh(const PrimitiveDesc &desc, const Material &material = Material());
+
+    /**
+     * @brief Choose what newly generated geometry keeps in system memory (default KeepAll)
+     *
+     * Geometry already in the cache keeps its policy.
+     */
+    void SetResidency(MeshResidency residency) {
+        m_residency = residency;
+    }
+
+    /**
+     * @brief Get the policy applied to newly generated geometry
+     */
+    MeshResidency GetResidency() const {
+        return m_residency;
+    }
+
+    /**
+     * @brief Get the number of primitives currently alive
+     */
+    size_t GetLiveCount() const;
+
+    /**
+     * @brief Get the lookup counters
+     */
+    const PrimitiveCacheStats &GetStats() const {
+        return m_stats;
+    }
+
+    /**
+     * @brief Forget entries whose geometry is no longer used
+     * @return Number of entries removed
+     */
+    size_t Trim();
+
+    /**
+     * @brief Generate a primitive without going through the cache
+     */
+    static Mesh Generate(const PrimitiveDesc &desc);
+
+private:
+    std::unordered_map<PrimitiveDesc, std::weak_ptr<const Mesh>, PrimitiveDescHash> m_entries;
+    MeshResidency m_residency{MeshResidency::KeepAll};
+    PrimitiveCacheStats m_stats;
+
+    PrimitiveCache() = default;
+    ~PrimitiveCache() = default;
+    PrimitiveCache(const PrimitiveCache &) = delete;
+    PrimitiveCache &operator=(const PrimitiveCache &) = delete;
+};
+
+} // namespace agl
+
+#endif // PRIMITIVE_CACHE_H
@@ -1,7 +1,11 @@
 #ifndef PROJECTILE_SYSTEM_H
 #define PROJECTILE_SYSTEM_H
 
+#include "CollisionBVH.h"
 #include "Shader.h"
+#include "SweptCollision.h"
+#include "ThreadPool.h"
+#include "TimingWheel.h"
 #include "mesh.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -10,6 +14,9 @@
 
 namespace agl {
 
+// Number of ProjectileType values (one mesh and one instanced draw per type)
+constexpr size_t ProjectileTypeCount = static_cast<size_t>(ProjectileType::Default) + 1;
+
 /**
  * @brief Individual projectile data
  */
@@ -36,6 +43,208 @@ struct Projectile {
     }
 };
 
+/**
+ * @brief How projectiles of a type move
+ *
+ * Simulated projectiles are integrated every Update. Analytic projectiles store only
+ * their spawn time, origin and launch velocity; Update does not integrate them and
+ * instead evaluates their position in closed form once at the end. With gravity g and
+ * linear drag k the acceleration is g - k * velocity. Hitscan projectiles never enter
+ * storage: firing one queues a ray of length speed * lifetime that the next Update
+ * resolves against the hitscan scene.
+ */
+struct ProjectileMotionModel {
+    bool analytic{false};      // Evaluate position in closed form instead of integrating
+    glm::vec3 gravity{0.0f};   // Constant acceleration (analytic only)
+    float drag{0.0f};          // Linear drag coefficient in 1/s (analytic only)
+    bool hitscan{false};       // Hit instantly along a ray (overrides analytic)
+};
+
+/**
+ * @brief Outcome of one hitscan shot, reported by the Update that resolved it
+ */
+struct HitscanEvent {
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f}; // Normalized
+    float distance{0.0f};                   // Distance to the hit, or the full range on a miss
+    ProjectileType type{ProjectileType::Laser};
+    uint32_t targetIndex{0};                                 // Index of the target in the scene's arrays
+    CollisionShapeType targetType{CollisionShapeType::None}; // None on a miss
+};
+
+/**
+ * @brief Shape of a FireBatch spread
+ */
+enum class SpreadShape {
+    Cone,  // Evenly covers the cone (golden-angle spiral), e.g. shotgun
+    Ring,  // Evenly spaced on the cone's rim, e.g. flak ring
+    Random // Uniformly random inside the cone
+};
+
+/**
+ * @brief Direction pattern of a FireBatch burst
+ */
+struct SpreadPattern {
+    SpreadShape shape{SpreadShape::Cone};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f}; // Center of the spread (will be normalized)
+    float angle{0.1f};                      // Half-angle of the cone in radians
+
+    SpreadPattern() = default;
+    SpreadPattern(SpreadShape s, const glm::vec3 &dir, float halfAngle) : shape(s), direction(dir), angle(halfAngle) {}
+};
+
+/**
+ * @brief Steering settings of a homing projectile
+ *
+ * A missile aims at entry targetIndex of the array last passed to
+ * ProjectileSystem::SetHomingTargets(). While that entry does not exist (or
+ * targetIndex is NoTarget) it keeps aiming at the last point it was given,
+ * which starts out as targetPosition.
+ */
+struct HomingParams {
+    static constexpr uint32_t NoTarget = 0xFFFFFFFFu;
+
+    float turnRate{2.0f};           // Maximum turn rate in radians per second
+    uint32_t targetIndex{NoTarget}; // Index into the homing target array
+    glm::vec3 targetPosition{0.0f}; // Initial (or fixed) aim point
+
+    HomingParams() = default;
+    HomingParams(float rate, uint32_t index) : turnRate(rate), targetIndex(index) {}
+    HomingParams(float rate, const glm::vec3 &position) : turnRate(rate), targetPosition(position) {}
+};
+
+/**
+ * @brief Stable reference to a fired projectile
+ *
+ * A handle names a pool slot plus the generation the slot had when the projectile
+ * was fired. Removing the projectile bumps the slot's generation, so stale handles
+ * are detected in O(1) instead of silently referring to a different projectile.
+ */
+struct ProjectileHandle {
+    static constexpr uint32_t InvalidSlot = 0xFFFFFFFFu;
+
+    uint32_t slot{InvalidSlot};
+    uint32_t generation{0};
+
+    /**
+     * @brief Check if the handle was returned by a successful fire (it may have expired since)
+     */
+    explicit operator bool() const {
+        return slot != InvalidSlot;
+    }
+
+    bool operator==(const ProjectileHandle &other) const {
+        return slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const ProjectileHandle &other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Structure-of-arrays storage for live projectiles
+ *
+ * Each attribute lives in its own contiguous array and all arrays share the same
+ * index. Storage is kept dense: removing a projectile moves another entry into the
+ * freed index, so an index is only valid until the next removal.
+ *
+ * ProjectileSystem keeps simulated projectiles first and analytic ones after them.
+ * For analytic entries velocities hold the launch velocity, and positions,
+ * directions and rotations are refreshed from origins and spawnTimes by SyncProjectiles().
+ * Remaining lifetime is maxLifetimes - (current time - spawnTimes). Times are
+ * doubles and only the difference is narrowed to float, so ages stay exact
+ * however long the system has run.
+ */
+struct ProjectileStorage {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> origins; // Spawn position
+    std::vector<double> spawnTimes; // System time at spawn
+    std::vector<glm::vec3> previousPositions; // Positions before the last Update, for swept collision
+    std::vector<glm::vec3> velocities;
+    std::vector<glm::vec3> directions;
+    std::vector<float> maxLifetimes;
+    std::vector<float> rotations;
+    std::vector<float> rotationSpeeds;
+    std::vector<float> scales;
+    std::vector<ProjectileType> types;
+    std::vector<uint32_t> slots; // Handle pool slot owning each entry
+
+    /**
+     * @brief Get number of stored projectiles
+     */
+    size_t Size() const {
+        return positions.size();
+    }
+
+    /**
+     * @brief Check if storage holds no projectiles
+     */
+    bool Empty() const {
+        return positions.empty();
+    }
+
+    /**
+     * @brief Resize every array (new entries are value-initialized)
+     * @param size New number of projectiles
+     */
+    void Resize(size_t size);
+
+    /**
+     * @brief Reserve capacity in every array
+     * @param capacity Number of projectiles to reserve space for
+     */
+    void Reserve(size_t capacity);
+
+    /**
+     * @brief Remove all projectiles
+     */
+    void Clear();
+
+    /**
+     * @brief Append a projectile to the end of every array
+     * @param projectile Projectile to append
+     * @param slot Handle pool slot that owns the projectile
+     * @param spawnTime System time at which the projectile was fired
+     */
+    void PushBack(const Projectile &projectile, uint32_t slot, double spawnTime);
+
+    /**
+     * @brief Remove a projectile by moving the last entry into its place
+     * @param index Index of projectile to remove
+     */
+    void SwapAndPop(size_t index);
+
+    /**
+     * @brief Copy the entry at from over the entry at to
+     */
+    void Move(size_t from, size_t to);
+
+    /**
+     * @brief Exchange two entries
+     */
+    void Swap(size_t a, size_t b);
+
+    /**
+     * @brief Remove the last entry
+     */
+    void PopBack();
+
+    /**
+     * @brief Gather the projectile at index into an AoS value
+     * @param index Index of projectile
+     * @return Copy of projectile data
+     */
+    Projectile Get(size_t index) const;
+};
+
+/**
+ * @brief Draw statistics of the last ProjectileSystem render call
+ */
+struct ProjectileRenderStats {
+    uint32_t instanceCount{0}; // Projectiles drawn
+    uint32_t drawCalls{0};     // Draw calls issued
+};
+
 /**
  * @brief Projectile system for managing bullets, missiles, etc. in games
  */
@@ -71,6 +280,40 @@ public:
      */
     void Render(ShaderProgram &shader, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
 
+    /**
+     * @brief Render all active projectiles with one instanced draw per ProjectileType
+     *
+     * Uses the built-in shader created by CreateInstancedShader().
+     * @param viewMatrix Camera view matrix
+     * @param projectionMatrix Camera projection matrix
+     */
+    void RenderInstanced(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+
+    /**
+     * @brief Render all active projectiles with one instanced draw per ProjectileType
+     *
+     * The shader must read per-instance data from attribute location 5
+     * (vec4: position.xyz, scale) and 6 (vec4: direction.xyz, rotation).
+     * @param shader Instancing shader to use for rendering
+     * @param viewMatrix Camera view matrix
+     * @param projectionMatrix Camera projection matrix
+     */
+    void RenderInstanced(ShaderProgram &shader, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+
+    /**
+     * @brief Get draw statistics of the last Render or RenderInstanced call
+     * @return Instance and draw call counts
+     */
+    const ProjectileRenderStats &GetRenderStats() const {
+        return m_renderStats;
+    }
+
+    /**
+     * @brief Create the Phong shader used by RenderInstanced
+     * @return Shader program reading per-instance projectile attributes
+     */
+    static std::unique_ptr<ShaderProgram> CreateInstancedShader();
+
     /**
      * @brief Fire a projectile
      * @param position Starting position
@@ -78,25 +321,273 @@ public:
      * @param type Type of projectile
      * @param speed Projectile speed
      * @param lifetime How long the projectile lives (seconds)
-     * @return True if projectile was fired, false if system is full
+     * @return Handle of the new projectile, or an invalid handle if the system is full or
+     *         the type is hitscan (the shot is queued instead; one with a zero direction is dropped)
+     */
+    ProjectileHandle FireProjectile(const glm::vec3 &position, const glm::vec3 &direction,
+                                    ProjectileType type = ProjectileType::Default, float speed = 10.0f,
+                                    float lifetime = 5.0f);
+
+    /**
+     * @brief Fire a burst of projectiles in a spread pattern
+     *
+     * Spawns as many of the requested projectiles as the pool has room for. Storage
+     * grows once for the whole burst and directions are generated by a SIMD kernel.
+     * Hitscan bursts queue one ray per direction and append no handles.
+     * @param origin Starting position of every projectile
+     * @param pattern Direction pattern
+     * @param count Number of projectiles requested
+     * @param type Type of projectile
+     * @param speed Projectile speed
+     * @param lifetime How long the projectiles live (seconds)
+     * @param handles Optional; receives the handles of the spawned projectiles (appended)
+     * @return Number of projectiles spawned or shots queued (less than count if the pool is nearly full,
+     *         0 if pattern.direction is zero)
+     */
+    size_t FireBatch(const glm::vec3 &origin, const SpreadPattern &pattern, size_t count,
+                     ProjectileType type = ProjectileType::Default, float speed = 10.0f, float lifetime = 5.0f,
+                     std::vector<ProjectileHandle> *handles = nullptr);
+
+    // ========== Handles ==========
+    // Handles stay valid across Update/Remove calls until their projectile is
+    // removed or expires; all lookups are O(1).
+
+    /**
+     * @brief Check if a handle still refers to a live projectile
+     */
+    bool IsAlive(ProjectileHandle handle) const;
+
+    /**
+     * @brief Get the current storage index of a projectile
+     * @param handle Projectile handle
+     * @return Index into GetProjectiles(), or InvalidIndex if the projectile is gone
+     */
+    size_t GetIndex(ProjectileHandle handle) const;
+
+    /**
+     * @brief Get the handle of the projectile at a storage index (e.g. a query result)
+     * @param index Index of projectile
+     * @return Handle of the projectile, or an invalid handle if index is out of range
+     */
+    ProjectileHandle GetHandle(size_t index) const;
+
+    static constexpr size_t InvalidIndex = static_cast<size_t>(-1);
+
+    /**
+     * @brief Evaluate analytic projectiles at the current time
+     *
+     * Update, Render and the collision queries call this already; it only does work when
+     * time advanced since the last evaluation.
+     */
+    void SyncProjectiles();
+
+    /**
+     * @brief Get storage of all active projectiles (for collision detection)
+     * @return Structure-of-arrays projectile storage, indexed 0..GetActiveCount()-1
+     */
+    const ProjectileStorage &GetProjectiles() const { return m_projectiles; }
+
+    /**
+     * @brief Get a copy of a single projectile
+     * @param index Index of projectile
+     * @return Projectile data
+     */
+    Projectile GetProjectile(size_t index) const;
+
+    // ========== Motion Models ==========
+
+    /**
+     * @brief Set how projectiles of a type move (applies to projectiles fired afterwards)
+     * @param type Projectile type
+     * @param model Motion model
+     */
+    void SetMotionModel(ProjectileType type, const ProjectileMotionModel &model) {
+        m_motionModels[static_cast<size_t>(type)] = model;
+    }
+    const ProjectileMotionModel &GetMotionModel(ProjectileType type) const {
+        return m_motionModels[static_cast<size_t>(type)];
+    }
+
+    /**
+     * @brief Get number of active projectiles integrated by Update
+     *
+     * Simulated projectiles occupy indices [0, GetSimulatedCount()); analytic
+     * projectiles follow them.
+     */
+    size_t GetSimulatedCount() const {
+        return m_simulatedCount;
+    }
+
+    /**
+     * @brief Get time accumulated by Update, used as the analytic projectile clock
+     *
+     * Kept in double precision; a float clock loses milliseconds after a few hours.
+     */
+    double GetTime() const {
+        return m_time;
+    }
+
+    // ========== Homing ==========
+    // Homing projectiles are steered together once per Update, before they move:
+    // their positions, velocities and aim points are gathered into compact arrays
+    // and turned by a SIMD kernel.
+
+    /**
+     * @brief Make a projectile home in on a target, or change its target
+     * @param handle Projectile handle
+     * @param params Steering settings
+     * @return False if the projectile is gone or analytic (analytic projectiles cannot steer)
+     */
+    bool SetHoming(ProjectileHandle handle, const HomingParams &params);
+
+    /**
+     * @brief Stop a projectile from homing; it keeps its current velocity
+     */
+    void ClearHoming(ProjectileHandle handle);
+
+    /**
+     * @brief Set the positions homing projectiles aim at, typically once per frame before Update
+     * @param positions Target positions, indexed by HomingParams::targetIndex
+     */
+    void SetHomingTargets(const std::vector<glm::vec3> &positions) {
+        m_homingTargets.assign(positions.begin(), positions.end());
+    }
+
+    /**
+     * @brief Get number of homing projectiles (removed ones are dropped on the next Update)
+     */
+    size_t GetHomingCount() const {
+        return m_homingHandles.size();
+    }
+
+    // ========== Hitscan ==========
+    // Hitscan shots fired during a frame are queued as rays and traced together by
+    // the next Update, in SIMD packets through the scene's bounding volume hierarchy.
+
+    /**
+     * @brief Get the targets hitscan rays are traced against (rebuild it when they move)
+     */
+    CollisionBVH &GetHitscanScene() {
+        return m_hitscanScene;
+    }
+
+    /**
+     * @brief Get number of hitscan shots waiting for the next Update
+     */
+    size_t GetPendingHitscanCount() const {
+        return m_hitscanOrigins.size();
+    }
+
+    /**
+     * @brief Get the hitscan shots resolved by the last Update, in firing order
      */
-    bool FireProjectile(const glm::vec3 &position, const glm::vec3 &direction,
-                        ProjectileType type = ProjectileType::Default, float speed = 10.0f, float lifetime = 5.0f);
+    const std::vector<HitscanEvent> &GetHitscanEvents() const {
+        return m_hitscanEvents;
+    }
+
+    // ========== Collision Queries ==========
+    // Queries run against a spatial hash grid that is rebuilt on the first query
+    // after projectiles were moved, fired or removed. Results are projectile
+    // indices, valid until the next Update/Fire/Remove call.
+
+    /**
+     * @brief Find projectiles overlapping a sphere (e.g. missile area of effect)
+     * @param center Sphere center
+     * @param radius Sphere radius
+     * @param results Receives projectile indices
+     */
+    void QuerySphere(const glm::vec3 &center, float radius, std::vector<uint32_t> &results);
+
+    /**
+     * @brief Find projectiles overlapping an axis-aligned box
+     * @param min Box minimum corner
+     * @param max Box maximum corner
+     * @param results Receives projectile indices
+     */
+    void QueryAABB(const glm::vec3 &min, const glm::vec3 &max, std::vector<uint32_t> &results);
+
+    /**
+     * @brief Find projectiles overlapping a ray segment
+     * @param origin Ray origin
+     * @param direction Ray direction
+     * @param maxDistance Segment length (infinity for an unbounded ray)
+     * @param results Receives projectile indices
+     */
+    void QueryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                  std::vector<uint32_t> &results);
+
+    /**
+     * @brief Collide all projectiles against a batch of target spheres
+     * @param targets Target spheres (e.g. enemy bounds)
+     * @param hits Receives (projectile index, target index) pairs
+     */
+    void CollideSpheres(const std::vector<CollisionSphere> &targets, std::vector<CollisionPair> &hits);
+
+    /**
+     * @brief Sweep every projectile's last step against targets (continuous collision)
+     *
+     * Tests the segment from each projectile's position before the last Update to
+     * its current position, inflated by the collision radius, so fast projectiles
+     * register hits on targets they passed through within a single step.
+     * @param spheres Sphere targets
+     * @param boxes Axis-aligned box targets
+     * @param capsules Capsule targets
+     * @param hits Receives the earliest impact per projectile that hit something;
+     *             segmentIndex is the projectile index and time is in [0, 1] along the step
+     */
+    void SweepTargets(const std::vector<CollisionSphere> &spheres, const std::vector<CollisionAABB> &boxes,
+                      const std::vector<CollisionCapsule> &capsules, std::vector<SweptHit> &hits);
 
     /**
-     * @brief Get all active projectiles (for collision detection)
-     * @return Vector of active projectiles
+     * @brief Get the spatial hash grid, rebuilt if out of date
      */
-    const std::vector<Projectile> &GetActiveProjectiles() const {
-        return m_projectiles;
+    const SpatialHashGrid &GetSpatialGrid();
+
+    /**
+     * @brief Set the collision radius shared by all projectiles
+     */
+    void SetCollisionRadius(float radius) {
+        m_grid.SetPointRadius(radius);
+    }
+    float GetCollisionRadius() const {
+        return m_grid.GetPointRadius();
+    }
+
+    /**
+     * @brief Set the spatial grid cell size (ideally around the typical query radius)
+     */
+    void SetGridCellSize(float cellSize) {
+        m_grid.SetCellSize(cellSize);
+        m_gridDirty = true;
     }
 
     /**
      * @brief Remove projectile at index
+     *
+     * The last projectile is moved into the freed index, so indices obtained
+     * before the call may refer to a different projectile afterwards.
      * @param index Index of projectile to remove
      */
     void RemoveProjectile(size_t index);
 
+    /**
+     * @brief Remove a projectile by handle
+     * @param handle Projectile handle
+     * @return True if the projectile was alive and has been removed
+     */
+    bool RemoveProjectile(ProjectileHandle handle);
+
+    /**
+     * @brief Remove a batch of projectiles by handle
+     *
+     * Handles may be in any order and may repeat or be stale; each live
+     * projectile is removed once. Convert query results with GetHandle() first,
+     * then remove them here without re-sorting indices.
+     * @param handles Projectile handles
+     * @return Number of projectiles removed
+     */
+    size_t RemoveProjectiles(const std::vector<ProjectileHandle> &handles);
+
     /**
      * @brief Clear all projectiles
      */
@@ -116,6 +607,41 @@ public:
         return m_maxProjectiles;
     }
 
+    /**
+     * @brief Set capacity without (re)creating GPU resources
+     *
+     * Clears all projectiles and resizes the handle pool. Useful for headless
+     * simulation; Initialize() must still be called before rendering.
+     * @param maxProjectiles Maximum number of projectiles to manage
+     */
+    void SetMaxProjectiles(size_t maxProjectiles);
+
+    /**
+     * @brief Set the active count from which Update runs in parallel chunks
+     * @param threshold Minimum projectile count for multithreaded updates
+     */
+    void SetParallelThreshold(size_t threshold) {
+        m_parallelThreshold = threshold;
+    }
+    size_t GetParallelThreshold() const {
+        return m_parallelThreshold;
+    }
+
+    /**
+     * @brief Set the number of projectiles per parallel work chunk
+     */
+    void SetParallelChunkSize(size_t chunkSize) {
+        m_parallelChunkSize = chunkSize > 0 ? chunkSize : 1;
+    }
+
+    /**
+     * @brief Set the worker pool used for parallel updates
+     * @param pool Pool to use, or nullptr for ThreadPool::Shared()
+     */
+    void SetThreadPool(ThreadPool *pool) {
+        m_threadPool = pool;
+    }
+
     /**
      * @brief Set default projectile properties
      */
@@ -130,9 +656,141 @@ public:
     }
 
 private:
-    std::vector<Projectile> m_projectiles;
+    ProjectileStorage m_projectiles;
+
+    // Handle pool: one slot per possible projectile, recycled through a free list
+    std::vector<uint32_t> m_slotGenerations;
+    std::vector<uint32_t> m_slotIndices; // Storage index of each live slot
+    std::vector<uint32_t> m_freeSlots;
+
+    /**
+     * @brief Clear all projectiles and size the handle pool for m_maxProjectiles
+     */
+    void ResetSlots();
+
+    /**
+     * @brief Remove the projectile at a valid index and release its slot
+     */
+    void RemoveAt(size_t index);
+
+    /**
+     * @brief Take a slot from the free list (the list must not be empty)
+     */
+    ProjectileHandle AllocateHandle();
+
+    /**
+     * @brief Schedule a new projectile's expiry on the timing wheel
+     */
+    void ScheduleExpiry(ProjectileHandle handle, float lifetime);
+
+    /**
+     * @brief Point the slot of the entry at index back to index after a move
+     */
+    void RelinkSlot(size_t index) {
+        m_slotIndices[m_projectiles.slots[index]] = static_cast<uint32_t>(index);
+    }
+
+    // Analytic motion
+    ProjectileMotionModel m_motionModels[ProjectileTypeCount];
+    size_t m_simulatedCount{0};
+    double m_time{0.0};
+    float m_lastDeltaTime{0.0f};
+    bool m_analyticDirty{false};
+
+    // Homing table, one entry per steered projectile
+    static constexpr uint32_t NoHomingEntry = 0xFFFFFFFFu;
+    std::vector<ProjectileHandle> m_homingHandles;
+    std::vector<uint32_t> m_homingTargetIndices;
+    std::vector<glm::vec3> m_homingAimPoints;
+    std::vector<float> m_homingTurnRates;
+    std::vector<uint32_t> m_slotHomingEntries; // Homing entry of each slot, or NoHomingEntry
+    std::vector<glm::vec3> m_homingTargets;
+    std::vector<uint32_t> m_steeringIndices; // Storage index of each homing entry this step
+    std::vector<float> m_steeringScratch;    // Structure-of-arrays kernel input
+
+    /**
+     * @brief Drop homing entries of removed projectiles and turn the rest toward their targets
+     */
+    void SteerHomingProjectiles(float deltaTime);
+
+    /**
+     * @brief Swap-and-pop a homing table entry
+     */
+    void RemoveHomingEntry(size_t entry);
+
+    // FireBatch scratch (structure-of-arrays directions)
+    std::vector<float> m_spreadTurns;
+    std::vector<float> m_spreadHeights;
+    std::vector<float> m_spreadX, m_spreadY, m_spreadZ;
+    uint64_t m_spreadRandomState{0x9E3779B97F4A7C15ull};
+
+    /**
+     * @brief Fill the spread scratch arrays with count directions of a pattern
+     * @return False, filling nothing, if the pattern direction is (nearly) zero
+     */
+    bool BuildSpreadDirections(const SpreadPattern &pattern, size_t count);
+
+    // Lifetime expiry, keyed by packed handle; entries of removed projectiles are skipped
+    TimingWheel m_expiryWheel;
+    std::vector<uint64_t> m_expiredScratch;
+
+    /**
+     * @brief Expiry wheel tick reached by the current time
+     *
+     * Derived from the double clock, so one tick is still 1/120 s after days of
+     * uptime; a float clock would skip or repeat ticks.
+     */
+    uint64_t CurrentExpiryTick() const;
+
+    /**
+     * @brief Closed-form position and velocity of a ballistic projectile
+     */
+    static void EvaluateBallistic(const ProjectileMotionModel &model, const glm::vec3 &origin,
+                                  const glm::vec3 &launchVelocity, float age, glm::vec3 &position,
+                                  glm::vec3 &velocity);
+
+    // Multithreaded update
+    ThreadPool *m_threadPool{nullptr};
+    size_t m_parallelThreshold{32768};
+    size_t m_parallelChunkSize{8192};
+
+    // Collision queries
+    SpatialHashGrid m_grid;
+    bool m_gridDirty{true};
+    SweptCollisionBatch m_sweptBatch;
+
+    // Hitscan queue (one entry per shot) and results
+    CollisionBVH m_hitscanScene;
+    std::vector<glm::vec3> m_hitscanOrigins;
+    std::vector<glm::vec3> m_hitscanDirections;
+    std::vector<float> m_hitscanRanges;
+    std::vector<ProjectileType> m_hitscanTypes;
+    std::vector<RayHit> m_hitscanHits;
+    std::vector<HitscanEvent> m_hitscanEvents;
+
+    /**
+     * @brief Queue a hitscan shot for the next Update
+     * @return False if the direction is (nearly) zero; the shot is dropped
+     */
+    bool QueueHitscan(const glm::vec3 &origin, const glm::vec3 &direction, float range, ProjectileType type);
+
+    /**
+     * @brief Trace every queued shot and replace the hitscan events
+     */
+    void ResolveHitscans();
+
+    /**
+     * @brief Rebuild the spatial grid if projectiles changed since the last build
+     */
+    void UpdateSpatialGrid();
     std::vector<std::unique_ptr<Mesh>> m_projectileMeshes;
 
+    // Instanced rendering: one streamed instance buffer per projectile type
+    std::vector<std::shared_ptr<VertexBuffer>> m_instanceBuffers;
+    std::vector<glm::vec4> m_instanceData;
+    std::unique_ptr<ShaderProgram> m_instancedShader;
+    ProjectileRenderStats m_renderStats;
+
     size_t m_maxProjectiles{1000};
     size_t m_nextIndex{0};
 
@@ -177,6 +835,18 @@ public:
      */
     bool Fire(const glm::vec3 &position, const glm::vec3 &direction, ProjectileType type = ProjectileType::Default);
 
+    /**
+     * @brief Fire a burst (shotgun, flak) from this shooter; the whole burst uses one cooldown
+     * @param position Shooter position
+     * @param pattern Direction pattern
+     * @param count Number of projectiles in the burst
+     * @param type Type of projectile to fire
+     * @param handles Optional; receives the handles of the spawned projectiles (appended)
+     * @return Number of projectiles spawned
+     */
+    size_t FireBatch(const glm::vec3 &position, const SpreadPattern &pattern, size_t count,
+                     ProjectileType type = ProjectileType::Default, std::vector<ProjectileHandle> *handles = nullptr);
+
     /**
      * @brief Update shooter (handles cooldown, etc.)
      * @param deltaTime Time elapsed since last update
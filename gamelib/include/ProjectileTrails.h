@@ -0,0 +1,188 @@
+#ifndef PROJECTILE_TRAILS_H
+#define PROJECTILE_TRAILS_H
+
+#include "ProjectileSystem.h"
+#include "Shader.h"
+#include "VertexArray.h"
+#include "buffer.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief Look of one trail
+ *
+ * Width and color blend from the head to the tail value by the age of each
+ * history point, so older parts of a trail thin out and fade.
+ */
+struct TrailStyle {
+    float headWidth{0.1f};
+    float tailWidth{0.0f};
+    glm::vec4 headColor{1.0f};
+    glm::vec4 tailColor{1.0f, 1.0f, 1.0f, 0.0f};
+    float lifetime{0.5f};         // Seconds a history point stays in the trail
+    float minSegmentLength{0.1f}; // Distance the projectile travels before a new point is recorded
+};
+
+/**
+ * @brief Rendering statistics from the last ProjectileTrails::Render call
+ */
+struct TrailRenderStats {
+    uint32_t trailCount{0};  // Trails drawn
+    uint32_t vertexCount{0}; // Ribbon vertices written
+    uint32_t drawCalls{0};   // Draw calls issued
+};
+
+/**
+ * @brief Ribbon vertex written by ProjectileTrails::GenerateRibbons
+ */
+struct TrailVertex {
+    glm::vec3 position;
+    uint32_t color; // RGBA8
+};
+
+/**
+ * @brief Tracer and smoke trails that follow ProjectileSystem projectiles
+ *
+ * Every trail owns a fixed ring of history points, so recording never allocates.
+ * A trail follows its projectile handle until the projectile is removed, then
+ * stays behind and fades out as its points expire. Rendering expands all trails
+ * into camera-facing ribbons in one pass, written straight into a streaming
+ * vertex buffer, and draws them as one triangle strip (trails are joined by
+ * degenerate triangles).
+ */
+class ProjectileTrails {
+public:
+    static constexpr uint32_t InvalidTrail = 0xFFFFFFFFu;
+
+    /**
+     * @brief Create the trail pool
+     * @param projectileSystem System whose handles trails attach to
+     * @param maxTrails Maximum number of trails (attached or fading)
+     * @param pointsPerTrail History points kept per trail
+     */
+    explicit ProjectileTrails(ProjectileSystem *projectileSystem, size_t maxTrails = 1024,
+                              size_t pointsPerTrail = 32);
+    ~ProjectileTrails() = default;
+
+    /**
+     * @brief Create the GPU resources (requires an OpenGL context)
+     */
+    void Initialize();
+
+    /**
+     * @brief Start a trail behind a projectile
+     * @param handle Projectile to follow
+     * @param style Trail look
+     * @return Trail id, or InvalidTrail if the projectile is dead or the pool is full
+     */
+    uint32_t Attach(ProjectileHandle handle, const TrailStyle &style);
+
+    /**
+     * @brief Stop following the projectile; the trail fades out and is then released
+     */
+    void Detach(uint32_t trail);
+
+    /**
+     * @brief Remove every trail immediately
+     */
+    void Clear();
+
+    /**
+     * @brief Record projectile positions and expire old history points
+     * @param deltaTime Time step in seconds (call after ProjectileSystem::Update)
+     */
+    void Update(float deltaTime);
+
+    /**
+     * @brief Expand every trail into ribbon vertices
+     *
+     * Called by Render; exposed so the CPU side can run (or be measured) without
+     * a GL context.
+     * @param cameraPosition Ribbons are turned to face this point
+     * @param vertices Destination, at least GetMaxVertexCount() entries
+     * @return Number of triangle strip vertices written
+     */
+    size_t GenerateRibbons(const glm::vec3 &cameraPosition, TrailVertex *vertices);
+
+    /**
+     * @brief Draw every trail in a single call
+     * @param viewMatrix Camera view matrix
+     * @param projectionMatrix Camera projection matrix
+     */
+    void Render(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+
+    /**
+     * @brief Get statistics from the last Render call
+     */
+    const TrailRenderStats &GetRenderStats() const {
+        return m_renderStats;
+    }
+
+    /**
+     * @brief Get number of live trails (attached or fading)
+     */
+    size_t GetTrailCount() const {
+        return m_trails.size() - m_freeTrails.size();
+    }
+
+    size_t GetMaxTrails() const {
+        return m_trails.size();
+    }
+    size_t GetPointsPerTrail() const {
+        return m_pointsPerTrail;
+    }
+
+    /**
+     * @brief Get the vertex count of the longest possible ribbon strip
+     */
+    size_t GetMaxVertexCount() const {
+        // Two vertices per point, including the live head, plus two to join each trail to the next
+        return m_trails.size() * (2 * (m_pointsPerTrail + 1) + 2);
+    }
+
+private:
+    struct Trail {
+        ProjectileHandle handle;
+        TrailStyle style;
+        glm::vec3 head{0.0f}; // Current projectile position, drawn ahead of the recorded points
+        uint32_t newest{0};   // Ring index of the newest recorded point
+        uint32_t count{0};    // Recorded points
+        bool alive{false};
+        bool attached{false};
+    };
+
+    void RecordPoint(uint32_t trailIndex, const glm::vec3 &position);
+    void ReleaseTrail(uint32_t trailIndex);
+
+    static std::unique_ptr<ShaderProgram> CreateRibbonShader();
+
+    ProjectileSystem *m_projectileSystem;
+    size_t m_pointsPerTrail;
+    float m_time{0.0f};
+
+    // Trail ids are indices; freed indices are reused
+    std::vector<Trail> m_trails;
+    std::vector<uint32_t> m_freeTrails;
+
+    // History rings, m_pointsPerTrail entries per trail
+    std::vector<glm::vec3> m_points;
+    std::vector<float> m_pointTimes;
+
+    // Ribbon expansion scratch for one trail, newest point first
+    std::vector<glm::vec3> m_ribbonPoints;
+    std::vector<float> m_ribbonAges;
+
+    // Rendering
+    std::unique_ptr<VertexArray> m_vertexArray;
+    std::shared_ptr<StreamingVertexBuffer> m_vertexBuffer;
+    std::unique_ptr<ShaderProgram> m_shader;
+    TrailRenderStats m_renderStats;
+};
+
+} // namespace agl
+
+#endif // PROJECTILE_TRAILS_H
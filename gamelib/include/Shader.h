@@ -97,6 +97,9 @@ public:
         return m_errorLog;
     }
 
+    // Check whether the program declares an active uniform, without the missing-uniform warning
+    bool HasUniform(const std::string &name) const;
+
     // Uniform setting methods
     void SetUniform(const std::string &name, bool value);
     void SetUniform(const std::string &name, int value);
@@ -137,6 +140,15 @@ public:
     static std::unique_ptr<ShaderProgram> CreateBasicTextureShader();
     static std::unique_ptr<ShaderProgram> CreatePhongShader();
 
+    /**
+     * @brief Lit shader for agl::Mesh in any vertex format
+     *
+     * Uses the uniform names Mesh::Render() and ApplyMaterial() set (model,
+     * normalMatrix, material.*), plus view, projection, lightPos, lightColor
+     * and viewPos, and decodes compact vertices with GetCompactVertexDecodeGLSL().
+     */
+    static std::unique_ptr<ShaderProgram> CreateMeshShader();
+
 private:
     uint32_t m_programID;
     bool m_linked;
@@ -0,0 +1,78 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// x86 builds compile SSE2/AVX2 code paths into the same binary and pick one at runtime
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AGL_SIMD_X86 1
+#endif
+
+// Per-function target attributes let the AVX2 path live next to the baseline path
+// without compiling the whole library with -mavx2. MSVC needs no attribute.
+#if defined(AGL_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define AGL_TARGET_SSE2 __attribute__((target("sse2")))
+#define AGL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AGL_TARGET_SSE2
+#define AGL_TARGET_AVX2
+#endif
+
+namespace agl {
+namespace simd {
+
+/**
+ * @brief Instruction sets the engine has dedicated kernels for, ordered by width
+ */
+enum class InstructionSet {
+    Scalar = 0, // Portable C++ loops
+    SSE2 = 1,   // 4 float lanes
+    AVX2 = 2    // 8 float lanes
+};
+
+/**
+ * @brief Query the widest instruction set supported by the CPU and OS
+ * @return Detected instruction set (cached after the first call)
+ */
+InstructionSet DetectInstructionSet();
+
+/**
+ * @brief Get the instruction set kernels should use
+ * @return Detected instruction set, capped by SetInstructionSetLimit()
+ */
+InstructionSet GetInstructionSet();
+
+/**
+ * @brief Cap the instruction set used by kernels (for benchmarks and debugging)
+ * @param limit Widest instruction set kernels may use
+ */
+void SetInstructionSetLimit(InstructionSet limit);
+
+/**
+ * @brief Get a printable name for an instruction set
+ * @param set Instruction set
+ * @return Name such as "AVX2"
+ */
+const char *GetInstructionSetName(InstructionSet set);
+
+/**
+ * @brief Index of the lowest set bit of a non-zero mask
+ */
+inline uint32_t CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+} // namespace simd
+} // namespace agl
+
+#endif // SIMD_H
@@ -0,0 +1,152 @@
+#ifndef SPATIAL_HASH_GRID_H
+#define SPATIAL_HASH_GRID_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief Sphere used as a collision target
+ */
+struct CollisionSphere {
+    glm::vec3 center{0.0f};
+    float radius{1.0f};
+
+    CollisionSphere() = default;
+    CollisionSphere(const glm::vec3 &c, float r) : center(c), radius(r) {}
+};
+
+/**
+ * @brief A point/target overlap reported by SpatialHashGrid::CollideSpheres
+ */
+struct CollisionPair {
+    uint32_t pointIndex;  // Index of the point (e.g. projectile) in the array passed to Build
+    uint32_t targetIndex; // Index of the target sphere
+};
+
+/**
+ * @brief Uniform spatial hash grid over a set of points
+ *
+ * Points are hashed into cells of a fixed size and bucketed with a counting sort,
+ * so a rebuild is O(n) with no per-cell allocation. Every point has the same
+ * collision radius, which queries add to the query shape. Queries return indices
+ * into the position array passed to Build(), in a deterministic order.
+ */
+class SpatialHashGrid {
+public:
+    /**
+     * @brief Constructor
+     * @param cellSize Edge length of a grid cell (ideally around the typical query size)
+     */
+    explicit SpatialHashGrid(float cellSize = 2.0f);
+
+    /**
+     * @brief Set the cell edge length (takes effect on the next Build)
+     */
+    void SetCellSize(float cellSize);
+    float GetCellSize() const {
+        return m_cellSize;
+    }
+
+    /**
+     * @brief Set the radius shared by every point
+     */
+    void SetPointRadius(float radius) {
+        m_pointRadius = radius;
+    }
+    float GetPointRadius() const {
+        return m_pointRadius;
+    }
+
+    /**
+     * @brief Rebuild the grid from scratch
+     * @param positions Point positions
+     * @param count Number of points
+     */
+    void Build(const glm::vec3 *positions, size_t count);
+
+    /**
+     * @brief Remove all points
+     */
+    void Clear();
+
+    /**
+     * @brief Get number of points in the grid
+     */
+    size_t GetPointCount() const {
+        return m_points.size();
+    }
+
+    /**
+     * @brief Find points overlapping a sphere
+     * @param center Sphere center
+     * @param radius Sphere radius
+     * @param results Receives point indices (cleared first)
+     */
+    void QuerySphere(const glm::vec3 &center, float radius, std::vector<uint32_t> &results) const;
+
+    /**
+     * @brief Find points overlapping an axis-aligned box
+     * @param min Box minimum corner
+     * @param max Box maximum corner
+     * @param results Receives point indices (cleared first)
+     */
+    void QueryAABB(const glm::vec3 &min, const glm::vec3 &max, std::vector<uint32_t> &results) const;
+
+    /**
+     * @brief Find points overlapping a ray segment
+     * @param origin Ray origin
+     * @param direction Ray direction (need not be normalized)
+     * @param maxDistance Length of the segment along the normalized direction
+     * @param results Receives point indices (cleared first)
+     *
+     * Reuses an internal cell buffer, so concurrent QueryRay calls on one grid are not safe.
+     */
+    void QueryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                  std::vector<uint32_t> &results) const;
+
+    /**
+     * @brief Test every point against a batch of target spheres
+     * @param targets Target spheres
+     * @param targetCount Number of targets
+     * @param hits Receives one pair per overlapping point/target (cleared first)
+     */
+    void CollideSpheres(const CollisionSphere *targets, size_t targetCount, std::vector<CollisionPair> &hits) const;
+
+private:
+    struct GridPoint {
+        glm::vec3 position;
+        uint32_t index; // Index in the array passed to Build
+    };
+
+    glm::ivec3 CellOf(const glm::vec3 &position) const;
+    uint32_t HashCell(const glm::ivec3 &cell) const;
+
+    // Visit every point whose cell lies in [minCell, maxCell]. Falls back to visiting
+    // all points when the range covers more cells than there are points.
+    template <typename Visitor>
+    void VisitCells(glm::ivec3 minCell, glm::ivec3 maxCell, Visitor &&visit) const;
+
+    template <typename Visitor>
+    void VisitSphere(const glm::vec3 &center, float radius, Visitor &&visit) const;
+
+    float m_cellSize;
+    float m_inverseCellSize;
+    float m_pointRadius{0.0f};
+
+    glm::vec3 m_boundsMin{0.0f};
+    glm::vec3 m_boundsMax{0.0f};
+
+    uint32_t m_bucketMask{0};
+    std::vector<uint32_t> m_bucketStarts; // bucketCount + 1 prefix offsets into m_points
+    std::vector<uint32_t> m_pointBuckets; // Scratch: bucket of each input point
+    std::vector<GridPoint> m_points;      // Points sorted by bucket
+
+    mutable std::vector<glm::ivec3> m_rayCells; // Scratch: cells crossed by QueryRay, reused between calls
+};
+
+} // namespace agl
+
+#endif // SPATIAL_HASH_GRID_H
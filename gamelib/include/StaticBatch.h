@@ -0,0 +1,277 @@
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include "Frustum.h"
+#include "mesh.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief One object added to a StaticBatch
+ */
+struct StaticBatchSource {
+    std::shared_ptr<const Mesh> mesh; // Needs its CPU vertices (MeshResidency::KeepAll)
+    glm::mat4 transform{1.0f};
+    Material material;
+};
+
+/**
+ * @brief Where one object ended up in the merged buffers, with its world space bounds
+ */
+struct StaticBatchRange {
+    uint32_t firstIndex{0};
+    uint32_t indexCount{0};
+    uint32_t group{0}; // Material group
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
+    BoundingSphere bounds;
+};
+
+/**
+ * @brief Pre-transformed geometry of a batch, produced by StaticBatch::Merge on any thread
+ *
+ * Objects are laid out group by group, in the order they were added within a
+ * group, so each material group is one contiguous run of the index buffer.
+ */
+struct StaticBatchGeometry {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<StaticBatchRange> ranges; // Indexed by object
+    std::vector<Material> materials;      // Indexed by group
+    std::vector<uint32_t> drawOrder;      // Objects in buffer order
+    std::vector<uint32_t> groupOffsets;   // Objects of group g are drawOrder[groupOffsets[g] .. groupOffsets[g + 1])
+};
+
+/**
+ * @brief Counters of the last StaticBatch::Render
+ */
+struct StaticBatchStats {
+    uint32_t visibleObjects{0};
+    uint32_t drawCalls{0}; // One multi-draw per material group with visible objects
+    uint32_t ranges{0};    // Index ranges submitted, after merging neighbours
+};
+
+/**
+ * @brief Many static meshes merged into one vertex and index buffer
+ *
+ * Scene dressing made of hundreds of small meshes costs a vertex array, three
+ * buffers and a draw call each. A batch transforms the vertices into world
+ * space once, merges objects that share a material into contiguous index
+ * ranges, and draws every visible range of a material with a single
+ * glMultiDrawElements; a batch with one material is one call. Objects keep
+ * their own range and bounds, so they can still be hidden or frustum culled
+ * one by one.
+ *
+ * Building copies nothing to the GPU until the merge is complete, and the
+ * merged CPU copy is dropped after upload. BuildAsync() merges on the shared
+ * thread pool and uploads on the main dispatch queue; the source meshes must
+ * not change until it completes.
+ */
+class StaticBatch {
+public:
+    using BuildCallback = std::function<void(bool built)>;
+
+    StaticBatch();
+    ~StaticBatch();
+
+    // Owns GL objects and is referenced by pending builds, so it stays in place
+    StaticBatch(const StaticBatch &) = delete;
+    StaticBatch &operator=(const StaticBatch &) = delete;
+
+    // ========== Objects ==========
+
+    /**
+     * @brief Add a mesh instance with the mesh's material
+     * @param mesh Mesh with CPU vertices, shared with other users (see PrimitiveCache::GetGeometry)
+     * @param transform Model matrix baked into the vertices
+     * @return Object index, stable until Clear()
+     */
+    size_t Add(std::shared_ptr<const Mesh> mesh, const glm::mat4 &transform);
+
+    /**
+     * @brief Add a mesh instance with its own material
+     */
+    size_t Add(std::shared_ptr<const Mesh> mesh, const glm::mat4 &transform, const Material &material);
+
+    /**
+     * @brief Move an object; takes effect at the next build
+     */
+    void SetTransform(size_t object, const glm::mat4 &transform);
+
+    /**
+     * @brief Remove every object (the built buffers stay until the next build)
+     */
+    void Clear();
+
+    /**
+     * @brief Get the number of added objects
+     */
+    size_t GetObjectCount() const {
+        return m_sources.size();
+    }
+
+    /**
+     * @brief Show or hide an object without rebuilding
+     */
+    void SetEnabled(size_t object, bool enabled);
+
+    /**
+     * @brief Check whether an object is drawn when visible
+     */
+    bool IsEnabled(size_t object) const {
+        return object < m_enabled.size() && m_enabled[object] != 0;
+    }
+
+    // ========== Building ==========
+
+    /**
+     * @brief Merge and upload on the calling thread, which must own the GL context
+     * @return True if the batch was rebuilt
+     */
+    bool Build();
+
+    /**
+     * @brief Merge on a worker thread and upload from the main dispatch queue
+     *
+     * The batch keeps drawing its previous buffers until the new ones are in.
+     * A newer Build() or BuildAsync() supersedes a pending one, whose result is
+     * then dropped. If the batch is destroyed first, the callback is not called.
+     * @param onBuilt Called on the main thread; false if the merge failed or was superseded
+     */
+    void BuildAsync(BuildCallback onBuilt = nullptr);
+
+    /**
+     * @brief Check whether an asynchronous build is pending
+     */
+    bool IsBuilding() const {
+        return m_pendingBuilds > 0;
+    }
+
+    /**
+     * @brief Pre-transform and merge objects into batch geometry (thread-safe, no GL calls)
+     *
+     * Materials are grouped by value: colors, shininess and texture pointers.
+     * Mirroring transforms flip the winding so front faces stay front faces.
+     * Objects whose mesh has no CPU vertices are left empty with an error.
+     * @param sources Objects to merge
+     * @param geometry Receives the merged geometry
+     * @return False if the merged vertices do not fit 32-bit indices
+     */
+    static bool Merge(const std::vector<StaticBatchSource> &sources, StaticBatchGeometry &geometry);
+
+    // ========== Rendering ==========
+
+    /**
+     * @brief Draw every enabled object
+     *
+     * Vertices are in world space, so the shader's model matrix is set to identity.
+     * @param shader Shader taking the same attributes and material uniforms as Mesh
+     */
+    void Render(ShaderProgram &shader);
+
+    /**
+     * @brief Draw the enabled objects whose bounds intersect a frustum
+     * @param shader Shader taking the same attributes and material uniforms as Mesh
+     * @param frustum World space frustum (see Camera::GetFrustum)
+     */
+    void Render(ShaderProgram &shader, const Frustum &frustum);
+
+    // ========== Getters ==========
+
+    /**
+     * @brief Get the number of objects in the built buffers
+     */
+    size_t GetBuiltObjectCount() const {
+        return m_ranges.size();
+    }
+
+    /**
+     * @brief Get the draw range and bounds of a built object
+     */
+    const StaticBatchRange &GetRange(size_t object) const {
+        return m_ranges[object];
+    }
+
+    /**
+     * @brief Get the number of material groups in the built buffers
+     */
+    size_t GetGroupCount() const {
+        return m_materials.size();
+    }
+
+    /**
+     * @brief Get the material of a group
+     */
+    const Material &GetGroupMaterial(size_t group) const {
+        return m_materials[group];
+    }
+
+    /**
+     * @brief Get the number of vertices in the built buffers
+     */
+    size_t GetVertexCount() const {
+        return m_vertexCount;
+    }
+
+    /**
+     * @brief Get the number of indices in the built buffers
+     */
+    size_t GetIndexCount() const {
+        return m_indexCount;
+    }
+
+    /**
+     * @brief Get the counters of the last Render
+     */
+    const StaticBatchStats &GetStats() const {
+        return m_stats;
+    }
+
+private:
+    /**
+     * @brief Replace the GPU buffers and draw ranges with merged geometry
+     */
+    void Upload(StaticBatchGeometry &geometry);
+
+    /**
+     * @brief Draw the enabled objects, culled against frustum if it is not null
+     */
+    void Draw(ShaderProgram &shader, const Frustum *frustum);
+
+    // Objects for the next build
+    std::vector<StaticBatchSource> m_sources;
+    std::vector<uint8_t> m_enabled;
+
+    // Layout of the built buffers
+    std::vector<StaticBatchRange> m_ranges;
+    std::vector<Material> m_materials;
+    std::vector<uint32_t> m_drawOrder;
+    std::vector<uint32_t> m_groupOffsets;
+    size_t m_vertexCount{0};
+    size_t m_indexCount{0};
+
+    // Per-draw scratch for glMultiDrawElements
+    std::vector<GLsizei> m_drawCounts;
+    std::vector<const void *> m_drawOffsets;
+    StaticBatchStats m_stats;
+
+    // OpenGL objects
+    std::unique_ptr<VertexArray> m_VAO;
+    std::shared_ptr<VertexBuffer> m_VBO;
+    std::shared_ptr<IndexBuffer> m_EBO;
+    size_t m_trackedGPUBytes{0};
+
+    // Builds finishing on the main queue check the token to see if the batch still exists
+    uint64_t m_buildGeneration{0};
+    uint32_t m_pendingBuilds{0};
+    std::shared_ptr<StaticBatch *> m_lifetime;
+};
+
+} // namespace agl
+
+#endif // STATIC_BATCH_H
@@ -0,0 +1,134 @@
+#ifndef SWEPT_COLLISION_H
+#define SWEPT_COLLISION_H
+
+#include "SpatialHashGrid.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief Axis-aligned box used as a collision target
+ */
+struct CollisionAABB {
+    glm::vec3 min{-0.5f};
+    glm::vec3 max{0.5f};
+
+    CollisionAABB() = default;
+    CollisionAABB(const glm::vec3 &minCorner, const glm::vec3 &maxCorner) : min(minCorner), max(maxCorner) {}
+};
+
+/**
+ * @brief Capsule (segment with radius) used as a collision target
+ */
+struct CollisionCapsule {
+    glm::vec3 start{0.0f};
+    glm::vec3 end{0.0f, 1.0f, 0.0f};
+    float radius{0.5f};
+
+    CollisionCapsule() = default;
+    CollisionCapsule(const glm::vec3 &a, const glm::vec3 &b, float r) : start(a), end(b), radius(r) {}
+};
+
+/**
+ * @brief Kind of target a swept segment hit
+ */
+enum class CollisionShapeType : uint8_t { None, Sphere, AABB, Capsule };
+
+/**
+ * @brief Earliest impact of one swept segment
+ */
+struct SweptHit {
+    uint32_t segmentIndex;         // Index of the segment (e.g. projectile)
+    uint32_t targetIndex;          // Index of the target in the array it was swept against
+    CollisionShapeType targetType; // Which target array targetIndex refers to
+    float time;                    // Time of impact in [0, 1] along the segment
+};
+
+/**
+ * @brief Batched continuous collision for moving points
+ *
+ * Each segment runs from a start to an end position (e.g. a projectile's previous
+ * and current position) and carries a shared radius. Sweeping the batch against
+ * targets keeps the earliest time of impact per segment, so fast projectiles
+ * cannot tunnel through thin targets between two updates. Segments are stored as
+ * structure-of-arrays and tested several at a time with the widest SIMD path
+ * reported by simd::GetInstructionSet().
+ *
+ * Boxes are expanded by the segment radius on every axis, which slightly
+ * overestimates the rounded corners of the exact swept volume.
+ */
+class SweptCollisionBatch {
+public:
+    /**
+     * @brief Load segments and reset their impacts
+     * @param starts Segment start positions (time 0)
+     * @param ends Segment end positions (time 1)
+     * @param count Number of segments
+     * @param radius Radius shared by every segment
+     */
+    void SetSegments(const glm::vec3 *starts, const glm::vec3 *ends, size_t count, float radius = 0.0f);
+
+    /**
+     * @brief Forget impacts found so far, keeping the segments
+     */
+    void ResetHits();
+
+    /**
+     * @brief Sweep every segment against a batch of spheres
+     */
+    void SweepSpheres(const CollisionSphere *targets, size_t targetCount);
+
+    /**
+     * @brief Sweep every segment against a batch of axis-aligned boxes
+     */
+    void SweepAABBs(const CollisionAABB *targets, size_t targetCount);
+
+    /**
+     * @brief Sweep every segment against a batch of capsules
+     */
+    void SweepCapsules(const CollisionCapsule *targets, size_t targetCount);
+
+    /**
+     * @brief Get number of loaded segments
+     */
+    size_t GetSegmentCount() const {
+        return m_segmentCount;
+    }
+
+    /**
+     * @brief Get the earliest time of impact of a segment
+     * @param segment Segment index
+     * @return Time in [0, 1], or a value above 1 if the segment hit nothing
+     */
+    float GetTimeOfImpact(size_t segment) const {
+        return m_times[segment];
+    }
+
+    /**
+     * @brief Collect the earliest impact of every segment that hit something
+     * @param hits Receives hits in ascending segment order (cleared first)
+     */
+    void GetHits(std::vector<SweptHit> &hits) const;
+
+private:
+    friend struct SweptSegmentArrays;
+
+    size_t m_segmentCount{0};
+    size_t m_paddedCount{0}; // Segment count rounded up to the widest lane count
+    float m_radius{0.0f};
+
+    std::vector<float> m_startX, m_startY, m_startZ;
+    std::vector<float> m_deltaX, m_deltaY, m_deltaZ;
+    std::vector<float> m_inverseDeltaX, m_inverseDeltaY, m_inverseDeltaZ;
+    std::vector<float> m_lengthSquared;
+
+    std::vector<float> m_times;
+    std::vector<uint32_t> m_targets;
+    std::vector<CollisionShapeType> m_types;
+};
+
+} // namespace agl
+
+#endif // SWEPT_COLLISION_H
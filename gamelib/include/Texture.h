@@ -56,6 +56,14 @@ enum class TextureDataType {
     UnsignedInt248 = GL_UNSIGNED_INT_24_8
 };
 
+// 8-bit pixels decoded from an image file; holds no GL state, so it can be filled on any thread
+struct TextureImage {
+    uint32_t width{0};
+    uint32_t height{0};
+    TextureFormat format{TextureFormat::RGBA};
+    std::vector<uint8_t> pixels;
+};
+
 // Base Texture class
 class Texture {
 public:
@@ -121,6 +129,12 @@ public:
     // Create texture from file
     bool LoadFromFile(const std::string &filepath, bool flipVertically = true);
 
+    // Create texture from pixels decoded with DecodeFile
+    void CreateFromImage(const TextureImage &image);
+
+    // Decode an image file without touching GL, so it is safe on worker threads
+    static bool DecodeFile(const std::string &filepath, TextureImage &image, bool flipVertically = true);
+
     // Update texture data
     void SetData(const void *data, uint32_t x = 0, uint32_t y = 0, uint32_t width = 0, uint32_t height = 0);
 
@@ -174,6 +188,9 @@ public:
     // Load and cache texture
     std::shared_ptr<Texture2D> LoadTexture(const std::string &name, const std::string &filepath);
 
+    // Upload and cache an already decoded image; returns the cached texture if the name exists
+    std::shared_ptr<Texture2D> AddTexture(const std::string &name, const TextureImage &image);
+
     // Create and cache procedural texture
     std::shared_ptr<Texture2D> CreateSolidColorTexture(const std::string &name, uint32_t width, uint32_t height,
                                                        float r, float g, float b, float a = 1.0f);
@@ -0,0 +1,103 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief A fixed set of worker threads for data-parallel engine work
+ *
+ * Unlike DispatchQueue, which serializes tasks onto one thread, the pool runs
+ * independent tasks concurrently and splits loops into chunks with ParallelFor.
+ */
+class ThreadPool {
+public:
+    using TaskType = std::function<void()>;
+    using ChunkFunction = std::function<void(size_t chunk, size_t begin, size_t end)>;
+
+    /**
+     * @brief Get the engine-wide pool, created on first use
+     */
+    static ThreadPool &Shared();
+
+    /**
+     * @brief Default number of workers: one less than the hardware threads, since
+     *        the calling thread also takes part in ParallelFor
+     */
+    static size_t DefaultWorkerCount();
+
+    /**
+     * @brief Start the worker threads
+     * @param workerCount Number of worker threads (0 runs everything on the caller)
+     */
+    explicit ThreadPool(size_t workerCount = DefaultWorkerCount());
+
+    /**
+     * @brief Finish queued tasks and join all workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Get the number of worker threads
+     */
+    size_t GetWorkerCount() const {
+        return m_workers.size();
+    }
+
+    /**
+     * @brief Queue a task for a worker thread
+     * @param task The task to be executed (run inline if the pool has no workers)
+     */
+    void Enqueue(TaskType task);
+
+    /**
+     * @brief Queue a task and get a future for its result
+     * @param func The function to be executed
+     * @return Future holding the function's return value
+     */
+    template <typename F>
+    auto Submit(F &&func) -> std::future<decltype(func())> {
+        using ResultType = decltype(func());
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(func));
+        std::future<ResultType> result = task->get_future();
+        Enqueue([task]() { (*task)(); });
+        return result;
+    }
+
+    /**
+     * @brief Run func over [0, count) split into chunks, blocking until all chunks are done
+     *
+     * Chunk k always covers [k * chunkSize, min((k + 1) * chunkSize, count)), whatever
+     * the number of workers, so per-chunk results can be merged in a fixed order.
+     * The calling thread processes chunks as well.
+     *
+     * @param count Number of elements
+     * @param chunkSize Elements per chunk
+     * @param func Called once per chunk with the chunk index and element range
+     */
+    void ParallelFor(size_t count, size_t chunkSize, const ChunkFunction &func);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::queue<TaskType> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping{false};
+};
+
+} // namespace agl
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,83 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace agl {
+
+/**
+ * @brief Hierarchical timing wheel keyed by integer ticks
+ *
+ * Level 0 has one slot per tick; each higher level has slots covering 64 times
+ * as many ticks as the level below. An entry is filed in the lowest level whose
+ * range reaches its expiry tick and moves down a level each time the wheel turns
+ * past the start of its slot, so advancing one tick only touches the due slot
+ * (plus an occasional cascade). Expiry therefore costs O(expired) rather than
+ * O(scheduled). Entries further out than the top level can reach are filed in
+ * the top level and re-filed when it turns.
+ *
+ * Entries carry an opaque 64-bit id and cannot be cancelled; owners skip ids
+ * that are no longer relevant when they expire.
+ */
+class TimingWheel {
+public:
+    static constexpr uint32_t SlotBits = 6;
+    static constexpr uint32_t SlotCount = 1u << SlotBits;
+    static constexpr uint32_t LevelCount = 4;
+
+    /**
+     * @brief Schedule an id to expire at a tick
+     * @param tick Expiry tick; ticks at or before the current tick expire on the next Advance
+     * @param id Opaque id returned by Advance
+     */
+    void Schedule(uint64_t tick, uint64_t id);
+
+    /**
+     * @brief Turn the wheel forward
+     * @param tick Tick to advance to (ignored if not after the current tick)
+     * @param expired Receives ids that expired at or before tick, in expiry order
+     */
+    void Advance(uint64_t tick, std::vector<uint64_t> &expired);
+
+    /**
+     * @brief Drop all scheduled entries (the current tick is kept)
+     */
+    void Clear();
+
+    /**
+     * @brief Get the tick the wheel has advanced to
+     */
+    uint64_t GetCurrentTick() const {
+        return m_currentTick;
+    }
+
+    /**
+     * @brief Get number of scheduled entries
+     */
+    size_t Size() const {
+        return m_size;
+    }
+
+private:
+    struct Entry {
+        uint64_t tick;
+        uint64_t id;
+    };
+
+    // Place an entry (tick >= current tick) relative to the current tick without touching m_size
+    void Insert(const Entry &entry);
+
+    // Re-file every entry of a higher-level slot relative to the current tick
+    void Cascade(uint32_t level, uint32_t slot);
+
+    std::vector<Entry> m_slots[LevelCount][SlotCount];
+    std::vector<Entry> m_cascadeScratch;
+    uint64_t m_currentTick{0};
+    size_t m_size{0};
+};
+
+} // namespace agl
+
+#endif // TIMING_WHEEL_H
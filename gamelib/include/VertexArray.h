@@ -32,6 +32,10 @@ public:
     // Add vertex buffer with layout
     void AddVertexBuffer(std::shared_ptr<VertexBuffer> vertexBuffer, const VertexBufferLayout &layout);
 
+    // Add per-instance vertex buffer; attributes advance once every `divisor` instances
+    void AddInstanceBuffer(std::shared_ptr<VertexBuffer> vertexBuffer, const VertexBufferLayout &layout,
+                           uint32_t divisor = 1);
+
     // Set index buffer
     void SetIndexBuffer(std::shared_ptr<IndexBuffer> indexBuffer);
 
@@ -50,6 +54,7 @@ public:
     void DrawArrays(GLenum mode, uint32_t first, uint32_t count) const;
     void DrawElements(GLenum mode = GL_TRIANGLES) const;
     void DrawElements(GLenum mode, uint32_t count) const;
+    void DrawElementsInstanced(GLenum mode, uint32_t count, uint32_t instanceCount) const;
 
     // Static factory methods
     static std::unique_ptr<VertexArray> Create();
@@ -60,7 +65,7 @@ private:
     std::shared_ptr<IndexBuffer> m_indexBuffer;
     uint32_t m_vertexBufferIndex;
 
-    void SetupVertexAttributes(const VertexBufferLayout &layout);
+    void SetupVertexAttributes(const VertexBufferLayout &layout, uint32_t divisor = 0);
 };
 
 } // namespace agl
@@ -22,7 +22,8 @@ enum class VertexDataType {
     Byte = GL_BYTE,
     UnsignedByte = GL_UNSIGNED_BYTE,
     Short = GL_SHORT,
-    UnsignedShort = GL_UNSIGNED_SHORT
+    UnsignedShort = GL_UNSIGNED_SHORT,
+    HalfFloat = GL_HALF_FLOAT
 };
 
 // Vertex attribute element
@@ -51,6 +52,7 @@ struct VertexElement {
         case VertexDataType::Short:
             return count * sizeof(int16_t);
         case VertexDataType::UnsignedShort:
+        case VertexDataType::HalfFloat:
             return count * sizeof(uint16_t);
         }
         return 0;
@@ -82,6 +84,10 @@ public:
         Push(name, VertexDataType::UnsignedByte, count, normalized);
     }
 
+    void PushHalf(const std::string &name, uint32_t count = 1) {
+        Push(name, VertexDataType::HalfFloat, count);
+    }
+
     // Common vertex layouts
     static VertexBufferLayout Position3D() {
         VertexBufferLayout layout;
@@ -125,6 +131,33 @@ public:
         return layout;
     }
 
+    // Mesh layouts, one per agl::VertexFormat (see VertexCompression.h)
+    static VertexBufferLayout StandardMesh() {
+        VertexBufferLayout layout;
+        layout.PushFloat("a_Position", 3);
+        layout.PushFloat("a_Normal", 3);
+        layout.PushFloat("a_TexCoords", 2);
+        layout.PushFloat("a_Tangent", 3);
+        layout.PushFloat("a_Bitangent", 3);
+        return layout;
+    }
+
+    static VertexBufferLayout CompactMesh() {
+        VertexBufferLayout layout;
+        layout.PushFloat("a_Position", 3);
+        layout.Push("a_NormalTangent", VertexDataType::Byte, 4);
+        layout.PushHalf("a_TexCoords", 2);
+        return layout;
+    }
+
+    static VertexBufferLayout CompactQuantizedMesh() {
+        VertexBufferLayout layout;
+        layout.Push("a_Position", VertexDataType::UnsignedShort, 4); // Not normalized; w is padding
+        layout.Push("a_NormalTangent", VertexDataType::Byte, 4);
+        layout.PushHalf("a_TexCoords", 2);
+        return layout;
+    }
+
     // Getters
     const std::vector<VertexElement> &GetElements() const {
         return m_elements;
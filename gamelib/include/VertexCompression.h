@@ -0,0 +1,118 @@
+#ifndef VERTEX_COMPRESSION_H
+#define VERTEX_COMPRESSION_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace agl {
+
+struct Vertex;
+
+/**
+ * @brief GPU vertex format of a Mesh
+ *
+ * The CPU copy of a mesh always stays in agl::Vertex; only the uploaded buffer
+ * changes. Compact formats keep three attributes:
+ *  - location 0, a_Position: float xyz, or uint16 xyz (plus padding) across the bounding box, not
+ *    normalized, so the shader sees 0..65535 and scales by positionScale
+ *  - location 1, a_NormalTangent: four int8 (not normalized, so the shader sees -127..127):
+ *    octahedral normal in xy, tangent angle around the normal in z, bitangent sign in w
+ *  - location 2, a_TexCoords: half-float uv
+ * Shaders decode them with the functions in GetCompactVertexDecodeGLSL().
+ */
+enum class VertexFormat {
+    Standard,        // agl::Vertex as is, 56 bytes
+    Compact,         // Float positions, packed tangent frame and half-float uvs, 20 bytes
+    CompactQuantized // As Compact with 16-bit positions inside the bounding box, 16 bytes
+};
+
+/**
+ * @brief Vertex layout of VertexFormat::Compact
+ */
+struct CompactVertex {
+    float position[3];
+    int8_t normalTangent[4];
+    uint16_t texCoords[2]; // Half floats
+};
+
+/**
+ * @brief Vertex layout of VertexFormat::CompactQuantized
+ */
+struct QuantizedVertex {
+    uint16_t position[4]; // xyz in [0, 65535] across the bounding box, w unused
+    int8_t normalTangent[4];
+    uint16_t texCoords[2]; // Half floats
+};
+
+static_assert(sizeof(CompactVertex) == 20, "CompactVertex must stay tightly packed");
+static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must stay tightly packed");
+
+/**
+ * @brief Get the size of one vertex in the given format
+ */
+size_t GetVertexStride(VertexFormat format);
+
+/**
+ * @brief Convert to IEEE 754 half precision (round to nearest even)
+ */
+uint16_t FloatToHalf(float value);
+
+/**
+ * @brief Convert from IEEE 754 half precision
+ */
+float HalfToFloat(uint16_t value);
+
+/**
+ * @brief Encode a unit vector as an octahedral pair of int8 in [-127, 127]
+ *
+ * Picks the neighbouring grid point that decodes closest to the input, not just
+ * the rounded one, which roughly halves the worst-case angular error.
+ */
+void EncodeOctahedral(const glm::vec3 &direction, int8_t encoded[2]);
+
+/**
+ * @brief Decode an octahedral pair produced by EncodeOctahedral
+ */
+glm::vec3 DecodeOctahedral(const int8_t encoded[2]);
+
+/**
+ * @brief Encode a tangent frame into four int8 (see VertexFormat)
+ */
+void EncodeTangentFrame(const glm::vec3 &normal, const glm::vec3 &tangent, const glm::vec3 &bitangent,
+                        int8_t encoded[4]);
+
+/**
+ * @brief Decode a tangent frame produced by EncodeTangentFrame
+ */
+void DecodeTangentFrame(const int8_t encoded[4], glm::vec3 &normal, glm::vec3 &tangent, glm::vec3 &bitangent);
+
+/**
+ * @brief Pack vertices into a compact format
+ * @param vertices Source vertices
+ * @param count Number of vertices
+ * @param format Compact or CompactQuantized
+ * @param boundsMin Quantization box minimum (CompactQuantized only)
+ * @param boundsMax Quantization box maximum (CompactQuantized only)
+ * @param destination Receives count * GetVertexStride(format) bytes
+ */
+void PackVertices(const Vertex *vertices, size_t count, VertexFormat format, const glm::vec3 &boundsMin,
+                  const glm::vec3 &boundsMax, void *destination);
+
+/**
+ * @brief GLSL helpers that decode compact vertex attributes
+ *
+ * Insert the returned source after the #version line of a vertex shader. It
+ * declares the positionScale, positionOffset and compactVertex uniforms (set by
+ * Mesh for every format) and:
+ *  - vec3 agl_DecodePosition(vec3 position)
+ *  - vec3 agl_DecodeNormal(vec4 normalAttribute): float normal or octahedral, per compactVertex
+ *  - vec3 agl_DecodeOctahedral(vec2 encoded)
+ *  - void agl_DecodeTangentFrame(vec4 normalTangent, out vec3 normal, out vec3 tangent, out vec3 bitangent)
+ * ShaderProgram::CreateMeshShader() is built on it.
+ */
+const char *GetCompactVertexDecodeGLSL();
+
+} // namespace agl
+
+#endif // VERTEX_COMPRESSION_H
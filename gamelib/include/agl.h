@@ -7,12 +7,24 @@
 #include "Camera.h"
 #include "CameraController.h"
 #include "DispatchQueue.h"
+#include "Frustum.h"
 #include "Gizmos.h"
 #include "Logger.h"
+#include "MemoryStats.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "ModelLoader.h"
+#include "PrimitiveCache.h"
+#include "ParticleSystem.h"
 #include "ProjectileSystem.h"
+#include "ProjectileTrails.h"
 #include "Renderer.h"
 #include "ShadowSystem.h"
 #include "SigSlot.h"
+#include "Simd.h"
+#include "StaticBatch.h"
 #include "game.h"
 #include "input.h"
 #include "mesh.h"
@@ -69,6 +69,54 @@ public:
     }
 };
 
+// Vertex buffer rewritten every frame
+//
+// The store is split into FrameCount regions used round-robin, each guarded by a
+// fence so the CPU never writes a region the GPU may still read. With
+// GL_ARB_buffer_storage the whole store stays persistently mapped; otherwise each
+// region is mapped unsynchronized for the frame and unmapped again.
+class StreamingVertexBuffer : public VertexBuffer {
+public:
+    static constexpr uint32_t FrameCount = 3;
+
+    StreamingVertexBuffer() = default;
+    ~StreamingVertexBuffer();
+
+    StreamingVertexBuffer(StreamingVertexBuffer &&) = delete;
+    StreamingVertexBuffer &operator=(StreamingVertexBuffer &&) = delete;
+
+    // Allocate the store; reallocating a persistent (immutable) store replaces the
+    // buffer object, so vertex arrays using it must be set up again
+    void Allocate(size_t frameSize);
+
+    // Start writing the next region; returns nullptr if size exceeds the frame size
+    void *Map(size_t size);
+
+    // Finish writing; returns the byte offset of the region within the buffer
+    size_t Unmap();
+
+    // Mark the current region as in use by the draws issued since Unmap
+    void Fence();
+
+    size_t GetFrameSize() const {
+        return m_frameSize;
+    }
+    bool IsPersistent() const {
+        return m_persistentData != nullptr;
+    }
+
+private:
+    void ReleaseStorage();
+    void ReplaceBufferObject();
+
+    size_t m_frameSize{0};
+    uint32_t m_frame{0};
+    uint8_t *m_persistentData{nullptr};
+    bool m_mapped{false};
+    bool m_immutable{false}; // Store was created with glBufferStorage
+    GLsync m_fences[FrameCount]{};
+};
+
 // Index Buffer Object (Element Buffer Object)
 class IndexBuffer : public Buffer {
 public:
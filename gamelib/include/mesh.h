@@ -5,6 +5,7 @@
 #include "Texture.h"
 #include "VertexArray.h"
 #include "VertexBufferLayout.h"
+#include "VertexCompression.h"
 #include "buffer.h"
 
 #include <glm/glm.hpp>
@@ -14,6 +15,8 @@
 
 namespace agl {
 
+class Camera;
+
 // Projectile types for the shooter system
 enum class ProjectileType {
     Bullet,  // Small, fast projectile
@@ -66,6 +69,62 @@ struct Material {
         : diffuse(diff), specular(spec), shininess(shine) {}
 };
 
+/**
+ * @brief Set the material.* uniforms of a shader and bind the material's textures
+ *
+ * Textures take consecutive units from 0 in the order diffuse, specular, normal.
+ * @param shader Shader in use
+ * @param material Material to apply
+ */
+void ApplyMaterial(ShaderProgram &shader, const Material &material);
+
+/**
+ * @brief One level of detail: a range of the mesh's shared index buffer
+ */
+struct MeshLOD {
+    uint32_t firstIndex{0};
+    uint32_t indexCount{0};
+    float error{0.0f}; // Geometric deviation from the full mesh, in object space units
+};
+
+/**
+ * @brief Sphere enclosing a mesh, in object space
+ */
+struct BoundingSphere {
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+};
+
+/**
+ * @brief A cluster of neighbouring triangles: a range of the full-detail indices with culling bounds
+ */
+struct Meshlet {
+    uint32_t firstIndex{0};
+    uint32_t indexCount{0};
+    BoundingSphere bounds;    // Object space
+    glm::vec3 coneAxis{0.0f}; // Average facing of the triangles
+    float coneCutoff{1.0f};   // Sine of the normal cone's half angle; 1 if the triangles cannot be culled as one
+};
+
+/**
+ * @brief Counters of the last Mesh::RenderCulled
+ */
+struct MeshletCullStats {
+    uint32_t visible{0};
+    uint32_t backFacing{0};
+    uint32_t outside{0}; // Outside the frustum
+    uint32_t ranges{0};  // Index ranges submitted, after joining neighbours
+};
+
+/**
+ * @brief What a mesh keeps in system memory once its geometry is on the GPU
+ */
+enum class MeshResidency {
+    KeepAll,       // Full vertices and indices; every operation stays available
+    PositionsOnly, // Vertex positions and full-detail indices, enough for collision and picking
+    GpuOnly        // Nothing; the mesh can only be drawn
+};
+
 /**
  * @brief A mesh represents a collection of vertices and indices that can be rendered
  *
@@ -122,6 +181,13 @@ public:
      */
     void SetIndices(const std::vector<uint32_t> &indices);
 
+    /**
+     * @brief Replace vertex and index data together, uploading only once
+     * @param vertices Vector of vertex data
+     * @param indices Vector of index data
+     */
+    void SetGeometry(std::vector<Vertex> vertices, std::vector<uint32_t> indices);
+
     /**
      * @brief Set the material for this mesh
      * @param material Material properties
@@ -141,6 +207,115 @@ public:
      */
     void UpdateVertices(const std::vector<Vertex> &vertices, size_t offset);
 
+    /**
+     * @brief Choose the GPU vertex format (re-uploads the vertex buffer)
+     *
+     * Compact formats trade precision for bandwidth; shaders must decode them
+     * (see VertexFormat and GetCompactVertexDecodeGLSL()). Quantized positions are
+     * decoded with the positionScale/positionOffset uniforms set by Render.
+     * @param format New vertex format
+     */
+    void SetVertexFormat(VertexFormat format);
+
+    /**
+     * @brief Get the GPU vertex format
+     */
+    VertexFormat GetVertexFormat() const {
+        return m_vertexFormat;
+    }
+
+    /**
+     * @brief Get the size of one vertex in the GPU buffer
+     */
+    size_t GetVertexStride() const {
+        return agl::GetVertexStride(m_vertexFormat);
+    }
+
+    // ========== Residency ==========
+
+    /**
+     * @brief Choose which CPU copies of the geometry survive the upload
+     *
+     * Static geometry that is never read back does not need its vertices in
+     * system memory once they are on the GPU. The policy is applied right away
+     * if the mesh is uploaded, and again after each upload of new geometry.
+     * Released data cannot be brought back by a later KeepAll; replace the
+     * geometry with SetGeometry() instead. Counts, bounds, levels of detail and
+     * rendering keep working; operations that read the vertices (SetVertices,
+     * SetIndices, UpdateVertices, SetVertexFormat, CalculateNormals/Tangents,
+     * GenerateLODs, MeshOptimizer::Optimize, MeshCache::Write) report an error
+     * and leave the mesh unchanged. Freed bytes are reported to MemoryStats as
+     * released MemoryCategory::MeshCPU memory.
+     * @param residency New policy
+     */
+    void SetResidency(MeshResidency residency);
+
+    /**
+     * @brief Get the residency policy
+     */
+    MeshResidency GetResidency() const {
+        return m_residency;
+    }
+
+    /**
+     * @brief Check whether the full CPU copy of the vertices is available
+     */
+    bool HasCPUData() const {
+        return !m_cpuDataReleased;
+    }
+
+    /**
+     * @brief Check whether vertex positions can be read (KeepAll, or PositionsOnly after release)
+     *
+     * Switching to PositionsOnly after a GpuOnly release does not bring the positions back.
+     */
+    bool HasCPUPositions() const {
+        return !m_cpuDataReleased || !m_positions.empty();
+    }
+
+    /**
+     * @brief Get the position of a vertex from whichever CPU copy is resident
+     *
+     * Only valid while HasCPUPositions() is true.
+     */
+    const glm::vec3 &GetVertexPosition(size_t index) const {
+        return m_cpuDataReleased ? m_positions[index] : m_vertices[index].position;
+    }
+
+    /**
+     * @brief Get the system memory held by the mesh's geometry, in bytes
+     */
+    size_t GetCPUMemoryUsage() const;
+
+    /**
+     * @brief Get the size of the mesh's vertex and index buffers, in bytes (zero for shared geometry)
+     */
+    size_t GetGPUMemoryUsage() const;
+
+    // ========== Shared Geometry ==========
+
+    /**
+     * @brief Create a mesh that draws another mesh's vertex and index buffers
+     *
+     * The new mesh gets its own vertex array, so it can take its own instance
+     * buffers, and its own material and active level of detail, but no GPU or
+     * CPU copy of the geometry, as if a GpuOnly residency had released it.
+     * Replacing its geometry with SetGeometry() makes it an ordinary mesh. Counts, bounds, vertex format and levels of
+     * detail are copied from the source as they are now; later changes to the
+     * source are not seen. The source stays alive as long as a mesh shares it.
+     * See PrimitiveCache for shared procedural primitives.
+     * @param geometry Uploaded mesh to share
+     * @return Mesh drawing the shared buffers with a copy of the source's material, or an empty mesh
+     */
+    static Mesh CreateShared(std::shared_ptr<const Mesh> geometry);
+
+    /**
+     * @brief Get the mesh whose buffers this mesh draws, or null if it owns its geometry
+     */
+    const std::shared_ptr<const Mesh> &GetSharedGeometry() const {
+        return m_sharedGeometry;
+    }
+
     // ========== Rendering ==========
 
     /**
@@ -161,29 +336,224 @@ public:
      */
     void Render(ShaderProgram &shader, const glm::mat4 &modelMatrix);
 
+    /**
+     * @brief Render several instances of the mesh with one draw call
+     *
+     * Material uniforms are uploaded once. Per-instance data must come from
+     * buffers attached with AddInstanceBuffer().
+     * @param shader Shader to use for rendering
+     * @param instanceCount Number of instances to draw
+     */
+    void RenderInstanced(ShaderProgram &shader, uint32_t instanceCount);
+
+    /**
+     * @brief Attach a per-instance vertex buffer to the mesh's vertex array
+     *
+     * Instance attributes are assigned locations after the mesh's own vertex
+     * attributes (position, normal, texCoords, tangent, bitangent = 0..4 for the
+     * standard format; position, normalTangent, texCoords = 0..2 for compact ones).
+     * The buffer is remembered and re-attached whenever the vertex array is
+     * rebuilt, e.g. by SetVertexFormat(), so its locations follow the new format.
+     * A buffer added before the mesh is set up is attached at setup.
+     * @param buffer Buffer holding per-instance data
+     * @param layout Layout of one instance
+     */
+    void AddInstanceBuffer(std::shared_ptr<VertexBuffer> buffer, const VertexBufferLayout &layout);
+
+    // ========== Levels of Detail ==========
+
+    /**
+     * @brief Generate simplified levels of detail with MeshSimplifier
+     *
+     * Each level is simplified from the previous one and stored as an index range
+     * after the full-detail indices, so all levels share the vertex and index
+     * buffers. Generation stops early once a level cannot be reduced further
+     * (open or seam-locked geometry). Replacing the vertices or indices discards
+     * the levels; run MeshOptimizer before generating them, not after.
+     * @param triangleRatios Triangle count of each level relative to the full mesh, in decreasing order
+     * @return Number of levels, including the full-detail level 0
+     */
+    size_t GenerateLODs(const std::vector<float> &triangleRatios = {0.5f, 0.25f, 0.1f});
+
+    /**
+     * @brief Discard generated levels of detail
+     */
+    void ClearLODs();
+
+    /**
+     * @brief Get the number of levels of detail, including the full-detail level 0
+     */
+    size_t GetLODCount() const {
+        return m_lods.size() + 1;
+    }
+
+    /**
+     * @brief Get the index range and error of a level of detail
+     */
+    MeshLOD GetLOD(size_t level) const;
+
+    /**
+     * @brief Choose the level drawn by Render and RenderInstanced (clamped to the available levels)
+     */
+    void SetActiveLOD(size_t level);
+
+    /**
+     * @brief Get the level drawn by Render and RenderInstanced
+     */
+    size_t GetActiveLOD() const {
+        return m_activeLOD;
+    }
+
+    /**
+     * @brief Projected diameter of the mesh's bounding sphere in pixels
+     * @param modelMatrix Model transformation matrix
+     * @param view View matrix
+     * @param projection Perspective or orthographic projection matrix
+     * @param viewportHeight Viewport height in pixels
+     */
+    float GetProjectedSize(const glm::mat4 &modelMatrix, const glm::mat4 &view, const glm::mat4 &projection,
+                           float viewportHeight) const;
+
+    /**
+     * @brief Coarsest level whose error stays below a pixel budget, with hysteresis
+     *
+     * A finer level is chosen as soon as the current one exceeds the budget, but a
+     * coarser level only once its error is below (1 - hysteresis) of the budget, so
+     * objects near a threshold do not flicker between levels. The mesh is shared by
+     * every object using it, so the current level is passed in per object.
+     * @param projectedSize Bounding sphere diameter in pixels (see GetProjectedSize)
+     * @param currentLOD Level the object was drawn with last frame
+     * @param pixelError Allowed screen space error in pixels
+     * @param hysteresis Fraction of the budget a coarser level must undercut
+     * @return Level to draw
+     */
+    size_t SelectLOD(float projectedSize, size_t currentLOD, float pixelError = 1.0f, float hysteresis = 0.25f) const;
+
+    /**
+     * @brief SelectLOD from a camera and model matrix
+     * @param camera Camera providing the view and projection matrices
+     * @param modelMatrix Model transformation matrix
+     * @param viewportHeight Viewport height in pixels
+     * @param currentLOD Level the object was drawn with last frame
+     * @param pixelError Allowed screen space error in pixels
+     */
+    size_t SelectLOD(const Camera &camera, const glm::mat4 &modelMatrix, float viewportHeight, size_t currentLOD,
+                     float pixelError = 1.0f) const;
+
+    // ========== Meshlets ==========
+
+    /**
+     * @brief Split the full-detail triangles into clusters for per-cluster culling (see MeshletBuilder)
+     *
+     * The index buffer is reordered so each cluster is a contiguous range; what is
+     * rendered does not change. Levels of detail are kept but drawn whole. Replacing
+     * the vertices or indices discards the clusters, so run MeshOptimizer first.
+     * Non-indexed meshes are not clustered.
+     * @param maxTriangles Triangles per cluster; 64 to 128 balances culling precision against per-cluster cost
+     * @param coneWeight Preference for triangles facing the same way over sharing vertices (0 to 1)
+     * @return Number of clusters
+     */
+    size_t GenerateMeshlets(uint32_t maxTriangles = 128, float coneWeight = 0.5f);
+
+    /**
+     * @brief Discard the clusters; the index order stays
+     */
+    void ClearMeshlets();
+
+    /**
+     * @brief Get the clusters of the full-detail level
+     */
+    const std::vector<Meshlet> &GetMeshlets() const {
+        return m_meshlets;
+    }
+
+    /**
+     * @brief Render only the clusters that are inside the frustum and not facing away
+     *
+     * Clusters are tested on the CPU in object space and the visible index ranges
+     * are drawn with one glMultiDrawElements. Meshes without clusters, or drawing
+     * a coarser level of detail, are drawn whole. Back-face tests are skipped for
+     * mirroring model matrices.
+     * @param shader Shader to use for rendering
+     * @param modelMatrix Model transformation matrix
+     * @param viewProjection Projection times view matrix
+     * @param cameraPosition World space eye position of a perspective camera
+     * @param cullBackFaces False for orthographic views or two-sided materials
+     */
+    void RenderCulled(ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat4 &viewProjection,
+                      const glm::vec3 &cameraPosition, bool cullBackFaces = true);
+
+    /**
+     * @brief RenderCulled with a camera's matrices; orthographic cameras only cull against the frustum
+     */
+    void RenderCulled(ShaderProgram &shader, const glm::mat4 &modelMatrix, const Camera &camera);
+
+    /**
+     * @brief Get the counters of the last RenderCulled
+     */
+    const MeshletCullStats &GetMeshletStats() const {
+        return m_meshletStats;
+    }
+
     // ========== Utility Functions ==========
 
     /**
      * @brief Calculate normals for the mesh (if not provided)
+     *
+     * Each vertex gets the normalized sum of the unit normals of its triangles.
+     * Triangles are processed in parallel SIMD chunks and every vertex then sums
+     * its own triangles in index order, so the result is bit-for-bit the same
+     * for any thread count and instruction set. The vertex-to-triangle adjacency
+     * is kept until the topology changes, so recalculating after deforming the
+     * vertices (UpdateVertices) only repeats the arithmetic.
      */
     void CalculateNormals();
 
     /**
      * @brief Calculate tangents and bitangents for normal mapping
+     *
+     * Parallel and deterministic in the same way as CalculateNormals().
      */
     void CalculateTangents();
 
+    /**
+     * @brief Calculate tangents and bitangents of vertices that are not in a mesh yet
+     *
+     * Same result as the member version, for loaders that prepare vertex arrays before
+     * SetGeometry so the mesh is uploaded once. Needs no GL context.
+     */
+    static void CalculateTangents(std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
+
     /**
      * @brief Get the bounding box of the mesh
+     *
+     * Bounds are computed when the vertices are set and kept up to date by
+     * UpdateVertices, so this does not touch the vertex data.
      * @return Pair of min and max points
      */
-    std::pair<glm::vec3, glm::vec3> GetBoundingBox() const;
+    std::pair<glm::vec3, glm::vec3> GetBoundingBox() const {
+        return {m_boundsMin, m_boundsMax};
+    }
 
     /**
      * @brief Get the center point of the mesh
-     * @return Center point
+     * @return Center point of the bounding box
+     */
+    glm::vec3 GetCenter() const {
+        return (m_boundsMin + m_boundsMax) * 0.5f;
+    }
+
+    /**
+     * @brief Get a tight bounding sphere of the mesh
+     *
+     * Built from extreme points along seven directions (EPOS) and grown over the
+     * remaining vertices (Ritter), typically within a few percent of the minimal
+     * sphere. Partial vertex updates grow it as needed; it is rebuilt whenever
+     * the bounding box has to be rescanned.
      */
-    glm::vec3 GetCenter() const;
+    BoundingSphere GetBoundingSphere() const {
+        return {m_boundsCenter, m_boundsRadius};
+    }
 
     // ========== Static Primitive Creation ==========
 
@@ -272,20 +642,41 @@ public:
 
     // ========== Getters ==========
 
+    /**
+     * @brief Get the CPU copy of the vertex data (empty once released, see SetResidency)
+     */
+    const std::vector<Vertex> &GetVertices() const {
+        return m_vertices;
+    }
+
+    /**
+     * @brief Get the CPU copy of the index data (empty once released by MeshResidency::GpuOnly)
+     */
+    const std::vector<uint32_t> &GetIndices() const {
+        return m_indices;
+    }
+
+    /**
+     * @brief Get the positions kept by MeshResidency::PositionsOnly (empty otherwise)
+     */
+    const std::vector<glm::vec3> &GetPositions() const {
+        return m_positions;
+    }
+
     /**
      * @brief Get the vertex count
      * @return Number of vertices
      */
     size_t GetVertexCount() const {
-        return m_vertices.size();
+        return m_vertexCount;
     }
 
     /**
      * @brief Get the triangle count
-     * @return Number of triangles
+     * @return Number of triangles at full detail
      */
     size_t GetTriangleCount() const {
-        return m_indices.size() / 3;
+        return m_indexCount / 3;
     }
 
     /**
@@ -293,7 +684,7 @@ public:
      * @return Number of indices
      */
     size_t GetIndexCount() const {
-        return m_indices.size();
+        return m_indexCount;
     }
 
     /**
@@ -301,7 +692,7 @@ public:
      * @return True if mesh has indices
      */
     bool HasIndices() const {
-        return !m_indices.empty();
+        return m_indexCount > 0;
     }
 
     /**
@@ -325,10 +716,13 @@ public:
      * @return True if mesh is valid
      */
     bool IsValid() const {
-        return !m_vertices.empty();
+        return m_vertexCount > 0;
     }
 
 private:
+    // Reads and writes GPU-ready geometry directly
+    friend class MeshCache;
+
     // ========== Private Methods ==========
 
     /**
@@ -337,10 +731,86 @@ private:
     void SetupMesh();
 
     /**
-     * @brief Bind material textures to shader uniforms
-     * @param shader Shader to bind textures to
+     * @brief Upload vertices [offset, offset + count) in the current vertex format
+     */
+    void UploadVertexRange(size_t offset, size_t count);
+
+    /**
+     * @brief Create the VAO, vertex buffer and index buffer from GPU-ready data
+     * @param gpuVertices Vertices already in the mesh's vertex format
+     * @param gpuIndices Full-detail indices followed by the LOD indices, or null to upload m_indices and
+     *        m_lodIndices
+     * @param gpuIndexCount Number of gpuIndices; the CPU index copies may be empty when they are given
      */
-    void BindMaterialTextures(ShaderProgram &shader);
+    void UploadGeometry(const void *gpuVertices, const uint32_t *gpuIndices, size_t gpuIndexCount = 0);
+
+    /**
+     * @brief Create the vertex array for m_VBO in the current vertex format
+     */
+    void CreateVertexArray();
+
+    /**
+     * @brief Upload the full-detail and LOD indices into one index buffer
+     * @param gpuIndices Combined indices, or null to combine m_indices and m_lodIndices
+     * @param gpuIndexCount Number of gpuIndices
+     */
+    void UploadIndices(const uint32_t *gpuIndices = nullptr, size_t gpuIndexCount = 0);
+
+    /**
+     * @brief Recompute the bounding box and sphere from every vertex
+     */
+    void ComputeBounds();
+
+    /**
+     * @brief Refresh the bounds after vertices [offset, offset + count) changed
+     * @param previousMin Minimum of the range before the change
+     * @param previousMax Maximum of the range before the change
+     */
+    void UpdateBounds(size_t offset, size_t count, const glm::vec3 &previousMin, const glm::vec3 &previousMax);
+
+    /**
+     * @brief Build the vertex-to-triangle adjacency of indexed meshes if it is missing
+     */
+    void BuildVertexTriangleAdjacency();
+
+    /**
+     * @brief Forget the adjacency after the vertices or indices were replaced
+     */
+    void InvalidateAdjacency();
+
+    /**
+     * @brief Recompute the cluster bounds after the vertices moved
+     */
+    void RefreshMeshletBounds();
+
+    /**
+     * @brief Drop the CPU copies the residency policy does not keep
+     */
+    void ApplyResidency();
+
+    /**
+     * @brief Report a change in CPU or GPU memory to MemoryStats
+     * @param released Report CPU memory that went away as released rather than freed
+     */
+    void TrackMemory(bool released = false);
+
+    /**
+     * @brief Print an error and return false if the CPU vertices were released
+     * @param operation Qualified name of the operation that needs them
+     */
+    bool RequireCPUData(const char *operation) const;
+
+    /**
+     * @brief Draw the active level of detail with the bound VAO
+     */
+    void DrawElements(uint32_t instanceCount);
+
+    /**
+     * @brief Set the vertex decode uniforms of GetCompactVertexDecodeGLSL() for the current format
+     *
+     * Shaders that do not declare them are left alone, without missing-uniform warnings.
+     */
+    void SetVertexDecodeUniforms(ShaderProgram &shader) const;
 
     // ========== Data Members ==========
 
@@ -348,6 +818,56 @@ private:
     std::vector<uint32_t> m_indices;
     Material m_material;
 
+    // Counts survive releasing the CPU copies
+    size_t m_vertexCount{0};
+    size_t m_indexCount{0};
+
+    // What stays in system memory after upload; m_positions is only filled by PositionsOnly
+    MeshResidency m_residency{MeshResidency::KeepAll};
+    bool m_cpuDataReleased{false};
+    std::vector<glm::vec3> m_positions;
+
+    // Bytes last reported to MemoryStats
+    size_t m_trackedCPUBytes{0};
+    size_t m_trackedGPUBytes{0};
+
+    // Owner of m_VBO and m_EBO when they are shared (see CreateShared)
+    std::shared_ptr<const Mesh> m_sharedGeometry;
+
+    // GPU vertex format; quantized positions span the box captured at upload
+    VertexFormat m_vertexFormat{VertexFormat::Standard};
+    glm::vec3 m_quantizationMin{0.0f};
+    glm::vec3 m_quantizationMax{0.0f};
+
+    // Levels of detail 1..N, stored after m_indices in the index buffer
+    std::vector<uint32_t> m_lodIndices;
+    std::vector<MeshLOD> m_lods;
+    size_t m_activeLOD{0};
+
+    // Clusters of the full-detail indices, with per-draw scratch for RenderCulled
+    std::vector<Meshlet> m_meshlets;
+    MeshletCullStats m_meshletStats;
+    std::vector<uint32_t> m_visibleMeshlets;
+    std::vector<GLsizei> m_drawCounts;
+    std::vector<const void *> m_drawOffsets;
+
+    // Triangles around each vertex in compressed rows, for normal and tangent generation
+    std::vector<uint32_t> m_vertexTriangleOffsets;
+    std::vector<uint32_t> m_vertexTriangles;
+
+    // Bounding box and sphere, kept current with the vertices
+    glm::vec3 m_boundsMin{0.0f};
+    glm::vec3 m_boundsMax{0.0f};
+    glm::vec3 m_boundsCenter{0.0f};
+    float m_boundsRadius{0.0f};
+
+    // Per-instance buffers, re-attached after the mesh's own attributes when the VAO is rebuilt
+    struct InstanceBinding {
+        std::shared_ptr<VertexBuffer> buffer;
+        VertexBufferLayout layout;
+    };
+    std::vector<InstanceBinding> m_instanceBuffers;
+
     // OpenGL objects
     std::unique_ptr<VertexArray> m_VAO;
     std::shared_ptr<VertexBuffer> m_VBO;
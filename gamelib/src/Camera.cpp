@@ -198,6 +198,10 @@ bool Camera::IsInView(const glm::vec3 &point, float radius) const {
             ndcPos.y <= 1.0f + tolerance && ndcPos.z >= -1.0f - tolerance && ndcPos.z <= 1.0f + tolerance);
 }
 
+Frustum Camera::GetFrustum() const {
+    return Frustum::FromMatrix(GetViewProjectionMatrix());
+}
+
 // Calculates the front vector from the Camera's (updated) Euler Angles
 void Camera::UpdateCameraVectors() {
     // Calculate the new Front vector
@@ -0,0 +1,260 @@
+#include "CollisionBVH.h"
+#include "SimdLanes.h"
+#include <algorithm>
+#include <limits>
+
+namespace agl {
+
+namespace {
+
+// Every path pads to this many lanes so kernels never need a scalar tail
+constexpr size_t LanePadding = 8;
+
+// Padding rays start far outside any sensible scene and have zero length, so
+// they never enter a node
+constexpr float PaddingCoordinate = 1.0e30f;
+
+constexpr float NoHit = std::numeric_limits<float>::infinity();
+
+// Largest number of shapes in a leaf
+constexpr uint32_t LeafSize = 4;
+
+} // namespace
+
+/**
+ * @brief Raw view of a tree and its trace scratch handed to the kernels
+ */
+struct BVHTraceView {
+    using Node = CollisionBVH::Node;
+    using Primitive = CollisionBVH::Primitive;
+
+    // Median splits keep the depth below log2(primitive count) + 1
+    static constexpr size_t MaxDepth = 64;
+
+    explicit BVHTraceView(CollisionBVH &bvh)
+        : paddedCount(bvh.m_times.size()), nodes(bvh.m_nodes.data()), primitives(bvh.m_primitives.data()),
+          spheres(bvh.m_spheres.data()), boxes(bvh.m_boxes.data()), capsules(bvh.m_capsules.data()),
+          startX(bvh.m_startX.data()), startY(bvh.m_startY.data()), startZ(bvh.m_startZ.data()),
+          deltaX(bvh.m_deltaX.data()), deltaY(bvh.m_deltaY.data()), deltaZ(bvh.m_deltaZ.data()),
+          inverseDeltaX(bvh.m_inverseDeltaX.data()), inverseDeltaY(bvh.m_inverseDeltaY.data()),
+          inverseDeltaZ(bvh.m_inverseDeltaZ.data()), lengthSquared(bvh.m_lengthSquared.data()),
+          times(bvh.m_times.data()), targets(bvh.m_targets.data()), types(bvh.m_types.data()) {}
+
+    size_t paddedCount;
+    const Node *nodes;
+    const Primitive *primitives;
+    const CollisionSphere *spheres;
+    const CollisionAABB *boxes;
+    const CollisionCapsule *capsules;
+    const float *startX, *startY, *startZ;
+    const float *deltaX, *deltaY, *deltaZ;
+    const float *inverseDeltaX, *inverseDeltaY, *inverseDeltaZ;
+    const float *lengthSquared;
+    float *times;
+    uint32_t *targets;
+    CollisionShapeType *types;
+};
+
+namespace scalar {
+#define AGL_BVH_LANES simd::ScalarLanes
+#define AGL_BVH_TARGET
+#include "CollisionBVHKernels.h"
+#undef AGL_BVH_LANES
+#undef AGL_BVH_TARGET
+} // namespace scalar
+
+#if defined(AGL_SIMD_X86)
+
+namespace sse2 {
+#define AGL_BVH_LANES simd::SSE2Lanes
+#define AGL_BVH_TARGET AGL_TARGET_SSE2
+#include "CollisionBVHKernels.h"
+#undef AGL_BVH_LANES
+#undef AGL_BVH_TARGET
+} // namespace sse2
+
+namespace avx2 {
+#define AGL_BVH_LANES simd::AVX2Lanes
+#define AGL_BVH_TARGET AGL_TARGET_AVX2
+#include "CollisionBVHKernels.h"
+#undef AGL_BVH_LANES
+#undef AGL_BVH_TARGET
+} // namespace avx2
+
+#endif // AGL_SIMD_X86
+
+// ========== CollisionBVH Implementation ==========
+
+void CollisionBVH::Build(const std::vector<CollisionSphere> &spheres, const std::vector<CollisionAABB> &boxes,
+                         const std::vector<CollisionCapsule> &capsules) {
+    Clear();
+    m_spheres = spheres;
+    m_boxes = boxes;
+    m_capsules = capsules;
+
+    m_buildEntries.clear();
+    m_buildEntries.reserve(spheres.size() + boxes.size() + capsules.size());
+    for (size_t i = 0; i < spheres.size(); ++i) {
+        const glm::vec3 extent(spheres[i].radius);
+        m_buildEntries.push_back(BuildEntry{spheres[i].center - extent, spheres[i].center + extent, spheres[i].center,
+                                            Primitive{static_cast<uint32_t>(i), CollisionShapeType::Sphere}});
+    }
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        m_buildEntries.push_back(BuildEntry{boxes[i].min, boxes[i].max, (boxes[i].min + boxes[i].max) * 0.5f,
+                                            Primitive{static_cast<uint32_t>(i), CollisionShapeType::AABB}});
+    }
+    for (size_t i = 0; i < capsules.size(); ++i) {
+        const glm::vec3 extent(capsules[i].radius);
+        m_buildEntries.push_back(BuildEntry{glm::min(capsules[i].start, capsules[i].end) - extent,
+                                            glm::max(capsules[i].start, capsules[i].end) + extent,
+                                            (capsules[i].start + capsules[i].end) * 0.5f,
+                                            Primitive{static_cast<uint32_t>(i), CollisionShapeType::Capsule}});
+    }
+
+    if (m_buildEntries.empty()) {
+        return;
+    }
+
+    m_nodes.reserve(m_buildEntries.size() * 2);
+    m_nodes.emplace_back();
+    BuildNode(0, 0, static_cast<uint32_t>(m_buildEntries.size()));
+
+    m_primitives.reserve(m_buildEntries.size());
+    for (const BuildEntry &entry : m_buildEntries) {
+        m_primitives.push_back(entry.primitive);
+    }
+}
+
+void CollisionBVH::BuildNode(uint32_t nodeIndex, uint32_t first, uint32_t count) {
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(-std::numeric_limits<float>::max());
+    glm::vec3 centroidMin = boundsMin;
+    glm::vec3 centroidMax = boundsMax;
+    for (uint32_t i = first; i < first + count; ++i) {
+        const BuildEntry &entry = m_buildEntries[i];
+        boundsMin = glm::min(boundsMin, entry.min);
+        boundsMax = glm::max(boundsMax, entry.max);
+        centroidMin = glm::min(centroidMin, entry.centroid);
+        centroidMax = glm::max(centroidMax, entry.centroid);
+    }
+
+    Node &node = m_nodes[nodeIndex];
+    node.min = boundsMin;
+    node.max = boundsMax;
+    node.axis = 0;
+
+    if (count <= LeafSize) {
+        node.first = first;
+        node.count = static_cast<uint16_t>(count);
+        return;
+    }
+
+    // Split at the median centroid along the widest centroid extent, which
+    // bounds the depth so traversal stacks stay small
+    const glm::vec3 extent = centroidMax - centroidMin;
+    uint16_t axis = 0;
+    if (extent.y > extent.x) {
+        axis = 1;
+    }
+    if (extent.z > extent[axis]) {
+        axis = 2;
+    }
+
+    const uint32_t half = count / 2;
+    std::nth_element(m_buildEntries.begin() + first, m_buildEntries.begin() + first + half,
+                     m_buildEntries.begin() + first + count, [axis](const BuildEntry &a, const BuildEntry &b) {
+                         return a.centroid[axis] < b.centroid[axis];
+                     });
+
+    const uint32_t left = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    m_nodes.emplace_back();
+
+    // m_nodes may have reallocated
+    m_nodes[nodeIndex].first = left;
+    m_nodes[nodeIndex].count = 0;
+    m_nodes[nodeIndex].axis = axis;
+
+    BuildNode(left, first, half);
+    BuildNode(left + 1, first + half, count - half);
+}
+
+void CollisionBVH::Clear() {
+    m_spheres.clear();
+    m_boxes.clear();
+    m_capsules.clear();
+    m_nodes.clear();
+    m_primitives.clear();
+}
+
+void CollisionBVH::Trace(const glm::vec3 *origins, const glm::vec3 *directions, const float *maxDistances,
+                         size_t count, std::vector<RayHit> &hits) {
+    hits.assign(count, RayHit());
+    if (count == 0 || m_nodes.empty()) {
+        return;
+    }
+
+    const size_t paddedCount = (count + LanePadding - 1) / LanePadding * LanePadding;
+    m_startX.resize(paddedCount);
+    m_startY.resize(paddedCount);
+    m_startZ.resize(paddedCount);
+    m_deltaX.resize(paddedCount);
+    m_deltaY.resize(paddedCount);
+    m_deltaZ.resize(paddedCount);
+    m_inverseDeltaX.resize(paddedCount);
+    m_inverseDeltaY.resize(paddedCount);
+    m_inverseDeltaZ.resize(paddedCount);
+    m_lengthSquared.resize(paddedCount);
+    m_times.assign(paddedCount, NoHit);
+    m_targets.assign(paddedCount, 0);
+    m_types.assign(paddedCount, CollisionShapeType::None);
+
+    // Rays become segments origin + t * delta with t in [0, 1]
+    for (size_t i = 0; i < paddedCount; ++i) {
+        glm::vec3 start(PaddingCoordinate);
+        glm::vec3 delta(0.0f);
+        if (i < count) {
+            const float length = glm::length(directions[i]);
+            if (length > 0.0f && maxDistances[i] > 0.0f) {
+                start = origins[i];
+                delta = directions[i] * (maxDistances[i] / length);
+            }
+        }
+
+        m_startX[i] = start.x;
+        m_startY[i] = start.y;
+        m_startZ[i] = start.z;
+        m_deltaX[i] = delta.x;
+        m_deltaY[i] = delta.y;
+        m_deltaZ[i] = delta.z;
+        // Division by zero gives +-infinity, which the slab test handles
+        m_inverseDeltaX[i] = 1.0f / delta.x;
+        m_inverseDeltaY[i] = 1.0f / delta.y;
+        m_inverseDeltaZ[i] = 1.0f / delta.z;
+        m_lengthSquared[i] = glm::dot(delta, delta);
+    }
+
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        avx2::TracePackets(BVHTraceView(*this));
+        break;
+    case simd::InstructionSet::SSE2:
+        sse2::TracePackets(BVHTraceView(*this));
+        break;
+#endif
+    default:
+        scalar::TracePackets(BVHTraceView(*this));
+        break;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (m_types[i] != CollisionShapeType::None) {
+            hits[i].targetIndex = m_targets[i];
+            hits[i].targetType = m_types[i];
+            hits[i].distance = m_times[i] * maxDistances[i];
+        }
+    }
+}
+
+} // namespace agl
@@ -0,0 +1,106 @@
+// Ray packet traversal of a CollisionBVH, compiled once per instruction set.
+//
+// No include guard: CollisionBVH.cpp includes this file once per lane wrapper,
+// inside a namespace named after the instruction set, with AGL_BVH_LANES set to
+// a simd::*Lanes type and AGL_BVH_TARGET to the matching target attribute.
+// Each packet keeps the earliest time per ray in BVHTraceView::times.
+
+using L = AGL_BVH_LANES;
+using Float = L::Float;
+using Mask = L::Mask;
+
+#define AGL_SHAPE_TARGET AGL_BVH_TARGET
+#include "CollisionShapeKernels.h"
+#undef AGL_SHAPE_TARGET
+
+AGL_BVH_TARGET void TracePackets(const BVHTraceView &view) {
+    const Float one = L::Set1(1.0f);
+
+    for (size_t i = 0; i < view.paddedCount; i += L::Width) {
+        const Float sx = L::Load(view.startX + i);
+        const Float sy = L::Load(view.startY + i);
+        const Float sz = L::Load(view.startZ + i);
+        const Float dx = L::Load(view.deltaX + i);
+        const Float dy = L::Load(view.deltaY + i);
+        const Float dz = L::Load(view.deltaZ + i);
+        const Float ix = L::Load(view.inverseDeltaX + i);
+        const Float iy = L::Load(view.inverseDeltaY + i);
+        const Float iz = L::Load(view.inverseDeltaZ + i);
+        const Float dd = L::Load(view.lengthSquared + i);
+        Float best = L::Load(view.times + i);
+
+        // Children are visited front to back along the first ray's direction
+        const bool negative[3] = {view.deltaX[i] < 0.0f, view.deltaY[i] < 0.0f, view.deltaZ[i] < 0.0f};
+
+        uint32_t stack[BVHTraceView::MaxDepth];
+        size_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0) {
+            const BVHTraceView::Node &node = view.nodes[stack[--stackSize]];
+
+            // Skip the node unless some ray enters it before its closest hit so far
+            Float enter;
+            const Mask active = BoxTime(sx, sy, sz, ix, iy, iz, L::Set1(node.min.x), L::Set1(node.min.y),
+                                        L::Set1(node.min.z), L::Set1(node.max.x), L::Set1(node.max.y),
+                                        L::Set1(node.max.z), L::Min(best, one), enter);
+            if (L::MoveMask(active) == 0) {
+                continue;
+            }
+
+            if (node.count == 0) {
+                if (negative[node.axis]) {
+                    stack[stackSize++] = node.first;
+                    stack[stackSize++] = node.first + 1;
+                } else {
+                    stack[stackSize++] = node.first + 1;
+                    stack[stackSize++] = node.first;
+                }
+                continue;
+            }
+
+            for (uint32_t p = node.first; p < node.first + node.count; ++p) {
+                const BVHTraceView::Primitive &primitive = view.primitives[p];
+
+                Float time;
+                Mask hit;
+                switch (primitive.type) {
+                case CollisionShapeType::Sphere: {
+                    const CollisionSphere &sphere = view.spheres[primitive.index];
+                    hit = SphereTime(L::Sub(sx, L::Set1(sphere.center.x)), L::Sub(sy, L::Set1(sphere.center.y)),
+                                     L::Sub(sz, L::Set1(sphere.center.z)), dx, dy, dz, dd,
+                                     L::Set1(sphere.radius * sphere.radius), time);
+                    break;
+                }
+                case CollisionShapeType::AABB: {
+                    const CollisionAABB &box = view.boxes[primitive.index];
+                    hit = BoxTime(sx, sy, sz, ix, iy, iz, L::Set1(box.min.x), L::Set1(box.min.y), L::Set1(box.min.z),
+                                  L::Set1(box.max.x), L::Set1(box.max.y), L::Set1(box.max.z), one, time);
+                    break;
+                }
+                default: {
+                    const CollisionCapsule &capsule = view.capsules[primitive.index];
+                    hit = CapsuleTime(MakeCapsuleLanes(capsule, capsule.radius), sx, sy, sz, dx, dy, dz, dd, time);
+                    break;
+                }
+                }
+
+                const Mask improve = L::And(hit, L::Less(time, best));
+                uint32_t mask = L::MoveMask(improve);
+                if (mask == 0) {
+                    continue;
+                }
+
+                best = L::Select(improve, time, best);
+                while (mask != 0) {
+                    const size_t lane = i + simd::CountTrailingZeros(mask);
+                    view.targets[lane] = primitive.index;
+                    view.types[lane] = primitive.type;
+                    mask &= mask - 1;
+                }
+            }
+        }
+
+        L::Store(view.times + i, best);
+    }
+}
@@ -0,0 +1,141 @@
+// Lane-generic segment/shape intersection tests shared by the collision kernels.
+//
+// No include guard: included by other per-instruction-set kernel files after
+// they declare the L, Float and Mask aliases, with AGL_SHAPE_TARGET set to the
+// matching target attribute. Segments are start + t * delta for t in [0, 1];
+// every test returns a hit mask and the earliest hit time per lane.
+
+// Ray/sphere root for segments start + t * delta, where m = start - center and
+// a = |delta|^2. Segments starting inside the sphere hit at time 0.
+AGL_SHAPE_TARGET inline Mask SphereTime(Float mx, Float my, Float mz, Float dx, Float dy, Float dz, Float a,
+                                        Float radiusSquared, Float &time) {
+    const Float zero = L::Set1(0.0f);
+    const Float one = L::Set1(1.0f);
+
+    const Float b = L::Add(L::Add(L::Mul(mx, dx), L::Mul(my, dy)), L::Mul(mz, dz));
+    const Float c = L::Sub(L::Add(L::Add(L::Mul(mx, mx), L::Mul(my, my)), L::Mul(mz, mz)), radiusSquared);
+    const Float discriminant = L::Sub(L::Mul(b, b), L::Mul(a, c));
+    const Float root = L::Sqrt(L::Max(discriminant, zero));
+
+    // a == 0 (stationary segment) yields NaN here, which fails every compare
+    const Float t = L::Div(L::Sub(L::Sub(zero, b), root), a);
+
+    const Mask inside = L::LessEqual(c, zero);
+    const Mask moving =
+        L::And(L::GreaterEqual(discriminant, zero), L::And(L::GreaterEqual(t, zero), L::LessEqual(t, one)));
+    time = L::Select(inside, zero, t);
+    return L::Or(inside, moving);
+}
+
+// Slab test against a box, clamped to [0, limit]; a segment starting inside the
+// box hits at time 0. inverseDelta holds 1 / delta per axis (+-infinity for 0).
+AGL_SHAPE_TARGET inline Mask BoxTime(Float sx, Float sy, Float sz, Float ix, Float iy, Float iz, Float minX,
+                                     Float minY, Float minZ, Float maxX, Float maxY, Float maxZ, Float limit,
+                                     Float &time) {
+    Float enter = L::Set1(0.0f);
+    Float exit = limit;
+
+    const Float x1 = L::Mul(L::Sub(minX, sx), ix);
+    const Float x2 = L::Mul(L::Sub(maxX, sx), ix);
+    enter = L::Max(enter, L::Min(x1, x2));
+    exit = L::Min(exit, L::Max(x1, x2));
+
+    const Float y1 = L::Mul(L::Sub(minY, sy), iy);
+    const Float y2 = L::Mul(L::Sub(maxY, sy), iy);
+    enter = L::Max(enter, L::Min(y1, y2));
+    exit = L::Min(exit, L::Max(y1, y2));
+
+    const Float z1 = L::Mul(L::Sub(minZ, sz), iz);
+    const Float z2 = L::Mul(L::Sub(maxZ, sz), iz);
+    enter = L::Max(enter, L::Min(z1, z2));
+    exit = L::Min(exit, L::Max(z1, z2));
+
+    time = enter;
+    return L::LessEqual(enter, exit);
+}
+
+// Keep the earlier of the current candidate and a new one
+AGL_SHAPE_TARGET inline void Earliest(Mask hit, Float time, Mask &bestHit, Float &bestTime) {
+    const Mask better = L::And(hit, L::Less(time, bestTime));
+    bestTime = L::Select(better, time, bestTime);
+    bestHit = L::Or(bestHit, hit);
+}
+
+// Capsule constants broadcast to every lane
+struct CapsuleLanes {
+    Float ax, ay, az;    // Start point
+    Float bax, bay, baz; // Axis (end - start)
+    Float baba;          // |axis|^2
+    Float radiusSquared;
+    Float radiusSquaredBaba;
+    bool hasAxis;
+};
+
+AGL_SHAPE_TARGET inline CapsuleLanes MakeCapsuleLanes(const CollisionCapsule &capsule, float radius) {
+    const glm::vec3 axis = capsule.end - capsule.start;
+    const float axisLengthSquared = glm::dot(axis, axis);
+
+    CapsuleLanes lanes;
+    lanes.ax = L::Set1(capsule.start.x);
+    lanes.ay = L::Set1(capsule.start.y);
+    lanes.az = L::Set1(capsule.start.z);
+    lanes.bax = L::Set1(axis.x);
+    lanes.bay = L::Set1(axis.y);
+    lanes.baz = L::Set1(axis.z);
+    lanes.baba = L::Set1(axisLengthSquared);
+    lanes.radiusSquared = L::Set1(radius * radius);
+    lanes.radiusSquaredBaba = L::Set1(radius * radius * axisLengthSquared);
+    lanes.hasAxis = axisLengthSquared > 0.0f;
+    return lanes;
+}
+
+// Capsule = cylinder body plus two end spheres; the earliest valid candidate wins.
+// dd is |delta|^2.
+AGL_SHAPE_TARGET inline Mask CapsuleTime(const CapsuleLanes &capsule, Float sx, Float sy, Float sz, Float dx,
+                                         Float dy, Float dz, Float dd, Float &time) {
+    const Float zero = L::Set1(0.0f);
+    const Float one = L::Set1(1.0f);
+
+    const Float oax = L::Sub(sx, capsule.ax);
+    const Float oay = L::Sub(sy, capsule.ay);
+    const Float oaz = L::Sub(sz, capsule.az);
+
+    Float bestTime = L::Set1(std::numeric_limits<float>::infinity());
+    Mask bestHit = L::Less(one, zero);
+
+    if (capsule.hasAxis) {
+        // Infinite cylinder around the axis, restricted to 0 <= y <= |axis|^2
+        // where y is the hit point projected onto the (unnormalized) axis
+        const Float bard = L::Add(L::Add(L::Mul(capsule.bax, dx), L::Mul(capsule.bay, dy)), L::Mul(capsule.baz, dz));
+        const Float baoa =
+            L::Add(L::Add(L::Mul(capsule.bax, oax), L::Mul(capsule.bay, oay)), L::Mul(capsule.baz, oaz));
+        const Float rdoa = L::Add(L::Add(L::Mul(dx, oax), L::Mul(dy, oay)), L::Mul(dz, oaz));
+        const Float oaoa = L::Add(L::Add(L::Mul(oax, oax), L::Mul(oay, oay)), L::Mul(oaz, oaz));
+
+        const Float a = L::Sub(L::Mul(capsule.baba, dd), L::Mul(bard, bard));
+        const Float b = L::Sub(L::Mul(capsule.baba, rdoa), L::Mul(baoa, bard));
+        const Float c = L::Sub(L::Sub(L::Mul(capsule.baba, oaoa), L::Mul(baoa, baoa)), capsule.radiusSquaredBaba);
+        const Float h = L::Sub(L::Mul(b, b), L::Mul(a, c));
+        const Float bodyTime = L::Div(L::Sub(L::Sub(zero, b), L::Sqrt(L::Max(h, zero))), a);
+        const Float y = L::Add(baoa, L::Mul(bodyTime, bard));
+
+        const Mask inRange = L::And(L::GreaterEqual(bodyTime, zero), L::LessEqual(bodyTime, one));
+        const Mask onBody = L::And(L::GreaterEqual(y, zero), L::LessEqual(y, capsule.baba));
+        const Mask bodyHit = L::And(L::And(L::GreaterEqual(h, zero), L::Greater(a, zero)), L::And(inRange, onBody));
+        const Mask inside =
+            L::And(L::LessEqual(c, zero), L::And(L::GreaterEqual(baoa, zero), L::LessEqual(baoa, capsule.baba)));
+
+        Earliest(L::Or(bodyHit, inside), L::Select(inside, zero, bodyTime), bestHit, bestTime);
+    }
+
+    Float capTime;
+    Mask capHit = SphereTime(oax, oay, oaz, dx, dy, dz, dd, capsule.radiusSquared, capTime);
+    Earliest(capHit, capTime, bestHit, bestTime);
+
+    capHit = SphereTime(L::Sub(oax, capsule.bax), L::Sub(oay, capsule.bay), L::Sub(oaz, capsule.baz), dx, dy, dz, dd,
+                        capsule.radiusSquared, capTime);
+    Earliest(capHit, capTime, bestHit, bestTime);
+
+    time = bestTime;
+    return bestHit;
+}
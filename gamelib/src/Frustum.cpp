@@ -0,0 +1,51 @@
+#include "Frustum.h"
+
+namespace agl {
+
+Frustum Frustum::FromMatrix(const glm::mat4 &viewProjection) {
+    // Rows of the matrix; glm stores columns, so m[column][row]
+    const glm::mat4 &m = viewProjection;
+    glm::vec4 row[4];
+    for (int r = 0; r < 4; ++r) {
+        row[r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+    }
+
+    // A clip space point is inside when -w <= x, y, z <= w
+    Frustum frustum;
+    frustum.planes[Left] = row[3] + row[0];
+    frustum.planes[Right] = row[3] - row[0];
+    frustum.planes[Bottom] = row[3] + row[1];
+    frustum.planes[Top] = row[3] - row[1];
+    frustum.planes[Near] = row[3] + row[2];
+    frustum.planes[Far] = row[3] - row[2];
+    for (glm::vec4 &plane : frustum.planes) {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) {
+            plane /= length;
+        }
+    }
+    return frustum;
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3 &center, float radius) const {
+    for (const glm::vec4 &plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::IntersectsBox(const glm::vec3 &min, const glm::vec3 &max) const {
+    for (const glm::vec4 &plane : planes) {
+        // The corner furthest along the plane normal is the last one to leave
+        const glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y,
+                               plane.z >= 0.0f ? max.z : min.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace agl
@@ -0,0 +1,80 @@
+#include "MemoryStats.h"
+
+#include <atomic>
+
+namespace agl {
+
+namespace {
+
+struct CategoryCounters {
+    std::atomic<size_t> current{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> released{0};
+};
+
+CategoryCounters s_counters[static_cast<size_t>(MemoryCategory::Count)];
+
+CategoryCounters &Counters(MemoryCategory category) {
+    return s_counters[static_cast<size_t>(category)];
+}
+
+} // namespace
+
+void MemoryStats::Allocate(MemoryCategory category, size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+
+    CategoryCounters &counters = Counters(category);
+    const size_t current = counters.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = counters.peak.load(std::memory_order_relaxed);
+    while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryStats::Free(MemoryCategory category, size_t bytes) {
+    if (bytes != 0) {
+        Counters(category).current.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+}
+
+void MemoryStats::Release(MemoryCategory category, size_t bytes) {
+    Free(category, bytes);
+    Counters(category).released.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+MemoryCategoryStats MemoryStats::Get(MemoryCategory category) {
+    const CategoryCounters &counters = Counters(category);
+    MemoryCategoryStats stats;
+    stats.current = counters.current.load(std::memory_order_relaxed);
+    stats.peak = counters.peak.load(std::memory_order_relaxed);
+    stats.released = counters.released.load(std::memory_order_relaxed);
+    return stats;
+}
+
+size_t MemoryStats::GetTotal() {
+    size_t total = 0;
+    for (const CategoryCounters &counters : s_counters) {
+        total += counters.current.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void MemoryStats::ResetPeaks() {
+    for (CategoryCounters &counters : s_counters) {
+        counters.peak.store(counters.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+const char *MemoryStats::GetCategoryName(MemoryCategory category) {
+    switch (category) {
+    case MemoryCategory::MeshCPU:
+        return "Mesh CPU";
+    case MemoryCategory::MeshGPU:
+        return "Mesh GPU";
+    default:
+        return "Unknown";
+    }
+}
+
+} // namespace agl
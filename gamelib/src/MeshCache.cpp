@@ -0,0 +1,456 @@
+#include "MeshCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace agl {
+
+static_assert(std::is_trivially_copyable<Vertex>::value, "Vertex is stored as raw bytes");
+static_assert(std::is_trivially_copyable<MeshLOD>::value, "MeshLOD is stored as raw bytes");
+static_assert(std::is_trivially_copyable<Meshlet>::value, "Meshlet is stored as raw bytes");
+static_assert(std::is_trivially_copyable<MeshCacheHeader>::value, "MeshCacheHeader is stored as raw bytes");
+
+namespace {
+
+constexpr uint32_t EndianMarker = 0x01020304u;
+
+size_t AlignUp(size_t value) {
+    return (value + MeshCacheAlignment - 1) / MeshCacheAlignment * MeshCacheAlignment;
+}
+
+size_t SectionIndex(MeshCacheSection section) {
+    return static_cast<size_t>(section);
+}
+
+} // namespace
+
+// ========== MeshCacheFile ==========
+
+MeshCacheFile::~MeshCacheFile() {
+    Close();
+}
+
+MeshCacheFile::MeshCacheFile(MeshCacheFile &&other) noexcept
+    : m_data(other.m_data), m_header(other.m_header), m_size(other.m_size) {
+#if defined(_WIN32)
+    m_fileHandle = other.m_fileHandle;
+    m_mappingHandle = other.m_mappingHandle;
+    other.m_fileHandle = nullptr;
+    other.m_mappingHandle = nullptr;
+#endif
+    other.m_data = nullptr;
+    other.m_header = nullptr;
+    other.m_size = 0;
+}
+
+MeshCacheFile &MeshCacheFile::operator=(MeshCacheFile &&other) noexcept {
+    if (this != &other) {
+        Close();
+        m_data = other.m_data;
+        m_header = other.m_header;
+        m_size = other.m_size;
+#if defined(_WIN32)
+        m_fileHandle = other.m_fileHandle;
+        m_mappingHandle = other.m_mappingHandle;
+        other.m_fileHandle = nullptr;
+        other.m_mappingHandle = nullptr;
+#endif
+        other.m_data = nullptr;
+        other.m_header = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+bool MeshCacheFile::Open(const std::string &filepath) {
+    Close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(MeshCacheHeader))) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = static_cast<const uint8_t *>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(MeshCacheHeader))) {
+        close(fd);
+        return false;
+    }
+    void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file alive
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    // Start reading the whole file ahead, as the upload touches every page in order
+    posix_madvise(view, static_cast<size_t>(info.st_size), POSIX_MADV_WILLNEED);
+    m_data = static_cast<const uint8_t *>(view);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+
+    m_header = reinterpret_cast<const MeshCacheHeader *>(m_data);
+    if (!Validate()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MeshCacheFile::Close() {
+    if (m_data != nullptr) {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+        m_mappingHandle = nullptr;
+        m_fileHandle = nullptr;
+#else
+        munmap(const_cast<uint8_t *>(m_data), m_size);
+#endif
+    }
+    m_data = nullptr;
+    m_header = nullptr;
+    m_size = 0;
+}
+
+bool MeshCacheFile::Validate() const {
+    const MeshCacheHeader &header = *m_header;
+    if (header.magic != MeshCacheMagic || header.version != MeshCacheVersion ||
+        header.headerSize != sizeof(MeshCacheHeader) || header.endianMarker != EndianMarker ||
+        header.vertexSize != sizeof(Vertex) ||
+        header.vertexFormat > static_cast<uint32_t>(VertexFormat::CompactQuantized)) {
+        return false;
+    }
+
+    for (const MeshCacheSectionRange &range : header.sections) {
+        if (range.size == 0) {
+            continue;
+        }
+        if (range.offset % MeshCacheAlignment != 0 || range.offset < sizeof(MeshCacheHeader) ||
+            range.offset > m_size || range.size > m_size - range.offset) {
+            return false;
+        }
+    }
+
+    // Section sizes must match the counts, so the GPU upload never reads past the mapping
+    const VertexFormat format = GetVertexFormat();
+    const uint64_t vertexCount = header.vertexCount;
+    const uint64_t totalIndices = static_cast<uint64_t>(header.indexCount) + header.lodIndexCount;
+    const uint64_t cpuVertexBytes = format == VertexFormat::Standard ? 0 : vertexCount * sizeof(Vertex);
+    const auto sizeOf = [&](MeshCacheSection section) { return header.sections[SectionIndex(section)].size; };
+    if (sizeOf(MeshCacheSection::GpuVertices) != vertexCount * agl::GetVertexStride(format) ||
+        sizeOf(MeshCacheSection::CpuVertices) != cpuVertexBytes ||
+        sizeOf(MeshCacheSection::Indices) != totalIndices * sizeof(uint32_t) ||
+        sizeOf(MeshCacheSection::LODs) != header.lodCount * sizeof(MeshLOD) ||
+        sizeOf(MeshCacheSection::Meshlets) != header.meshletCount * sizeof(Meshlet) ||
+        sizeOf(MeshCacheSection::Material) != sizeof(MeshCacheMaterial)) {
+        return false;
+    }
+
+    // Index values are not scanned; that would read the whole file on open
+    const MeshLOD *lods = GetLODs();
+    for (uint32_t i = 0; i < header.lodCount; ++i) {
+        if (lods[i].firstIndex < header.indexCount ||
+            static_cast<uint64_t>(lods[i].firstIndex) + lods[i].indexCount > totalIndices) {
+            return false;
+        }
+    }
+    const Meshlet *meshlets = GetMeshlets();
+    for (uint32_t i = 0; i < header.meshletCount; ++i) {
+        if (static_cast<uint64_t>(meshlets[i].firstIndex) + meshlets[i].indexCount > header.indexCount) {
+            return false;
+        }
+    }
+
+    const size_t stringsSize = GetSectionSize(MeshCacheSection::Strings);
+    if (stringsSize > 0 && static_cast<const char *>(GetSection(MeshCacheSection::Strings))[stringsSize - 1] != '\0') {
+        return false;
+    }
+    return true;
+}
+
+const void *MeshCacheFile::GetSection(MeshCacheSection section) const {
+    const MeshCacheSectionRange &range = m_header->sections[SectionIndex(section)];
+    return range.size > 0 ? m_data + range.offset : nullptr;
+}
+
+size_t MeshCacheFile::GetSectionSize(MeshCacheSection section) const {
+    return static_cast<size_t>(m_header->sections[SectionIndex(section)].size);
+}
+
+const Vertex *MeshCacheFile::GetVertices() const {
+    const MeshCacheSection section =
+        GetVertexFormat() == VertexFormat::Standard ? MeshCacheSection::GpuVertices : MeshCacheSection::CpuVertices;
+    return static_cast<const Vertex *>(GetSection(section));
+}
+
+std::string MeshCacheFile::GetString(uint32_t offset) const {
+    if (offset == MeshCacheNoString || offset >= GetSectionSize(MeshCacheSection::Strings)) {
+        return std::string();
+    }
+    return std::string(static_cast<const char *>(GetSection(MeshCacheSection::Strings)) + offset);
+}
+
+// ========== MeshCache ==========
+
+bool MeshCache::Write(const Mesh &mesh, const std::string &filepath, const MeshCacheTextures &textures) {
+    if (!mesh.RequireCPUData("MeshCache::Write") || mesh.m_vertices.empty()) {
+        return false;
+    }
+
+    MeshCacheHeader header{};
+    header.magic = MeshCacheMagic;
+    header.version = MeshCacheVersion;
+    header.headerSize = sizeof(MeshCacheHeader);
+    header.endianMarker = EndianMarker;
+    header.vertexSize = sizeof(Vertex);
+    header.vertexFormat = static_cast<uint32_t>(mesh.m_vertexFormat);
+    header.vertexCount = static_cast<uint32_t>(mesh.m_vertices.size());
+    header.indexCount = static_cast<uint32_t>(mesh.m_indices.size());
+    header.lodIndexCount = static_cast<uint32_t>(mesh.m_lodIndices.size());
+    header.lodCount = static_cast<uint32_t>(mesh.m_lods.size());
+    header.meshletCount = static_cast<uint32_t>(mesh.m_meshlets.size());
+
+    const auto [boundsMin, boundsMax] = mesh.GetBoundingBox();
+    std::memcpy(header.boundsMin, &boundsMin, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, &boundsMax, sizeof(header.boundsMax));
+    const BoundingSphere sphere = mesh.GetBoundingSphere();
+    std::memcpy(header.boundingSphere, &sphere.center, sizeof(float) * 3);
+    header.boundingSphere[3] = sphere.radius;
+    std::memcpy(header.quantizationMin, &mesh.m_quantizationMin, sizeof(header.quantizationMin));
+    std::memcpy(header.quantizationMax, &mesh.m_quantizationMax, sizeof(header.quantizationMax));
+
+    // Texture paths go into the string table
+    std::string strings;
+    auto addString = [&strings](const std::string &value) {
+        if (value.empty()) {
+            return MeshCacheNoString;
+        }
+        const uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(value);
+        strings.push_back('\0');
+        return offset;
+    };
+
+    const Material &source = mesh.m_material;
+    MeshCacheMaterial material{};
+    std::memcpy(material.ambient, &source.ambient, sizeof(material.ambient));
+    std::memcpy(material.diffuse, &source.diffuse, sizeof(material.diffuse));
+    std::memcpy(material.specular, &source.specular, sizeof(material.specular));
+    material.shininess = source.shininess;
+    material.diffuseTexture = addString(textures.diffuse);
+    material.specularTexture = addString(textures.specular);
+    material.normalTexture = addString(textures.normal);
+
+    // Compact formats store the packed stream for the GPU and the full records for the CPU copy
+    const size_t vertexCount = mesh.m_vertices.size();
+    std::vector<uint8_t> packed;
+    const void *gpuVertices = mesh.m_vertices.data();
+    if (mesh.m_vertexFormat != VertexFormat::Standard) {
+        packed.resize(vertexCount * mesh.GetVertexStride());
+        PackVertices(mesh.m_vertices.data(), vertexCount, mesh.m_vertexFormat, mesh.m_quantizationMin,
+                     mesh.m_quantizationMax, packed.data());
+        gpuVertices = packed.data();
+    }
+
+    struct Source {
+        const void *data;
+        size_t size;
+    };
+    const size_t indexBytes = mesh.m_indices.size() * sizeof(uint32_t);
+    const Source sources[static_cast<size_t>(MeshCacheSection::Count)] = {
+        {gpuVertices, vertexCount * mesh.GetVertexStride()},
+        {mesh.m_vertices.data(), packed.empty() ? 0 : vertexCount * sizeof(Vertex)},
+        {nullptr, indexBytes + mesh.m_lodIndices.size() * sizeof(uint32_t)}, // Two parts, written below
+        {mesh.m_lods.data(), mesh.m_lods.size() * sizeof(MeshLOD)},
+        {mesh.m_meshlets.data(), mesh.m_meshlets.size() * sizeof(Meshlet)},
+        {&material, sizeof(MeshCacheMaterial)},
+        {strings.data(), strings.size()},
+    };
+
+    size_t offset = AlignUp(sizeof(MeshCacheHeader));
+    for (size_t i = 0; i < static_cast<size_t>(MeshCacheSection::Count); ++i) {
+        header.sections[i].offset = sources[i].size > 0 ? offset : 0;
+        header.sections[i].size = sources[i].size;
+        offset = AlignUp(offset + sources[i].size);
+    }
+
+    std::vector<uint8_t> file(offset, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    for (size_t i = 0; i < static_cast<size_t>(MeshCacheSection::Count); ++i) {
+        if (sources[i].data != nullptr && sources[i].size > 0) {
+            std::memcpy(file.data() + header.sections[i].offset, sources[i].data, sources[i].size);
+        }
+    }
+    uint8_t *indices = file.data() + header.sections[SectionIndex(MeshCacheSection::Indices)].offset;
+    if (!mesh.m_indices.empty()) {
+        std::memcpy(indices, mesh.m_indices.data(), indexBytes);
+    }
+    if (!mesh.m_lodIndices.empty()) {
+        std::memcpy(indices + indexBytes, mesh.m_lodIndices.data(), mesh.m_lodIndices.size() * sizeof(uint32_t));
+    }
+
+    // Write next to the target and rename, so readers never map a half-written file
+    const std::string temporary = filepath + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            std::cerr << "Failed to write mesh cache: " << filepath << std::endl;
+            return false;
+        }
+        stream.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!stream) {
+            std::cerr << "Failed to write mesh cache: " << filepath << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    // Both replace an existing cache in one step; std::rename cannot on Windows
+#if defined(_WIN32)
+    const bool replaced = MoveFileExA(temporary.c_str(), filepath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool replaced = std::rename(temporary.c_str(), filepath.c_str()) == 0;
+#endif
+    if (!replaced) {
+        std::cerr << "Failed to write mesh cache: " << filepath << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MeshCache::Load(const std::string &filepath, Mesh &mesh) {
+    MeshCacheFile file;
+    if (!file.Open(filepath)) {
+        return false;
+    }
+    const MeshCacheHeader &header = file.GetHeader();
+    if (header.vertexCount == 0) {
+        return false;
+    }
+
+    // The GPU buffers are filled straight from the mapping, so only the CPU copies the mesh's residency
+    // policy keeps are made: everything for KeepAll, positions and indices for PositionsOnly, nothing for GpuOnly
+    const Vertex *vertices = file.GetVertices();
+    const uint32_t *indices = file.GetIndices();
+    const MeshResidency residency = mesh.m_residency;
+    if (residency == MeshResidency::KeepAll) {
+        mesh.m_vertices.assign(vertices, vertices + header.vertexCount);
+    } else {
+        std::vector<Vertex>().swap(mesh.m_vertices);
+    }
+    if (residency == MeshResidency::PositionsOnly) {
+        mesh.m_positions.resize(header.vertexCount);
+        for (size_t i = 0; i < header.vertexCount; ++i) {
+            mesh.m_positions[i] = vertices[i].position;
+        }
+    } else {
+        std::vector<glm::vec3>().swap(mesh.m_positions);
+    }
+    if (indices != nullptr && residency != MeshResidency::GpuOnly) {
+        mesh.m_indices.assign(indices, indices + header.indexCount);
+    } else {
+        std::vector<uint32_t>().swap(mesh.m_indices);
+    }
+    if (indices != nullptr && residency == MeshResidency::KeepAll) {
+        mesh.m_lodIndices.assign(indices + header.indexCount, indices + header.indexCount + header.lodIndexCount);
+    } else {
+        std::vector<uint32_t>().swap(mesh.m_lodIndices);
+    }
+    mesh.m_vertexCount = header.vertexCount;
+    mesh.m_indexCount = indices != nullptr ? header.indexCount : 0;
+    mesh.m_cpuDataReleased = residency != MeshResidency::KeepAll;
+    if (mesh.m_sharedGeometry) {
+        mesh.m_sharedGeometry.reset();
+        mesh.m_EBO.reset();
+    }
+    mesh.m_lods.assign(file.GetLODs(), file.GetLODs() + header.lodCount);
+    mesh.m_activeLOD = 0;
+    mesh.m_meshlets.assign(file.GetMeshlets(), file.GetMeshlets() + header.meshletCount);
+    mesh.InvalidateAdjacency();
+
+    mesh.m_vertexFormat = file.GetVertexFormat();
+    std::memcpy(&mesh.m_quantizationMin, header.quantizationMin, sizeof(header.quantizationMin));
+    std::memcpy(&mesh.m_quantizationMax, header.quantizationMax, sizeof(header.quantizationMax));
+
+    std::memcpy(&mesh.m_boundsMin, header.boundsMin, sizeof(header.boundsMin));
+    std::memcpy(&mesh.m_boundsMax, header.boundsMax, sizeof(header.boundsMax));
+    std::memcpy(&mesh.m_boundsCenter, header.boundingSphere, sizeof(float) * 3);
+    mesh.m_boundsRadius = header.boundingSphere[3];
+
+    const MeshCacheMaterial &stored = *file.GetMaterial();
+    Material material;
+    std::memcpy(&material.ambient, stored.ambient, sizeof(stored.ambient));
+    std::memcpy(&material.diffuse, stored.diffuse, sizeof(stored.diffuse));
+    std::memcpy(&material.specular, stored.specular, sizeof(stored.specular));
+    material.shininess = stored.shininess;
+    auto loadTexture = [&file](uint32_t offset) -> std::shared_ptr<Texture> {
+        const std::string path = file.GetString(offset);
+        return path.empty() ? nullptr : TextureManager::Instance().LoadTexture(path, path);
+    };
+    material.diffuseTexture = loadTexture(stored.diffuseTexture);
+    material.specularTexture = loadTexture(stored.specularTexture);
+    material.normalTexture = loadTexture(stored.normalTexture);
+    mesh.m_material = material;
+
+    const size_t gpuIndexCount = indices != nullptr ? static_cast<size_t>(header.indexCount) + header.lodIndexCount : 0;
+    mesh.UploadGeometry(file.GetSection(MeshCacheSection::GpuVertices), indices, gpuIndexCount);
+    mesh.m_VAO->Unbind();
+    return true;
+}
+
+Mesh MeshCache::LoadOrBuild(const std::string &filepath, const std::function<Mesh()> &build,
+                            const MeshCacheTextures &textures) {
+    Mesh mesh;
+    if (Load(filepath, mesh)) {
+        return mesh;
+    }
+
+    mesh = build();
+    Write(mesh, filepath, textures);
+    return mesh;
+}
+
+} // namespace agl
@@ -0,0 +1,167 @@
+#include "MeshKernels.h"
+#include "SimdLanes.h"
+#include <algorithm>
+
+namespace agl {
+namespace kernels {
+
+namespace {
+
+// Triangles transposed per pass; large enough that the vector loads never wait
+// on the scalar stores that filled the block, small enough to stay in L1
+constexpr size_t BlockTriangles = 256;
+
+/**
+ * @brief Corners of a block of triangles in structure-of-arrays form: [corner][component][triangle]
+ */
+struct TriangleBlock {
+    float position[3][3][BlockTriangles];
+    float texCoord[3][2][BlockTriangles];
+};
+
+// Gathering is scalar: vertices are interleaved records, so there is nothing
+// to gain from vector loads. Triangles with an out-of-range index collapse onto
+// vertex 0, which makes every kernel produce zero vectors for them.
+void GatherTriangles(const MeshTriangleView &mesh, size_t first, size_t count, bool texCoords, TriangleBlock &block) {
+    const size_t vertexCount = mesh.vertexCount;
+    for (size_t lane = 0; lane < count; ++lane) {
+        const size_t triangle = first + lane;
+        size_t a = triangle * 3;
+        size_t b = a + 1;
+        size_t c = a + 2;
+        if (mesh.indices) {
+            a = mesh.indices[a];
+            b = mesh.indices[b];
+            c = mesh.indices[c];
+        }
+        if (a >= vertexCount || b >= vertexCount || c >= vertexCount) {
+            a = b = c = 0;
+        }
+
+        const float *pa = mesh.positions + a * mesh.stride;
+        const float *pb = mesh.positions + b * mesh.stride;
+        const float *pc = mesh.positions + c * mesh.stride;
+        for (int axis = 0; axis < 3; ++axis) {
+            block.position[0][axis][lane] = pa[axis];
+            block.position[1][axis][lane] = pb[axis];
+            block.position[2][axis][lane] = pc[axis];
+        }
+        if (texCoords) {
+            const float *ta = mesh.texCoords + a * mesh.stride;
+            const float *tb = mesh.texCoords + b * mesh.stride;
+            const float *tc = mesh.texCoords + c * mesh.stride;
+            for (int axis = 0; axis < 2; ++axis) {
+                block.texCoord[0][axis][lane] = ta[axis];
+                block.texCoord[1][axis][lane] = tb[axis];
+                block.texCoord[2][axis][lane] = tc[axis];
+            }
+        }
+    }
+}
+
+namespace scalar {
+#define AGL_MESH_LANES simd::ScalarLanes
+#define AGL_MESH_TARGET
+#include "MeshTangentSpaceKernels.h"
+#undef AGL_MESH_LANES
+#undef AGL_MESH_TARGET
+} // namespace scalar
+
+#if defined(AGL_SIMD_X86)
+
+namespace sse2 {
+#define AGL_MESH_LANES simd::SSE2Lanes
+#define AGL_MESH_TARGET AGL_TARGET_SSE2
+#include "MeshTangentSpaceKernels.h"
+#undef AGL_MESH_LANES
+#undef AGL_MESH_TARGET
+} // namespace sse2
+
+namespace avx2 {
+#define AGL_MESH_LANES simd::AVX2Lanes
+#define AGL_MESH_TARGET AGL_TARGET_AVX2
+#include "MeshTangentSpaceKernels.h"
+#undef AGL_MESH_LANES
+#undef AGL_MESH_TARGET
+} // namespace avx2
+
+#endif // AGL_SIMD_X86
+
+} // namespace
+
+void ComputeTriangleNormals(const MeshTriangleView &mesh, size_t begin, size_t end, float *x, float *y, float *z) {
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        avx2::TriangleNormals(mesh, begin, end, x, y, z);
+        break;
+    case simd::InstructionSet::SSE2:
+        sse2::TriangleNormals(mesh, begin, end, x, y, z);
+        break;
+#endif
+    default:
+        scalar::TriangleNormals(mesh, begin, end, x, y, z);
+        break;
+    }
+}
+
+void ComputeTriangleTangents(const MeshTriangleView &mesh, size_t begin, size_t end, float *tx, float *ty, float *tz,
+                             float *bx, float *by, float *bz) {
+    float *const out[6] = {tx, ty, tz, bx, by, bz};
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        avx2::TriangleTangents(mesh, begin, end, out);
+        break;
+    case simd::InstructionSet::SSE2:
+        sse2::TriangleTangents(mesh, begin, end, out);
+        break;
+#endif
+    default:
+        scalar::TriangleTangents(mesh, begin, end, out);
+        break;
+    }
+}
+
+void GatherVertexVectors(const VertexTriangleAdjacency &adjacency, const float *triangleX, const float *triangleY,
+                         const float *triangleZ, size_t begin, size_t end, float *x, float *y, float *z) {
+    for (size_t v = begin; v < end; ++v) {
+        float sumX = 0.0f;
+        float sumY = 0.0f;
+        float sumZ = 0.0f;
+        if (adjacency.offsets) {
+            for (uint32_t i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i) {
+                const uint32_t triangle = adjacency.triangles[i];
+                sumX += triangleX[triangle];
+                sumY += triangleY[triangle];
+                sumZ += triangleZ[triangle];
+            }
+        } else if (v / 3 < adjacency.triangleCount) {
+            sumX = triangleX[v / 3];
+            sumY = triangleY[v / 3];
+            sumZ = triangleZ[v / 3];
+        }
+        x[v] = sumX;
+        y[v] = sumY;
+        z[v] = sumZ;
+    }
+}
+
+void NormalizeVectors(float *x, float *y, float *z, size_t begin, size_t end) {
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        avx2::Normalize(x, y, z, begin, end);
+        break;
+    case simd::InstructionSet::SSE2:
+        sse2::Normalize(x, y, z, begin, end);
+        break;
+#endif
+    default:
+        scalar::Normalize(x, y, z, begin, end);
+        break;
+    }
+}
+
+} // namespace kernels
+} // namespace agl
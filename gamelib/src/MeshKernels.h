@@ -0,0 +1,73 @@
+#ifndef MESH_KERNELS_H
+#define MESH_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace agl {
+namespace kernels {
+
+/**
+ * @brief Strided view of a mesh's triangles
+ *
+ * Triangles whose indices reach past vertexCount are treated as degenerate and
+ * produce zero vectors.
+ */
+struct MeshTriangleView {
+    const float *positions;  // xyz of vertex 0
+    const float *texCoords;  // uv of vertex 0 (tangents only)
+    size_t stride;           // Floats from one vertex to the next
+    const uint32_t *indices; // Three per triangle, or null for consecutive vertex triples
+    size_t vertexCount;
+};
+
+/**
+ * @brief Vertex-to-triangle adjacency in compressed rows
+ *
+ * The triangles of vertex v are triangles[offsets[v]] .. triangles[offsets[v + 1] - 1],
+ * in ascending order. Null offsets mean a non-indexed mesh, where vertex v only
+ * belongs to triangle v / 3.
+ */
+struct VertexTriangleAdjacency {
+    const uint32_t *offsets;
+    const uint32_t *triangles;
+    size_t triangleCount;
+};
+
+/**
+ * @brief Unit normals of triangles [begin, end), written to x/y/z[triangle]
+ *
+ * Degenerate triangles get a zero normal. Uses the instruction set reported by
+ * simd::GetInstructionSet(); every path and every split of the range produces
+ * identical results.
+ */
+void ComputeTriangleNormals(const MeshTriangleView &mesh, size_t begin, size_t end, float *x, float *y, float *z);
+
+/**
+ * @brief Texture-space tangents and bitangents of triangles [begin, end)
+ *
+ * Not normalized, matching the classic per-triangle solution of the UV
+ * gradient; triangles with degenerate texture coordinates get zero vectors.
+ * Same determinism guarantees as ComputeTriangleNormals().
+ */
+void ComputeTriangleTangents(const MeshTriangleView &mesh, size_t begin, size_t end, float *tx, float *ty, float *tz,
+                             float *bx, float *by, float *bz);
+
+/**
+ * @brief Sum the triangle vectors around vertices [begin, end) in adjacency order
+ *
+ * The fixed summation order makes the result independent of how the vertex
+ * range is split across threads.
+ */
+void GatherVertexVectors(const VertexTriangleAdjacency &adjacency, const float *triangleX, const float *triangleY,
+                         const float *triangleZ, size_t begin, size_t end, float *x, float *y, float *z);
+
+/**
+ * @brief Normalize vectors [begin, end) in place, leaving zero vectors at zero
+ */
+void NormalizeVectors(float *x, float *y, float *z, size_t begin, size_t end);
+
+} // namespace kernels
+} // namespace agl
+
+#endif // MESH_KERNELS_H
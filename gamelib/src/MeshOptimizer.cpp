@@ -0,0 +1,402 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+namespace agl {
+
+namespace {
+
+constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+// ========== Forsyth scoring ==========
+
+// Constants from Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+constexpr uint32_t ForsythCacheSize = 32;
+constexpr uint32_t ForsythMaxValence = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+/**
+ * @brief Precomputed vertex score terms, indexed by cache position and remaining valence
+ */
+struct ForsythScoreTable {
+    float cache[ForsythCacheSize + 1]; // Last entry: not in cache
+    float valence[ForsythMaxValence + 1];
+
+    ForsythScoreTable() {
+        for (uint32_t i = 0; i < ForsythCacheSize; ++i) {
+            if (i < 3) {
+                // The last triangle's vertices score the same regardless of order
+                cache[i] = LastTriangleScore;
+            } else {
+                const float scale = 1.0f / (ForsythCacheSize - 3);
+                cache[i] = std::pow(1.0f - (i - 3) * scale, CacheDecayPower);
+            }
+        }
+        cache[ForsythCacheSize] = 0.0f;
+
+        valence[0] = 0.0f;
+        for (uint32_t i = 1; i <= ForsythMaxValence; ++i) {
+            valence[i] = ValenceBoostScale * std::pow(static_cast<float>(i), -ValenceBoostPower);
+        }
+    }
+
+    float Score(uint32_t cachePosition, uint32_t remainingTriangles) const {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+        return cache[std::min(cachePosition, ForsythCacheSize)] +
+               valence[std::min(remainingTriangles, ForsythMaxValence)];
+    }
+};
+
+// ========== Welding ==========
+
+uint64_t HashVertex(const Vertex &vertex) {
+    // FNV-1a over the raw bytes; Vertex is 14 tightly packed floats
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&vertex);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < sizeof(Vertex); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static_assert(sizeof(Vertex) == 14 * sizeof(float), "Vertex welding hashes raw bytes and needs no padding");
+
+void MakeIndicesIfNeeded(const std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+    if (indices.empty()) {
+        indices.resize(vertices.size());
+        std::iota(indices.begin(), indices.end(), 0u);
+    }
+}
+
+} // namespace
+
+// ========== Passes ==========
+
+MeshOptimizerStats MeshOptimizer::Optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+                                           const MeshOptimizerSettings &settings) {
+    MakeIndicesIfNeeded(vertices, indices);
+
+    MeshOptimizerStats stats;
+    stats.verticesBefore = vertices.size();
+    stats.cacheBefore = AnalyzeVertexCache(indices, vertices.size(), settings.analysisCacheSize);
+
+    if (settings.weldVertices) {
+        WeldVertices(vertices, indices);
+    }
+    if (settings.optimizeVertexCache) {
+        OptimizeVertexCache(indices, vertices.size());
+    }
+    if (settings.optimizeOverdraw) {
+        OptimizeOverdraw(indices, vertices, settings.overdrawThreshold);
+    }
+    if (settings.optimizeVertexFetch) {
+        OptimizeVertexFetch(vertices, indices);
+    }
+
+    stats.verticesAfter = vertices.size();
+    stats.cacheAfter = AnalyzeVertexCache(indices, vertices.size(), settings.analysisCacheSize);
+    return stats;
+}
+
+MeshOptimizerStats MeshOptimizer::Optimize(Mesh &mesh, const MeshOptimizerSettings &settings) {
+    if (!mesh.HasCPUData()) {
+        std::cerr << "MeshOptimizer::Optimize needs the CPU vertices, which the mesh does not keep" << std::endl;
+        return MeshOptimizerStats();
+    }
+
+    std::vector<Vertex> vertices = mesh.GetVertices();
+    std::vector<uint32_t> indices = mesh.GetIndices();
+    const MeshOptimizerStats stats = Optimize(vertices, indices, settings);
+    mesh.SetGeometry(std::move(vertices), std::move(indices));
+    return stats;
+}
+
+size_t MeshOptimizer::WeldVertices(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+    MakeIndicesIfNeeded(vertices, indices);
+
+    // Open addressing table of unique vertex indices, at most half full
+    size_t tableSize = 16;
+    while (tableSize < vertices.size() * 2) {
+        tableSize *= 2;
+    }
+    std::vector<uint32_t> table(tableSize, InvalidIndex);
+
+    std::vector<uint32_t> remap(vertices.size());
+    size_t uniqueCount = 0;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        size_t slot = HashVertex(vertices[i]) & (tableSize - 1);
+        while (table[slot] != InvalidIndex && std::memcmp(&vertices[table[slot]], &vertices[i], sizeof(Vertex)) != 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+
+        if (table[slot] == InvalidIndex) {
+            // Unique vertices are compacted in place; slot entries always point below i
+            vertices[uniqueCount] = vertices[i];
+            table[slot] = static_cast<uint32_t>(uniqueCount++);
+        }
+        remap[i] = table[slot];
+    }
+
+    vertices.resize(uniqueCount);
+    for (uint32_t &index : indices) {
+        index = remap[index];
+    }
+    return uniqueCount;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    static const ForsythScoreTable scores;
+
+    // Vertex to triangle adjacency; each vertex's live triangles stay at the front of its range
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        remaining[indices[i]]++;
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (size_t k = 0; k < 3; ++k) {
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+            }
+        }
+    }
+
+    std::vector<uint32_t> cachePosition(vertexCount, ForsythCacheSize);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScores[v] = scores.Score(ForsythCacheSize, remaining[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    uint32_t best = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                            vertexScores[indices[t * 3 + 2]];
+        if (triangleScores[t] > triangleScores[best]) {
+            best = static_cast<uint32_t>(t);
+        }
+    }
+
+    // Cache holds up to three entries past its size, which are evicted after each step
+    uint32_t cache[ForsythCacheSize + 3];
+    uint32_t newCache[ForsythCacheSize + 3];
+    uint32_t cacheCount = 0;
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    size_t cursor = 0;
+
+    for (size_t step = 0; step < triangleCount; ++step) {
+        if (best == InvalidIndex) {
+            // Nothing in the cache has triangles left; continue with the next unused triangle
+            while (emitted[cursor]) {
+                ++cursor;
+            }
+            best = static_cast<uint32_t>(cursor);
+        }
+
+        emitted[best] = 1;
+        const uint32_t *triangle = &indices[best * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+
+        uint32_t newCount = 0;
+        for (size_t k = 0; k < 3; ++k) {
+            const uint32_t v = triangle[k];
+            newCache[newCount++] = v;
+
+            // Remove the triangle from the vertex's live range
+            uint32_t *begin = &adjacency[offsets[v]];
+            uint32_t *end = begin + remaining[v];
+            *std::find(begin, end, best) = *(end - 1);
+            remaining[v]--;
+        }
+        for (uint32_t i = 0; i < cacheCount; ++i) {
+            const uint32_t v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                newCache[newCount++] = v;
+            }
+        }
+
+        // Rescore the cache (including evicted entries) and every triangle that touches it
+        best = InvalidIndex;
+        float bestScore = -1.0f;
+        for (uint32_t i = 0; i < newCount; ++i) {
+            const uint32_t v = newCache[i];
+            cachePosition[v] = i < ForsythCacheSize ? i : ForsythCacheSize;
+            vertexScores[v] = scores.Score(cachePosition[v], remaining[v]);
+        }
+        for (uint32_t i = 0; i < newCount; ++i) {
+            const uint32_t v = newCache[i];
+            for (uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; ++j) {
+                const uint32_t t = adjacency[j];
+                triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                    vertexScores[indices[t * 3 + 2]];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, ForsythCacheSize);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<Vertex> &vertices,
+                                     float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // Cut clusters where a cold cache start costs at most threshold times the overall ACMR
+    constexpr uint32_t CacheSize = 16;
+    const float targetAcmr = threshold * AnalyzeVertexCache(indices, vertices.size(), CacheSize).acmr;
+
+    std::vector<uint32_t> clusterStarts;
+    std::vector<uint32_t> cacheStamps(vertices.size(), 0);
+    uint32_t time = CacheSize + 1;
+    uint32_t clusterMisses = 0;
+    uint32_t clusterTriangles = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        if (t == 0 || clusterMisses <= targetAcmr * clusterTriangles) {
+            // Start a new cluster with a cold cache, since it may end up anywhere in the order
+            clusterStarts.push_back(static_cast<uint32_t>(t));
+            time += CacheSize + 1;
+            clusterMisses = 0;
+            clusterTriangles = 0;
+        }
+
+        for (size_t k = 0; k < 3; ++k) {
+            const uint32_t v = indices[t * 3 + k];
+            if (time - cacheStamps[v] > CacheSize) {
+                cacheStamps[v] = time++;
+                clusterMisses++;
+            }
+        }
+        clusterTriangles++;
+    }
+    clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+    const size_t clusterCount = clusterStarts.size() - 1;
+    if (clusterCount < 2) {
+        return;
+    }
+
+    // Area-weighted centroid and normal of each cluster and of the whole mesh
+    std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+    std::vector<float> clusterAreas(clusterCount, 0.0f);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+            const glm::vec3 &a = vertices[indices[t * 3]].position;
+            const glm::vec3 &b = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3 &p = vertices[indices[t * 3 + 2]].position;
+            const glm::vec3 normal = glm::cross(b - a, p - a);
+            const float area = glm::length(normal);
+            clusterCentroids[c] += (a + b + p) * (area / 3.0f);
+            clusterNormals[c] += normal;
+            clusterAreas[c] += area;
+        }
+        meshCentroid += clusterCentroids[c];
+        meshArea += clusterAreas[c];
+    }
+    if (meshArea <= 0.0f) {
+        return;
+    }
+    meshCentroid /= meshArea;
+
+    // Clusters facing away from the center are likely in front of the others from any view
+    std::vector<float> sortKeys(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        const float normalLength = glm::length(clusterNormals[c]);
+        if (clusterAreas[c] > 0.0f && normalLength > 0.0f) {
+            const glm::vec3 centroid = clusterCentroids[c] / clusterAreas[c];
+            sortKeys[c] = glm::dot(centroid - meshCentroid, clusterNormals[c] / normalLength);
+        }
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (uint32_t c : order) {
+        output.insert(output.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+    }
+    indices.swap(output);
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+    std::vector<uint32_t> remap(vertices.size(), InvalidIndex);
+    std::vector<Vertex> output;
+    output.reserve(vertices.size());
+
+    for (uint32_t &index : indices) {
+        if (remap[index] == InvalidIndex) {
+            remap[index] = static_cast<uint32_t>(output.size());
+            output.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices.swap(output);
+    return vertices.size();
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount,
+                                                   uint32_t cacheSize) {
+    VertexCacheStats stats;
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || cacheSize == 0) {
+        return stats;
+    }
+
+    // FIFO cache via insertion stamps: a vertex is cached while fewer than cacheSize misses followed it
+    std::vector<uint32_t> stamps(vertexCount, 0);
+    std::vector<uint8_t> used(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    size_t usedCount = 0;
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        const uint32_t v = indices[i];
+        if (time - stamps[v] > cacheSize) {
+            stamps[v] = time++;
+            stats.transformedVertices++;
+        }
+        if (!used[v]) {
+            used[v] = 1;
+            usedCount++;
+        }
+    }
+
+    stats.acmr = static_cast<float>(stats.transformedVertices) / triangleCount;
+    stats.atvr = static_cast<float>(stats.transformedVertices) / usedCount;
+    return stats;
+}
+
+} // namespace agl
@@ -0,0 +1,351 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace agl {
+
+namespace {
+
+constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+/**
+ * @brief Symmetric 4x4 error quadric, stored as its 10 unique coefficients
+ */
+struct Quadric {
+    double a00{0}, a01{0}, a02{0}, a11{0}, a12{0}, a22{0};
+    double b0{0}, b1{0}, b2{0};
+    double c{0};
+    double weight{0}; // Total area, to turn summed errors into a mean squared distance
+
+    void AddPlane(const glm::dvec3 &normal, double distance, double area) {
+        a00 += area * normal.x * normal.x;
+        a01 += area * normal.x * normal.y;
+        a02 += area * normal.x * normal.z;
+        a11 += area * normal.y * normal.y;
+        a12 += area * normal.y * normal.z;
+        a22 += area * normal.z * normal.z;
+        b0 += area * normal.x * distance;
+        b1 += area * normal.y * distance;
+        b2 += area * normal.z * distance;
+        c += area * distance * distance;
+        weight += area;
+    }
+
+    void Add(const Quadric &other) {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+    }
+
+    // Weighted sum of squared distances from p to the accumulated planes
+    double Evaluate(const glm::dvec3 &p) const {
+        const double rx = a00 * p.x + a01 * p.y + a02 * p.z + b0;
+        const double ry = a01 * p.x + a11 * p.y + a12 * p.z + b1;
+        const double rz = a02 * p.x + a12 * p.y + a22 * p.z + b2;
+        const double value = rx * p.x + ry * p.y + rz * p.z + b0 * p.x + b1 * p.y + b2 * p.z + c;
+        return std::max(value, 0.0);
+    }
+};
+
+struct Collapse {
+    uint32_t from; // Position ids
+    uint32_t to;
+    double cost; // Mean squared distance, in normalized units
+};
+
+uint64_t EdgeKey(uint32_t a, uint32_t b) {
+    return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+}
+
+} // namespace
+
+void MeshSimplifier::WeldPositions(const std::vector<Vertex> &vertices, std::vector<uint32_t> &positionOf,
+                                   std::vector<uint32_t> &nextWedge) {
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    positionOf.resize(vertexCount);
+    nextWedge.resize(vertexCount);
+    std::unordered_map<uint64_t, uint32_t> firstByHash;
+    firstByHash.reserve(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        // Adding zero folds -0 into +0, which compares equal but hashes differently
+        const glm::vec3 &p = vertices[i].position;
+        const float components[3] = {p.x + 0.0f, p.y + 0.0f, p.z + 0.0f};
+        uint32_t bits[3];
+        std::memcpy(bits, components, sizeof(bits));
+        const uint64_t hash = (bits[0] * 73856093ull) ^ (bits[1] * 19349663ull) ^ (bits[2] * 83492791ull);
+
+        // Chain through colliding hashes until the exact position is found
+        uint64_t key = hash;
+        positionOf[i] = i;
+        nextWedge[i] = i;
+        while (true) {
+            auto inserted = firstByHash.emplace(key, i);
+            if (inserted.second) {
+                break;
+            }
+            const uint32_t first = inserted.first->second;
+            if (vertices[first].position == p) {
+                positionOf[i] = first;
+                nextWedge[i] = nextWedge[first];
+                nextWedge[first] = i;
+                break;
+            }
+            key = key * 6364136223846793005ull + 1442695040888963407ull;
+        }
+    }
+}
+
+float MeshSimplifier::Simplify(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+                               size_t targetIndexCount, float maxError, std::vector<uint32_t> &result) {
+    result = indices;
+    const size_t vertexCount = vertices.size();
+    if (vertexCount == 0 || indices.size() < 3 || indices.size() <= targetIndexCount) {
+        return 0.0f;
+    }
+
+    // Work in a unit-sized frame so costs and limits are scale independent
+    glm::vec3 boundsMin = vertices[0].position;
+    glm::vec3 boundsMax = vertices[0].position;
+    for (const Vertex &vertex : vertices) {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+    }
+    const glm::vec3 extent = boundsMax - boundsMin;
+    const float largest = std::max(std::max(extent.x, extent.y), extent.z);
+    const double scale = largest > 0.0f ? 1.0 / largest : 1.0;
+    std::vector<glm::dvec3> positions(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        positions[i] = glm::dvec3(vertices[i].position - boundsMin) * scale;
+    }
+
+    // Position ids: the first vertex with each position, and a ring linking all vertices sharing it
+    std::vector<uint32_t> positionOf;
+    std::vector<uint32_t> nextWedge;
+    WeldPositions(vertices, positionOf, nextWedge);
+
+    // Plane quadrics of the original surface, gathered per position
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const glm::dvec3 &a = positions[indices[t]];
+        const glm::dvec3 &b = positions[indices[t + 1]];
+        const glm::dvec3 &c = positions[indices[t + 2]];
+        glm::dvec3 normal = glm::cross(b - a, c - a);
+        const double length = glm::length(normal);
+        if (length <= 0.0) {
+            continue;
+        }
+        normal /= length;
+        const double area = 0.5 * length;
+        for (size_t k = 0; k < 3; ++k) {
+            quadrics[positionOf[indices[t + k]]].AddPlane(normal, -glm::dot(normal, a), area);
+        }
+    }
+
+    const size_t targetTriangles = targetIndexCount / 3;
+    const double maxCost = static_cast<double>(maxError) * maxError;
+    double worstCost = 0.0;
+
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+    std::vector<uint32_t> triangleLists;
+    std::vector<uint8_t> locked(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint32_t> stamp(vertexCount);
+    uint32_t stampValue = 0;
+    std::vector<Collapse> collapses;
+    std::unordered_map<uint64_t, int32_t> edgeBalance;
+
+    while (result.size() / 3 > targetTriangles) {
+        const size_t triangleCount = result.size() / 3;
+
+        // Position to triangle adjacency of the current mesh
+        std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+        for (uint32_t index : result) {
+            triangleOffsets[positionOf[index] + 1]++;
+        }
+        for (size_t p = 0; p < vertexCount; ++p) {
+            triangleOffsets[p + 1] += triangleOffsets[p];
+        }
+        triangleLists.resize(result.size());
+        {
+            std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); ++i) {
+                triangleLists[fill[positionOf[result[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // An edge of a closed manifold is used once in each direction; lock anything else
+        edgeBalance.clear();
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (size_t k = 0; k < 3; ++k) {
+                const uint32_t a = positionOf[result[t * 3 + k]];
+                const uint32_t b = positionOf[result[t * 3 + (k + 1) % 3]];
+                // Low bits count uses, high bits track direction
+                edgeBalance[EdgeKey(a, b)] += (a < b ? 1 : 1 + (1 << 16));
+            }
+        }
+        std::fill(locked.begin(), locked.end(), 0);
+        for (const auto &edge : edgeBalance) {
+            if (edge.second != 2 + (1 << 16)) {
+                locked[edge.first >> 32] = 1;
+                locked[edge.first & 0xFFFFFFFFu] = 1;
+            }
+        }
+
+        // Cheaper direction of every collapsible edge
+        collapses.clear();
+        for (const auto &edge : edgeBalance) {
+            const uint32_t a = static_cast<uint32_t>(edge.first >> 32);
+            const uint32_t b = static_cast<uint32_t>(edge.first & 0xFFFFFFFFu);
+            if (locked[a] || locked[b]) {
+                continue;
+            }
+            Quadric combined = quadrics[a];
+            combined.Add(quadrics[b]);
+            const double weight = std::max(combined.weight, 1e-30);
+            const double costToB = combined.Evaluate(positions[b]) / weight;
+            const double costToA = combined.Evaluate(positions[a]) / weight;
+            collapses.push_back(costToB <= costToA ? Collapse{a, b, costToB} : Collapse{b, a, costToA});
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse &x, const Collapse &y) { return x.cost < y.cost; });
+
+        std::fill(touched.begin(), touched.end(), 0);
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            remap[i] = i;
+        }
+
+        size_t remainingTriangles = triangleCount;
+        size_t collapsed = 0;
+        for (const Collapse &collapse : collapses) {
+            if (remainingTriangles <= targetTriangles || collapse.cost > maxCost) {
+                break;
+            }
+            const uint32_t from = collapse.from;
+            const uint32_t to = collapse.to;
+            if (touched[from] || touched[to]) {
+                continue;
+            }
+
+            // The two rings may only share the vertices opposite the edge, or the collapse pinches the surface
+            ++stampValue;
+            for (uint32_t j = triangleOffsets[to]; j < triangleOffsets[to + 1]; ++j) {
+                for (size_t k = 0; k < 3; ++k) {
+                    stamp[positionOf[result[triangleLists[j] * 3 + k]]] = stampValue;
+                }
+            }
+            size_t shared = 0;
+            for (uint32_t j = triangleOffsets[from]; j < triangleOffsets[from + 1]; ++j) {
+                for (size_t k = 0; k < 3; ++k) {
+                    const uint32_t position = positionOf[result[triangleLists[j] * 3 + k]];
+                    if (position != from && position != to && stamp[position] == stampValue) {
+                        stamp[position] = 0;
+                        shared++;
+                    }
+                }
+            }
+            bool valid = shared == 2;
+
+            // Every used copy of 'from' needs a copy of 'to' it shares an edge with
+            uint32_t wedge = from;
+            do {
+                bool used = false;
+                uint32_t match = InvalidIndex;
+                for (uint32_t j = triangleOffsets[from]; j < triangleOffsets[from + 1] && match == InvalidIndex; ++j) {
+                    const uint32_t *triangle = &result[triangleLists[j] * 3];
+                    if (triangle[0] != wedge && triangle[1] != wedge && triangle[2] != wedge) {
+                        continue;
+                    }
+                    used = true;
+                    for (size_t k = 0; k < 3; ++k) {
+                        if (positionOf[triangle[k]] == to) {
+                            match = triangle[k];
+                        }
+                    }
+                }
+                if (used && match == InvalidIndex) {
+                    valid = false;
+                }
+                remap[wedge] = used ? match : wedge;
+                wedge = nextWedge[wedge];
+            } while (valid && wedge != from);
+
+            // Moving 'from' must not flip any triangle that survives the collapse
+            size_t removed = 0;
+            for (uint32_t j = triangleOffsets[from]; valid && j < triangleOffsets[from + 1]; ++j) {
+                const uint32_t *triangle = &result[triangleLists[j] * 3];
+                glm::dvec3 corners[3];
+                glm::dvec3 moved[3];
+                bool containsTarget = false;
+                for (size_t k = 0; k < 3; ++k) {
+                    const uint32_t position = positionOf[triangle[k]];
+                    containsTarget |= position == to;
+                    corners[k] = positions[position];
+                    moved[k] = position == from ? positions[to] : corners[k];
+                }
+                if (containsTarget) {
+                    removed++;
+                    continue;
+                }
+                const glm::dvec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                const glm::dvec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+                valid = glm::dot(before, after) > 0.0;
+            }
+
+            if (!valid) {
+                wedge = from;
+                do {
+                    remap[wedge] = wedge;
+                    wedge = nextWedge[wedge];
+                } while (wedge != from);
+                continue;
+            }
+
+            // Freeze the one-ring, as its triangles were checked against the current geometry
+            for (uint32_t j = triangleOffsets[from]; j < triangleOffsets[from + 1]; ++j) {
+                const uint32_t *triangle = &result[triangleLists[j] * 3];
+                for (size_t k = 0; k < 3; ++k) {
+                    touched[positionOf[triangle[k]]] = 1;
+                }
+            }
+
+            quadrics[to].Add(quadrics[from]);
+            worstCost = std::max(worstCost, collapse.cost);
+            remainingTriangles -= std::min(removed, remainingTriangles);
+            collapsed++;
+        }
+
+        if (collapsed == 0) {
+            break;
+        }
+
+        // Apply the collapses and drop triangles that became degenerate
+        size_t write = 0;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const uint32_t a = remap[result[t * 3]];
+            const uint32_t b = remap[result[t * 3 + 1]];
+            const uint32_t c = remap[result[t * 3 + 2]];
+            if (positionOf[a] == positionOf[b] || positionOf[b] == positionOf[c] || positionOf[a] == positionOf[c]) {
+                continue;
+            }
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    return static_cast<float>(std::sqrt(worstCost));
+}
+
+} // namespace agl
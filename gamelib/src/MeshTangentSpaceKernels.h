@@ -0,0 +1,118 @@
+// Triangle normal and tangent kernels, compiled once per instruction set.
+//
+// No include guard: MeshKernels.cpp includes this file once per lane wrapper,
+// inside a namespace named after the instruction set, with AGL_MESH_LANES set
+// to a simd::*Lanes type and AGL_MESH_TARGET to the matching target attribute.
+// Triangles are transposed a block at a time into TriangleBlock; whole groups
+// of L::Width lanes run vectorized and the rest of a block runs through the
+// same function body with simd::ScalarLanes, so every path performs the same
+// operations and the results do not depend on the path or on the split.
+
+using L = AGL_MESH_LANES;
+
+// Edge vectors p1 - p0 and p2 - p0 of lanes [i, i + Lanes::Width) of a block
+template <typename Lanes>
+struct TriangleEdges {
+    typename Lanes::Float e1x, e1y, e1z;
+    typename Lanes::Float e2x, e2y, e2z;
+};
+
+template <typename Lanes>
+AGL_MESH_TARGET inline TriangleEdges<Lanes> LoadEdges(const TriangleBlock &block, size_t i) {
+    TriangleEdges<Lanes> edges;
+    edges.e1x = Lanes::Sub(Lanes::Load(block.position[1][0] + i), Lanes::Load(block.position[0][0] + i));
+    edges.e1y = Lanes::Sub(Lanes::Load(block.position[1][1] + i), Lanes::Load(block.position[0][1] + i));
+    edges.e1z = Lanes::Sub(Lanes::Load(block.position[1][2] + i), Lanes::Load(block.position[0][2] + i));
+    edges.e2x = Lanes::Sub(Lanes::Load(block.position[2][0] + i), Lanes::Load(block.position[0][0] + i));
+    edges.e2y = Lanes::Sub(Lanes::Load(block.position[2][1] + i), Lanes::Load(block.position[0][1] + i));
+    edges.e2z = Lanes::Sub(Lanes::Load(block.position[2][2] + i), Lanes::Load(block.position[0][2] + i));
+    return edges;
+}
+
+// v / |v|, or v unchanged where |v| is zero
+template <typename Lanes, typename Float = typename Lanes::Float>
+AGL_MESH_TARGET inline void StoreNormalized(Float vx, Float vy, Float vz, float *x, float *y, float *z) {
+    const Float zero = Lanes::Set1(0.0f);
+    const Float one = Lanes::Set1(1.0f);
+    const Float lengthSquared = Lanes::Add(Lanes::Add(Lanes::Mul(vx, vx), Lanes::Mul(vy, vy)), Lanes::Mul(vz, vz));
+    const Float inverseLength = Lanes::Div(one, Lanes::Sqrt(lengthSquared));
+    const Float scale = Lanes::Select(Lanes::Greater(lengthSquared, zero), inverseLength, one);
+    Lanes::Store(x, Lanes::Mul(vx, scale));
+    Lanes::Store(y, Lanes::Mul(vy, scale));
+    Lanes::Store(z, Lanes::Mul(vz, scale));
+}
+
+template <typename Lanes>
+AGL_MESH_TARGET inline void NormalLanes(const TriangleBlock &block, size_t i, float *x, float *y, float *z) {
+    using Float = typename Lanes::Float;
+    const TriangleEdges<Lanes> e = LoadEdges<Lanes>(block, i);
+    const Float nx = Lanes::Sub(Lanes::Mul(e.e1y, e.e2z), Lanes::Mul(e.e1z, e.e2y));
+    const Float ny = Lanes::Sub(Lanes::Mul(e.e1z, e.e2x), Lanes::Mul(e.e1x, e.e2z));
+    const Float nz = Lanes::Sub(Lanes::Mul(e.e1x, e.e2y), Lanes::Mul(e.e1y, e.e2x));
+    StoreNormalized<Lanes>(nx, ny, nz, x + i, y + i, z + i);
+}
+
+template <typename Lanes>
+AGL_MESH_TARGET inline void TangentLanes(const TriangleBlock &block, size_t i, float *const *out) {
+    using Float = typename Lanes::Float;
+    const TriangleEdges<Lanes> e = LoadEdges<Lanes>(block, i);
+    const Float du1 = Lanes::Sub(Lanes::Load(block.texCoord[1][0] + i), Lanes::Load(block.texCoord[0][0] + i));
+    const Float dv1 = Lanes::Sub(Lanes::Load(block.texCoord[1][1] + i), Lanes::Load(block.texCoord[0][1] + i));
+    const Float du2 = Lanes::Sub(Lanes::Load(block.texCoord[2][0] + i), Lanes::Load(block.texCoord[0][0] + i));
+    const Float dv2 = Lanes::Sub(Lanes::Load(block.texCoord[2][1] + i), Lanes::Load(block.texCoord[0][1] + i));
+
+    const Float zero = Lanes::Set1(0.0f);
+    const Float determinant = Lanes::Sub(Lanes::Mul(du1, dv2), Lanes::Mul(du2, dv1));
+    const Float f = Lanes::Select(Lanes::Equal(determinant, zero), zero, Lanes::Div(Lanes::Set1(1.0f), determinant));
+
+    // T = f * (dv2 * e1 - dv1 * e2), B = f * (du1 * e2 - du2 * e1)
+    Lanes::Store(out[0] + i, Lanes::Mul(f, Lanes::Sub(Lanes::Mul(dv2, e.e1x), Lanes::Mul(dv1, e.e2x))));
+    Lanes::Store(out[1] + i, Lanes::Mul(f, Lanes::Sub(Lanes::Mul(dv2, e.e1y), Lanes::Mul(dv1, e.e2y))));
+    Lanes::Store(out[2] + i, Lanes::Mul(f, Lanes::Sub(Lanes::Mul(dv2, e.e1z), Lanes::Mul(dv1, e.e2z))));
+    Lanes::Store(out[3] + i, Lanes::Mul(f, Lanes::Sub(Lanes::Mul(du1, e.e2x), Lanes::Mul(du2, e.e1x))));
+    Lanes::Store(out[4] + i, Lanes::Mul(f, Lanes::Sub(Lanes::Mul(du1, e.e2y), Lanes::Mul(du2, e.e1y))));
+    Lanes::Store(out[5] + i, Lanes::Mul(f, Lanes::Sub(Lanes::Mul(du1, e.e2z), Lanes::Mul(du2, e.e1z))));
+}
+
+AGL_MESH_TARGET void TriangleNormals(const MeshTriangleView &mesh, size_t begin, size_t end, float *x, float *y,
+                                     float *z) {
+    TriangleBlock block;
+    for (size_t first = begin; first < end; first += BlockTriangles) {
+        const size_t count = std::min(BlockTriangles, end - first);
+        GatherTriangles(mesh, first, count, false, block);
+        size_t i = 0;
+        for (; i + L::Width <= count; i += L::Width) {
+            NormalLanes<L>(block, i, x + first, y + first, z + first);
+        }
+        for (; i < count; ++i) {
+            NormalLanes<simd::ScalarLanes>(block, i, x + first, y + first, z + first);
+        }
+    }
+}
+
+AGL_MESH_TARGET void TriangleTangents(const MeshTriangleView &mesh, size_t begin, size_t end, float *const *out) {
+    TriangleBlock block;
+    for (size_t first = begin; first < end; first += BlockTriangles) {
+        const size_t count = std::min(BlockTriangles, end - first);
+        GatherTriangles(mesh, first, count, true, block);
+        float *const blockOut[6] = {out[0] + first, out[1] + first, out[2] + first,
+                                    out[3] + first, out[4] + first, out[5] + first};
+        size_t i = 0;
+        for (; i + L::Width <= count; i += L::Width) {
+            TangentLanes<L>(block, i, blockOut);
+        }
+        for (; i < count; ++i) {
+            TangentLanes<simd::ScalarLanes>(block, i, blockOut);
+        }
+    }
+}
+
+AGL_MESH_TARGET void Normalize(float *x, float *y, float *z, size_t begin, size_t end) {
+    size_t i = begin;
+    for (; i + L::Width <= end; i += L::Width) {
+        StoreNormalized<L>(L::Load(x + i), L::Load(y + i), L::Load(z + i), x + i, y + i, z + i);
+    }
+    for (; i < end; ++i) {
+        StoreNormalized<simd::ScalarLanes>(x[i], y[i], z[i], x + i, y + i, z + i);
+    }
+}
@@ -0,0 +1,254 @@
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace agl {
+
+namespace {
+
+// Triangles per ParallelFor chunk of the normal pass, and clusters per chunk of the bounds pass
+constexpr size_t TriangleChunkSize = 4096;
+constexpr size_t MeshletChunkSize = 64;
+
+glm::vec3 TriangleNormal(const std::vector<Vertex> &vertices, const uint32_t *corner) {
+    const glm::vec3 &a = vertices[corner[0]].position;
+    const glm::vec3 cross = glm::cross(vertices[corner[1]].position - a, vertices[corner[2]].position - a);
+    const float length = glm::length(cross);
+    return length > 0.0f ? cross / length : glm::vec3(0.0f);
+}
+
+} // namespace
+
+std::vector<Meshlet> MeshletBuilder::Build(const std::vector<Vertex> &vertices, std::vector<uint32_t> &indices,
+                                           uint32_t maxTriangles, float coneWeight) {
+    const size_t triangleCount = indices.size() / 3;
+    const size_t vertexCount = vertices.size();
+    if (triangleCount == 0) {
+        return {};
+    }
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        if (indices[i] >= vertexCount) {
+            std::cerr << "MeshletBuilder: index " << indices[i] << " is out of range" << std::endl;
+            return {};
+        }
+    }
+    maxTriangles = std::max(maxTriangles, 1u);
+
+    std::vector<glm::vec3> normals(triangleCount);
+    ThreadPool::Shared().ParallelFor(triangleCount, TriangleChunkSize, [&](size_t, size_t begin, size_t end) {
+        for (size_t triangle = begin; triangle < end; ++triangle) {
+            normals[triangle] = TriangleNormal(vertices, indices.data() + triangle * 3);
+        }
+    });
+
+    // Corners are connected through welded positions, so seams and hard edges do not split clusters
+    std::vector<uint32_t> positionOf;
+    std::vector<uint32_t> nextWedge;
+    MeshSimplifier::WeldPositions(vertices, positionOf, nextWedge);
+    std::vector<uint32_t> corners(triangleCount * 3);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        corners[i] = positionOf[indices[i]];
+    }
+
+    // Triangles around each position in compressed rows
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++offsets[corners[i] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        adjacency[cursor[corners[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    // Stamps hold the cluster number plus one, so nothing needs clearing between clusters
+    std::vector<uint8_t> assigned(triangleCount, 0);
+    std::vector<uint32_t> vertexStamp(vertexCount, 0);
+    std::vector<uint32_t> candidateStamp(triangleCount, 0);
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> cluster;
+
+    std::vector<uint32_t> ordered;
+    ordered.reserve(triangleCount * 3);
+    std::vector<Meshlet> meshlets;
+    size_t seed = 0;
+    while (true) {
+        while (seed < triangleCount && assigned[seed]) {
+            ++seed;
+        }
+        if (seed == triangleCount) {
+            break;
+        }
+
+        const uint32_t stamp = static_cast<uint32_t>(meshlets.size() + 1);
+        glm::vec3 normalSum(0.0f);
+        cluster.clear();
+        candidates.clear();
+        auto addTriangle = [&](uint32_t triangle) {
+            assigned[triangle] = 1;
+            cluster.push_back(triangle);
+            normalSum += normals[triangle];
+            for (uint32_t c = 0; c < 3; ++c) {
+                const uint32_t vertex = corners[triangle * 3 + c];
+                if (vertexStamp[vertex] == stamp) {
+                    continue;
+                }
+                vertexStamp[vertex] = stamp;
+                for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i) {
+                    const uint32_t neighbour = adjacency[i];
+                    if (!assigned[neighbour] && candidateStamp[neighbour] != stamp) {
+                        candidateStamp[neighbour] = stamp;
+                        candidates.push_back(neighbour);
+                    }
+                }
+            }
+        };
+
+        addTriangle(static_cast<uint32_t>(seed));
+        while (cluster.size() < maxTriangles) {
+            // Fewest new positions first, then closest to the cluster's facing
+            const float axisLength = glm::length(normalSum);
+            const glm::vec3 axis = axisLength > 0.0f ? normalSum / axisLength : glm::vec3(0.0f);
+            size_t best = std::numeric_limits<size_t>::max();
+            float bestScore = std::numeric_limits<float>::max();
+            size_t kept = 0;
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                const uint32_t triangle = candidates[i];
+                if (assigned[triangle]) {
+                    continue;
+                }
+                candidates[kept] = triangle;
+                uint32_t newVertices = 0;
+                for (uint32_t c = 0; c < 3; ++c) {
+                    newVertices += vertexStamp[corners[triangle * 3 + c]] != stamp ? 1 : 0;
+                }
+                const float score =
+                    static_cast<float>(newVertices) + coneWeight * (1.0f - glm::dot(axis, normals[triangle]));
+                if (score < bestScore) {
+                    bestScore = score;
+                    best = kept;
+                }
+                ++kept;
+            }
+            candidates.resize(kept);
+
+            // Only a disconnected piece runs out of neighbours; its cluster ends early rather than jumping away
+            if (best == std::numeric_limits<size_t>::max()) {
+                break;
+            }
+            addTriangle(candidates[best]);
+        }
+
+        std::sort(cluster.begin(), cluster.end());
+        Meshlet meshlet;
+        meshlet.firstIndex = static_cast<uint32_t>(ordered.size());
+        meshlet.indexCount = static_cast<uint32_t>(cluster.size() * 3);
+        for (uint32_t triangle : cluster) {
+            ordered.insert(ordered.end(), indices.begin() + triangle * 3, indices.begin() + triangle * 3 + 3);
+        }
+        meshlets.push_back(meshlet);
+    }
+
+    // A trailing partial triangle is not part of any cluster and is dropped like the draw would
+    indices.swap(ordered);
+
+    ThreadPool::Shared().ParallelFor(meshlets.size(), MeshletChunkSize, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ComputeBounds(vertices, indices, meshlets[i]);
+        }
+    });
+    return meshlets;
+}
+
+void MeshletBuilder::ComputeBounds(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+                                   Meshlet &meshlet) {
+    const uint32_t *begin = indices.data() + meshlet.firstIndex;
+    const uint32_t *end = begin + meshlet.indexCount;
+    meshlet.bounds = BoundingSphere();
+    meshlet.coneAxis = glm::vec3(0.0f);
+    meshlet.coneCutoff = 1.0f;
+    if (begin == end) {
+        return;
+    }
+
+    // Sphere around the bounding box: clusters are small and compact, so this stays close to minimal
+    glm::vec3 boundsMin = vertices[*begin].position;
+    glm::vec3 boundsMax = boundsMin;
+    for (const uint32_t *index = begin; index != end; ++index) {
+        boundsMin = glm::min(boundsMin, vertices[*index].position);
+        boundsMax = glm::max(boundsMax, vertices[*index].position);
+    }
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    float radiusSquared = 0.0f;
+    for (const uint32_t *index = begin; index != end; ++index) {
+        const glm::vec3 offset = vertices[*index].position - center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+    meshlet.bounds.center = center;
+    meshlet.bounds.radius = std::sqrt(radiusSquared) * (1.0f + 4.0f * std::numeric_limits<float>::epsilon());
+
+    // Normal cone around the average facing; degenerate triangles face nowhere and are left out
+    glm::vec3 normalSum(0.0f);
+    for (const uint32_t *corner = begin; corner + 3 <= end; corner += 3) {
+        normalSum += TriangleNormal(vertices, corner);
+    }
+    const float axisLength = glm::length(normalSum);
+    if (axisLength <= 0.0f) {
+        return;
+    }
+    const glm::vec3 axis = normalSum / axisLength;
+    float minDot = 1.0f;
+    for (const uint32_t *corner = begin; corner + 3 <= end; corner += 3) {
+        const glm::vec3 normal = TriangleNormal(vertices, corner);
+        if (normal != glm::vec3(0.0f)) {
+            minDot = std::min(minDot, glm::dot(axis, normal));
+        }
+    }
+
+    // Normals spread over a hemisphere or more can always be seen from somewhere
+    if (minDot <= 0.0f) {
+        return;
+    }
+    meshlet.coneAxis = axis;
+    meshlet.coneCutoff = std::sqrt(std::max(1.0f - minDot * minDot, 0.0f));
+}
+
+bool MeshletBuilder::IsBackFacing(const Meshlet &meshlet, const glm::vec3 &cameraPosition) {
+    if (meshlet.coneCutoff >= 1.0f) {
+        return false;
+    }
+
+    // Every direction from the eye into the sphere must lie within 90 degrees minus the cone's half angle of
+    // the axis; the radius term widens the test from the center to the whole sphere
+    const glm::vec3 toCenter = meshlet.bounds.center - cameraPosition;
+    return glm::dot(toCenter, meshlet.coneAxis) >=
+           meshlet.coneCutoff * glm::length(toCenter) + meshlet.bounds.radius * (1.0f + meshlet.coneCutoff);
+}
+
+MeshletCullStats MeshletBuilder::Cull(const std::vector<Meshlet> &meshlets, const Frustum &frustum,
+                                      const glm::vec3 &cameraPosition, bool cullBackFaces,
+                                      std::vector<uint32_t> &visible) {
+    MeshletCullStats stats;
+    visible.clear();
+    for (size_t i = 0; i < meshlets.size(); ++i) {
+        const Meshlet &meshlet = meshlets[i];
+        if (!frustum.IntersectsSphere(meshlet.bounds.center, meshlet.bounds.radius)) {
+            stats.outside++;
+        } else if (cullBackFaces && IsBackFacing(meshlet, cameraPosition)) {
+            stats.backFacing++;
+        } else {
+            stats.visible++;
+            visible.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return stats;
+}
+
+} // namespace agl
@@ -0,0 +1,880 @@
+#include "ModelLoader.h"
+#include "DispatchQueue.h"
+#include "Logger.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace agl {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t ChunkBytes = 1 << 20; // Target size of the pieces the OBJ text is split into
+
+// Face corner flags: the index was negative and is relative to the chunk's own vertex counts
+constexpr uint8_t RelativePosition = 1 << 0;
+constexpr uint8_t RelativeTexCoord = 1 << 1;
+constexpr uint8_t RelativeNormal = 1 << 2;
+
+double Milliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief One corner of a triangle as written in the file
+ *
+ * Absolute indices are stored 1-based (0 = missing) until resolution; relative
+ * ones are chunk-local offsets that may point into earlier chunks.
+ */
+struct ObjCorner {
+    int32_t position;
+    int32_t texCoord;
+    int32_t normal;
+    uint8_t flags;
+};
+
+/**
+ * @brief "usemtl" seen in a chunk, effective from the given triangle of that chunk
+ */
+struct ObjMaterialSwitch {
+    size_t triangle;
+    std::string name;
+};
+
+/**
+ * @brief Everything parsed from one chunk of the OBJ text
+ */
+struct ObjChunk {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+    std::vector<ObjCorner> corners; // Three per triangle
+    std::vector<ObjMaterialSwitch> materialSwitches;
+    std::vector<std::string> materialLibraries;
+    size_t positionBase{0}; // Vertices of each kind in all earlier chunks
+    size_t texCoordBase{0};
+    size_t normalBase{0};
+    bool invalidIndex{false};
+};
+
+/**
+ * @brief Run of consecutive triangles of one chunk that share a material
+ */
+struct ObjTriangleRange {
+    size_t chunk;
+    size_t begin;
+    size_t end;
+};
+
+/**
+ * @brief Key of a unique output vertex: resolved 0-based indices, -1 where missing
+ */
+struct ObjVertexKey {
+    int32_t position;
+    int32_t texCoord;
+    int32_t normal;
+
+    bool operator==(const ObjVertexKey &other) const {
+        return position == other.position && texCoord == other.texCoord && normal == other.normal;
+    }
+};
+
+inline uint64_t HashKey(const ObjVertexKey &key) {
+    uint64_t hash = static_cast<uint32_t>(key.position) * 0x9E3779B97F4A7C15ull;
+    hash ^= static_cast<uint32_t>(key.texCoord) * 0xC2B2AE3D27D4EB4Full + (hash >> 29);
+    hash ^= static_cast<uint32_t>(key.normal) * 0x165667B19E3779F9ull + (hash >> 32);
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * @brief Open addressing map from vertex keys to output vertex indices, kept at most half full
+ */
+class ObjVertexTable {
+public:
+    static constexpr uint32_t Empty = 0xFFFFFFFFu;
+
+    explicit ObjVertexTable(size_t expectedCount) {
+        size_t size = 16;
+        while (size < expectedCount * 2) {
+            size *= 2;
+        }
+        m_slots.assign(size, Empty);
+        m_keys.reserve(expectedCount);
+    }
+
+    /**
+     * @brief Find the index of a key, adding it as the next index if it is new
+     */
+    uint32_t FindOrInsert(const ObjVertexKey &key, bool &inserted) {
+        const size_t mask = m_slots.size() - 1;
+        size_t slot = HashKey(key) & mask;
+        while (m_slots[slot] != Empty) {
+            if (m_keys[m_slots[slot]] == key) {
+                inserted = false;
+                return m_slots[slot];
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        const uint32_t index = static_cast<uint32_t>(m_keys.size());
+        m_slots[slot] = index;
+        m_keys.push_back(key);
+        inserted = true;
+        if (m_keys.size() * 2 > m_slots.size()) {
+            Grow();
+        }
+        return index;
+    }
+
+private:
+    void Grow() {
+        m_slots.assign(m_slots.size() * 2, Empty);
+        const size_t mask = m_slots.size() - 1;
+        for (uint32_t i = 0; i < m_keys.size(); ++i) {
+            size_t slot = HashKey(m_keys[i]) & mask;
+            while (m_slots[slot] != Empty) {
+                slot = (slot + 1) & mask;
+            }
+            m_slots[slot] = i;
+        }
+    }
+
+    std::vector<uint32_t> m_slots;
+    std::vector<ObjVertexKey> m_keys;
+};
+
+inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline const char *SkipSpaces(const char *p, const char *end) {
+    while (p < end && IsSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+inline const char *SkipToken(const char *p, const char *end) {
+    while (p < end && !IsSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * @brief Parse a decimal float without locale or allocation
+ *
+ * Up to 19 significant digits are accumulated in an integer and scaled by an
+ * exact power of ten where possible, which rounds correctly to float for the
+ * numbers exporters write. Anything else (inf, nan, hex) goes through strtof.
+ */
+const char *ParseFloat(const char *p, const char *end, float &out) {
+    static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    p = SkipSpaces(p, end);
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    for (; p < end && IsDigit(*p); ++p) {
+        any = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            digits += mantissa != 0;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && IsDigit(*p); ++p) {
+            any = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                digits += mantissa != 0;
+                --exponent;
+            }
+        }
+    }
+    if (!any) {
+        // Not a plain decimal number
+        char buffer[64];
+        const size_t length = std::min(static_cast<size_t>(SkipToken(start, end) - start), sizeof(buffer) - 1);
+        std::memcpy(buffer, start, length);
+        buffer[length] = '\0';
+        char *parsedEnd = buffer;
+        out = std::strtof(buffer, &parsedEnd);
+        return start + (parsedEnd - buffer);
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *exponentStart = p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        if (p < end && IsDigit(*p)) {
+            int value = 0;
+            for (; p < end && IsDigit(*p); ++p) {
+                value = std::min(value * 10 + (*p - '0'), 10000);
+            }
+            exponent += negativeExponent ? -value : value;
+        } else {
+            p = exponentStart; // "1e" is the number 1 followed by garbage
+        }
+    }
+
+    double value = static_cast<double>(mantissa);
+    if (exponent < 0) {
+        value = exponent >= -22 ? value / powers[-exponent] : value * std::pow(10.0, exponent);
+    } else if (exponent > 0) {
+        value = exponent <= 22 ? value * powers[exponent] : value * std::pow(10.0, exponent);
+    }
+    out = static_cast<float>(negative ? -value : value);
+    return p;
+}
+
+/**
+ * @brief Parse a signed integer; returns p unchanged if there are no digits
+ */
+const char *ParseInt(const char *p, const char *end, int32_t &out) {
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p == end || !IsDigit(*p)) {
+        return start;
+    }
+    int64_t value = 0;
+    for (; p < end && IsDigit(*p); ++p) {
+        value = std::min<int64_t>(value * 10 + (*p - '0'), INT32_MAX);
+    }
+    out = static_cast<int32_t>(negative ? -value : value);
+    return p;
+}
+
+/**
+ * @brief Rest of the line with surrounding whitespace removed (names may contain spaces)
+ */
+std::string RestOfLine(const char *p, const char *end) {
+    p = SkipSpaces(p, end);
+    while (end > p && IsSpace(end[-1])) {
+        --end;
+    }
+    return std::string(p, end);
+}
+
+/**
+ * @brief Store one face index, converting negative ones to chunk-relative form
+ */
+bool StoreIndex(int32_t value, size_t localCount, uint8_t relativeFlag, int32_t &index, uint8_t &flags) {
+    if (value > 0) {
+        index = value;
+    } else if (value < 0) {
+        // -1 is the latest vertex; the result may be negative, reaching into earlier chunks
+        index = static_cast<int32_t>(static_cast<int64_t>(localCount) + value);
+        flags |= relativeFlag;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void ParseFace(const char *p, const char *end, ObjChunk &chunk) {
+    // Polygons are fan-triangulated around their first corner
+    ObjCorner first{};
+    ObjCorner previous{};
+    size_t count = 0;
+    const size_t cornersBefore = chunk.corners.size();
+
+    while (true) {
+        p = SkipSpaces(p, end);
+        if (p == end) {
+            break;
+        }
+
+        ObjCorner corner{};
+        int32_t value = 0;
+        const char *next = ParseInt(p, end, value);
+        if (next == p || !StoreIndex(value, chunk.positions.size(), RelativePosition, corner.position,
+                                     corner.flags)) {
+            // Drop the whole polygon rather than part of it
+            chunk.corners.resize(cornersBefore);
+            chunk.invalidIndex = true;
+            return;
+        }
+        p = next;
+        if (p < end && *p == '/') {
+            ++p;
+            next = ParseInt(p, end, value);
+            if (next != p) {
+                StoreIndex(value, chunk.texCoords.size(), RelativeTexCoord, corner.texCoord, corner.flags);
+                p = next;
+            }
+            if (p < end && *p == '/') {
+                ++p;
+                next = ParseInt(p, end, value);
+                if (next != p) {
+                    StoreIndex(value, chunk.normals.size(), RelativeNormal, corner.normal, corner.flags);
+                    p = next;
+                }
+            }
+        }
+        p = SkipToken(p, end);
+
+        if (count == 0) {
+            first = corner;
+        } else if (count >= 2) {
+            chunk.corners.push_back(first);
+            chunk.corners.push_back(previous);
+            chunk.corners.push_back(corner);
+        }
+        previous = corner;
+        ++count;
+    }
+}
+
+void ParseChunk(const char *p, const char *end, ObjChunk &chunk) {
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        const char *line = SkipSpaces(p, lineEnd);
+        p = lineEnd + 1;
+
+        if (lineEnd - line < 2) {
+            continue;
+        }
+
+        if (line[0] == 'v') {
+            if (IsSpace(line[1])) {
+                glm::vec3 position;
+                const char *q = ParseFloat(line + 2, lineEnd, position.x);
+                q = ParseFloat(q, lineEnd, position.y);
+                ParseFloat(q, lineEnd, position.z);
+                chunk.positions.push_back(position);
+            } else if (line[1] == 't' && lineEnd - line > 2 && IsSpace(line[2])) {
+                glm::vec2 texCoord;
+                const char *q = ParseFloat(line + 3, lineEnd, texCoord.x);
+                ParseFloat(q, lineEnd, texCoord.y);
+                chunk.texCoords.push_back(texCoord);
+            } else if (line[1] == 'n' && lineEnd - line > 2 && IsSpace(line[2])) {
+                glm::vec3 normal;
+                const char *q = ParseFloat(line + 3, lineEnd, normal.x);
+                q = ParseFloat(q, lineEnd, normal.y);
+                ParseFloat(q, lineEnd, normal.z);
+                chunk.normals.push_back(normal);
+            }
+        } else if (line[0] == 'f' && IsSpace(line[1])) {
+            ParseFace(line + 2, lineEnd, chunk);
+        } else if (lineEnd - line > 7 && std::strncmp(line, "usemtl", 6) == 0 && IsSpace(line[6])) {
+            chunk.materialSwitches.push_back({chunk.corners.size() / 3, RestOfLine(line + 7, lineEnd)});
+        } else if (lineEnd - line > 7 && std::strncmp(line, "mtllib", 6) == 0 && IsSpace(line[6])) {
+            chunk.materialLibraries.push_back(RestOfLine(line + 7, lineEnd));
+        }
+        // Comments, groups, objects and smoothing groups do not affect the geometry
+    }
+}
+
+/**
+ * @brief Move a chunk boundary forward to the start of the next line
+ */
+size_t AlignToLine(const std::vector<char> &text, size_t offset) {
+    if (offset == 0 || offset >= text.size()) {
+        return std::min(offset, text.size());
+    }
+    const void *newline = std::memchr(text.data() + offset - 1, '\n', text.size() - (offset - 1));
+    return newline ? static_cast<size_t>(static_cast<const char *>(newline) - text.data()) + 1 : text.size();
+}
+
+/**
+ * @brief Turn a stored corner index into a 0-based global index, or -1 if missing or out of range
+ */
+int32_t ResolveIndex(int32_t index, bool relative, size_t base, size_t total, bool &invalid) {
+    int64_t resolved;
+    if (relative) {
+        resolved = static_cast<int64_t>(base) + index;
+    } else if (index > 0) {
+        resolved = index - 1;
+    } else {
+        return -1;
+    }
+    if (resolved < 0 || resolved >= static_cast<int64_t>(total)) {
+        invalid = true;
+        return -1;
+    }
+    return static_cast<int32_t>(resolved);
+}
+
+bool ReadFile(const std::string &filepath, std::vector<char> &text) {
+    FILE *file = std::fopen(filepath.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (size < 0) {
+        std::fclose(file);
+        return false;
+    }
+    text.resize(static_cast<size_t>(size));
+    const bool ok = std::fread(text.data(), 1, text.size(), file) == text.size();
+    std::fclose(file);
+    return ok;
+}
+
+std::string DirectoryOf(const std::string &filepath) {
+    const size_t slash = filepath.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : filepath.substr(0, slash + 1);
+}
+
+/**
+ * @brief Resolve a map_* statement to a path; options such as "-bm 1.0" precede the file name
+ */
+std::string TexturePath(const std::string &directory, const std::string &arguments) {
+    size_t nameStart = 0;
+    while (nameStart < arguments.size() && arguments[nameStart] == '-') {
+        // Skip the option and its numeric arguments
+        size_t p = arguments.find_first_of(" \t", nameStart);
+        while (p != std::string::npos) {
+            const size_t token = arguments.find_first_not_of(" \t", p);
+            if (token == std::string::npos) {
+                return std::string();
+            }
+            const char c = arguments[token];
+            if (!(IsDigit(c) || c == '.' || ((c == '-' || c == '+') && token + 1 < arguments.size() &&
+                                               IsDigit(arguments[token + 1])))) {
+                p = token;
+                break;
+            }
+            p = arguments.find_first_of(" \t", token);
+        }
+        if (p == std::string::npos) {
+            return std::string();
+        }
+        nameStart = p;
+    }
+    const std::string name = arguments.substr(nameStart);
+    if (name.empty()) {
+        return name;
+    }
+    const bool absolute = name[0] == '/' || name[0] == '\\' || (name.size() > 1 && name[1] == ':');
+    return absolute ? name : directory + name;
+}
+
+/**
+ * @brief Build one mesh from the triangle ranges of a material, merging identical corners
+ * @return Triangles dropped because an index was out of range or the position was missing
+ */
+size_t BuildMesh(const std::vector<ObjChunk> &chunks, const std::vector<ObjTriangleRange> &ranges,
+               const std::vector<glm::vec3> &positions, const std::vector<glm::vec2> &texCoords,
+               const std::vector<glm::vec3> &normals, ModelMeshData &mesh) {
+    size_t triangleCount = 0;
+    for (const ObjTriangleRange &range : ranges) {
+        triangleCount += range.end - range.begin;
+    }
+
+    // Closed meshes have about half as many unique vertices as triangles; the table grows if not
+    ObjVertexTable lookup(triangleCount / 2 + 16);
+    mesh.indices.reserve(triangleCount * 3);
+    mesh.vertices.reserve(triangleCount / 2 + 16);
+
+    size_t skipped = 0;
+    bool missingNormals = false;
+    std::vector<bool> generatedNormal; // Per vertex: the file gave it no normal
+    for (const ObjTriangleRange &range : ranges) {
+        const ObjChunk &chunk = chunks[range.chunk];
+        for (size_t triangle = range.begin; triangle < range.end; ++triangle) {
+            ObjVertexKey keys[3];
+            bool invalid = false;
+            for (int i = 0; i < 3; ++i) {
+                const ObjCorner &source = chunk.corners[triangle * 3 + i];
+                keys[i].position = ResolveIndex(source.position, source.flags & RelativePosition, chunk.positionBase,
+                                                positions.size(), invalid);
+                keys[i].texCoord = ResolveIndex(source.texCoord, source.flags & RelativeTexCoord, chunk.texCoordBase,
+                                                texCoords.size(), invalid);
+                keys[i].normal = ResolveIndex(source.normal, source.flags & RelativeNormal, chunk.normalBase,
+                                              normals.size(), invalid);
+            }
+            if (invalid || keys[0].position < 0 || keys[1].position < 0 || keys[2].position < 0) {
+                ++skipped;
+                continue;
+            }
+
+            for (const ObjVertexKey &key : keys) {
+                bool inserted = false;
+                const uint32_t index = lookup.FindOrInsert(key, inserted);
+                if (inserted) {
+                    Vertex vertex(positions[key.position]);
+                    if (key.texCoord >= 0) {
+                        vertex.texCoords = texCoords[key.texCoord];
+                        mesh.hasTexCoords = true;
+                    }
+                    if (key.normal >= 0) {
+                        vertex.normal = normals[key.normal];
+                    } else {
+                        missingNormals = true;
+                    }
+                    mesh.vertices.push_back(vertex);
+                    generatedNormal.push_back(key.normal < 0);
+                }
+                mesh.indices.push_back(index);
+            }
+        }
+    }
+
+    if (missingNormals) {
+        // Smooth normals over the vertices that share position and texcoord, weighted by area
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            const uint32_t corners[3] = {mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]};
+            const glm::vec3 &a = mesh.vertices[corners[0]].position;
+            const glm::vec3 faceNormal =
+                glm::cross(mesh.vertices[corners[1]].position - a, mesh.vertices[corners[2]].position - a);
+            for (uint32_t corner : corners) {
+                if (generatedNormal[corner]) {
+                    mesh.vertices[corner].normal += faceNormal;
+                }
+            }
+        }
+        for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+            if (generatedNormal[v]) {
+                glm::vec3 &normal = mesh.vertices[v].normal;
+                const float length = glm::length(normal);
+                normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        }
+    }
+    return skipped;
+}
+
+} // namespace
+
+void Model::Render(ShaderProgram &shader, const glm::mat4 &modelMatrix) {
+    for (auto &mesh : meshes) {
+        mesh->Render(shader, modelMatrix);
+    }
+}
+
+size_t Model::GetTriangleCount() const {
+    size_t triangles = 0;
+    for (const auto &mesh : meshes) {
+        triangles += mesh->GetTriangleCount();
+    }
+    return triangles;
+}
+
+bool ModelLoader::ParseMaterials(const std::string &filepath, std::vector<ModelMaterial> &materials) {
+    std::vector<char> text;
+    if (!ReadFile(filepath, text)) {
+        return false;
+    }
+
+    const std::string directory = DirectoryOf(filepath);
+    ModelMaterial *material = nullptr;
+    const char *p = text.data();
+    const char *end = p + text.size();
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        const char *line = SkipSpaces(p, lineEnd);
+        p = lineEnd + 1;
+
+        const char *keywordEnd = SkipToken(line, lineEnd);
+        const std::string keyword(line, keywordEnd);
+        if (keyword == "newmtl") {
+            materials.emplace_back();
+            material = &materials.back();
+            material->name = RestOfLine(keywordEnd, lineEnd);
+            continue;
+        }
+        if (!material) {
+            continue;
+        }
+
+        auto readColor = [&](glm::vec3 &color) {
+            const char *q = ParseFloat(keywordEnd, lineEnd, color.x);
+            q = ParseFloat(q, lineEnd, color.y);
+            ParseFloat(q, lineEnd, color.z);
+        };
+        if (keyword == "Ka") {
+            readColor(material->ambient);
+        } else if (keyword == "Kd") {
+            readColor(material->diffuse);
+        } else if (keyword == "Ks") {
+            readColor(material->specular);
+        } else if (keyword == "Ns") {
+            ParseFloat(keywordEnd, lineEnd, material->shininess);
+        } else if (keyword == "map_Kd") {
+            material->diffuseMap = TexturePath(directory, RestOfLine(keywordEnd, lineEnd));
+        } else if (keyword == "map_Ks") {
+            material->specularMap = TexturePath(directory, RestOfLine(keywordEnd, lineEnd));
+        } else if (keyword == "map_Bump" || keyword == "map_bump" || keyword == "bump" || keyword == "norm") {
+            material->normalMap = TexturePath(directory, RestOfLine(keywordEnd, lineEnd));
+        }
+    }
+    return true;
+}
+
+bool ModelLoader::Parse(const std::string &filepath, ModelData &data) {
+    return Parse(filepath, data, ThreadPool::Shared());
+}
+
+bool ModelLoader::Parse(const std::string &filepath, ModelData &data, ThreadPool &pool) {
+    data = ModelData();
+
+    auto start = Clock::now();
+    std::vector<char> text;
+    if (!ReadFile(filepath, text)) {
+        std::cerr << "Failed to read model file: " << filepath << std::endl;
+        return false;
+    }
+    data.stats.fileBytes = text.size();
+    data.stats.readMs = Milliseconds(start);
+
+    start = Clock::now();
+
+    // Split at line starts and parse every chunk independently
+    const size_t chunkCount = std::max<size_t>(1, (text.size() + ChunkBytes - 1) / ChunkBytes);
+    std::vector<ObjChunk> chunks(chunkCount);
+    pool.ParallelFor(chunkCount, 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const size_t first = AlignToLine(text, i * ChunkBytes);
+            const size_t last = AlignToLine(text, (i + 1) * ChunkBytes);
+            ParseChunk(text.data() + first, text.data() + last, chunks[i]);
+        }
+    });
+    data.stats.chunks = chunkCount;
+
+    // Concatenate the vertex attributes; each chunk remembers where its own start
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+    size_t positionCount = 0;
+    size_t texCoordCount = 0;
+    size_t normalCount = 0;
+    for (ObjChunk &chunk : chunks) {
+        chunk.positionBase = positionCount;
+        chunk.texCoordBase = texCoordCount;
+        chunk.normalBase = normalCount;
+        positionCount += chunk.positions.size();
+        texCoordCount += chunk.texCoords.size();
+        normalCount += chunk.normals.size();
+    }
+    positions.resize(positionCount);
+    texCoords.resize(texCoordCount);
+    normals.resize(normalCount);
+    pool.ParallelFor(chunkCount, 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ObjChunk &chunk = chunks[i];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.positionBase);
+            std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + chunk.texCoordBase);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalBase);
+            std::vector<glm::vec3>().swap(chunk.positions);
+            std::vector<glm::vec2>().swap(chunk.texCoords);
+            std::vector<glm::vec3>().swap(chunk.normals);
+        }
+    });
+    data.stats.positions = positionCount;
+
+    // Group triangles by material, in file order; a usemtl stays active across chunk boundaries
+    std::vector<std::string> materialNames;
+    std::vector<std::vector<ObjTriangleRange>> materialRanges;
+    std::unordered_map<std::string, size_t> materialLookup;
+    std::vector<std::string> libraries;
+    size_t currentMaterial = 0;
+    materialNames.emplace_back();
+    materialRanges.emplace_back();
+    materialLookup.emplace(std::string(), 0);
+
+    bool invalidIndex = false;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const ObjChunk &chunk = chunks[i];
+        invalidIndex |= chunk.invalidIndex;
+        libraries.insert(libraries.end(), chunk.materialLibraries.begin(), chunk.materialLibraries.end());
+
+        const size_t triangleCount = chunk.corners.size() / 3;
+        size_t begin = 0;
+        for (size_t s = 0; s <= chunk.materialSwitches.size(); ++s) {
+            const size_t end = s < chunk.materialSwitches.size() ? chunk.materialSwitches[s].triangle : triangleCount;
+            if (end > begin) {
+                materialRanges[currentMaterial].push_back({i, begin, end});
+            }
+            begin = end;
+            if (s < chunk.materialSwitches.size()) {
+                const auto inserted = materialLookup.emplace(chunk.materialSwitches[s].name, materialNames.size());
+                if (inserted.second) {
+                    materialNames.push_back(chunk.materialSwitches[s].name);
+                    materialRanges.emplace_back();
+                }
+                currentMaterial = inserted.first->second;
+            }
+        }
+    }
+
+    // Deduplicate each material's vertices in parallel
+    std::vector<size_t> usedMaterials;
+    for (size_t m = 0; m < materialRanges.size(); ++m) {
+        if (!materialRanges[m].empty()) {
+            usedMaterials.push_back(m);
+        }
+    }
+    data.meshes.resize(usedMaterials.size());
+    std::vector<size_t> skipped(usedMaterials.size(), 0);
+    pool.ParallelFor(usedMaterials.size(), 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const size_t material = usedMaterials[i];
+            data.meshes[i].material = materialNames[material];
+            skipped[i] = BuildMesh(chunks, materialRanges[material], positions, texCoords, normals, data.meshes[i]);
+        }
+    });
+    for (size_t count : skipped) {
+        invalidIndex |= count > 0;
+    }
+    if (invalidIndex) {
+        std::cerr << "Model has malformed faces, which were skipped: " << filepath << std::endl;
+    }
+
+    const std::string directory = DirectoryOf(filepath);
+    for (const std::string &library : libraries) {
+        if (!ParseMaterials(directory + library, data.materials)) {
+            std::cerr << "Failed to read material library: " << directory + library << std::endl;
+        }
+    }
+
+    // Tangents go into the vertex arrays here, so CreateModel uploads every mesh once
+    for (ModelMeshData &mesh : data.meshes) {
+        const auto material = std::find_if(data.materials.begin(), data.materials.end(),
+                                           [&](const ModelMaterial &m) { return m.name == mesh.material; });
+        if (mesh.hasTexCoords && material != data.materials.end() && !material->normalMap.empty()) {
+            Mesh::CalculateTangents(mesh.vertices, mesh.indices);
+        }
+    }
+
+    for (const ModelMeshData &mesh : data.meshes) {
+        data.stats.vertices += mesh.vertices.size();
+        data.stats.triangles += mesh.indices.size() / 3;
+    }
+    data.stats.parseMs = Milliseconds(start);
+
+    // Decode every referenced image once, one file per task; only the upload is left for the GL thread
+    start = Clock::now();
+    std::vector<std::string> imagePaths;
+    for (const ModelMaterial &material : data.materials) {
+        for (const std::string *path : {&material.diffuseMap, &material.specularMap, &material.normalMap}) {
+            if (!path->empty() && std::find(imagePaths.begin(), imagePaths.end(), *path) == imagePaths.end()) {
+                imagePaths.push_back(*path);
+            }
+        }
+    }
+    std::vector<TextureImage> images(imagePaths.size());
+    std::vector<uint8_t> decoded(imagePaths.size(), 0);
+    pool.ParallelFor(imagePaths.size(), 1, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            decoded[i] = Texture2D::DecodeFile(imagePaths[i], images[i]) ? 1 : 0;
+        }
+    });
+    for (size_t i = 0; i < imagePaths.size(); ++i) {
+        if (decoded[i]) {
+            data.images.emplace(imagePaths[i], std::move(images[i]));
+        }
+    }
+    data.stats.decodeMs = Milliseconds(start);
+    return true;
+}
+
+std::unique_ptr<Model> ModelLoader::CreateModel(ModelData &&data) {
+    const auto start = Clock::now();
+    auto model = std::make_unique<Model>();
+
+    // Images were decoded by Parse(); a path already cached by the manager keeps its texture
+    auto loadTexture = [&data](const std::string &path) -> std::shared_ptr<Texture> {
+        const auto image = data.images.find(path);
+        return image == data.images.end() ? nullptr : TextureManager::Instance().AddTexture(path, image->second);
+    };
+
+    for (ModelMeshData &meshData : data.meshes) {
+        Material material;
+        const auto found = std::find_if(data.materials.begin(), data.materials.end(),
+                                        [&](const ModelMaterial &m) { return m.name == meshData.material; });
+        if (found != data.materials.end()) {
+            material.ambient = found->ambient;
+            material.diffuse = found->diffuse;
+            material.specular = found->specular;
+            material.shininess = found->shininess;
+            material.diffuseTexture = loadTexture(found->diffuseMap);
+            material.specularTexture = loadTexture(found->specularMap);
+            material.normalTexture = loadTexture(found->normalMap);
+        }
+
+        auto mesh = std::make_unique<Mesh>();
+        mesh->SetMaterial(material);
+        mesh->SetGeometry(std::move(meshData.vertices), std::move(meshData.indices));
+        model->meshes.push_back(std::move(mesh));
+    }
+
+    model->stats = data.stats;
+    model->stats.uploadMs = Milliseconds(start);
+    return model;
+}
+
+std::unique_ptr<Model> ModelLoader::Load(const std::string &filepath) {
+    ModelData data;
+    if (!Parse(filepath, data)) {
+        return nullptr;
+    }
+    auto model = CreateModel(std::move(data));
+    if (Logger::GetCoreLogger()) {
+        AGL_CORE_INFO("Loaded {} ({:.1f} MB, {} triangles) parsing at {:.0f} MB/s", filepath,
+                      model->stats.fileBytes / (1024.0 * 1024.0), model->stats.triangles,
+                      model->stats.GetParseThroughput());
+    }
+    return model;
+}
+
+void ModelLoader::LoadAsync(const std::string &filepath, LoadCallback onLoaded) {
+    ThreadPool::Shared().Enqueue([filepath, onLoaded]() {
+        auto data = std::make_shared<ModelData>();
+        if (!Parse(filepath, *data)) {
+            DispatchQueue::main().async([onLoaded]() { onLoaded(nullptr); });
+            return;
+        }
+
+        // Meshes and textures are GL objects, so they are created on the main thread
+        DispatchQueue::main().async([filepath, data, onLoaded]() {
+            std::shared_ptr<Model> model = CreateModel(std::move(*data));
+            if (Logger::GetCoreLogger()) {
+                AGL_CORE_INFO("Loaded {} ({:.1f} MB, {} triangles) parsing at {:.0f} MB/s", filepath,
+                              model->stats.fileBytes / (1024.0 * 1024.0), model->stats.triangles,
+                              model->stats.GetParseThroughput());
+            }
+            onLoaded(model);
+        });
+    });
+}
+
+} // namespace agl
@@ -0,0 +1,70 @@
+// Particle update kernel, compiled once per instruction set.
+//
+// No include guard: ParticleSystem.cpp includes this file once per lane
+// wrapper, inside a namespace named after the instruction set, with
+// AGL_PARTICLE_LANES set to a simd::*Lanes type and AGL_PARTICLE_TARGET to the
+// matching target attribute.
+
+using L = AGL_PARTICLE_LANES;
+using Float = L::Float;
+using Mask = L::Mask;
+
+// Advance every particle one step and evaluate color and size over life.
+// Arrays hold paddedCount entries; lanes past count are updated but never
+// reported. Indices of particles whose life ran out are appended to dead in
+// ascending order; returns how many there are.
+AGL_PARTICLE_TARGET size_t UpdateParticles(const ParticleUpdateArrays &arrays, const ParticleUpdateParams &params,
+                                           uint32_t *dead) {
+    const Float one = L::Set1(1.0f);
+    const Float dt = L::Set1(params.deltaTime);
+    const Float damping = L::Set1(params.damping);
+    const Float gx = L::Set1(params.gravity.x * params.deltaTime);
+    const Float gy = L::Set1(params.gravity.y * params.deltaTime);
+    const Float gz = L::Set1(params.gravity.z * params.deltaTime);
+
+    const Float r0 = L::Set1(params.startColor.x);
+    const Float g0 = L::Set1(params.startColor.y);
+    const Float b0 = L::Set1(params.startColor.z);
+    const Float a0 = L::Set1(params.startColor.w);
+    const Float s0 = L::Set1(params.startSize);
+    const Float dr = L::Set1(params.endColor.x - params.startColor.x);
+    const Float dg = L::Set1(params.endColor.y - params.startColor.y);
+    const Float db = L::Set1(params.endColor.z - params.startColor.z);
+    const Float da = L::Set1(params.endColor.w - params.startColor.w);
+    const Float ds = L::Set1(params.endSize - params.startSize);
+
+    size_t deadCount = 0;
+    for (size_t i = 0; i < arrays.paddedCount; i += L::Width) {
+        // Semi-implicit Euler: velocity first, then position with the new velocity
+        const Float vx = L::Add(L::Mul(L::Load(arrays.velocityX + i), damping), gx);
+        const Float vy = L::Add(L::Mul(L::Load(arrays.velocityY + i), damping), gy);
+        const Float vz = L::Add(L::Mul(L::Load(arrays.velocityZ + i), damping), gz);
+        L::Store(arrays.velocityX + i, vx);
+        L::Store(arrays.velocityY + i, vy);
+        L::Store(arrays.velocityZ + i, vz);
+        L::Store(arrays.positionX + i, L::Add(L::Load(arrays.positionX + i), L::Mul(vx, dt)));
+        L::Store(arrays.positionY + i, L::Add(L::Load(arrays.positionY + i), L::Mul(vy, dt)));
+        L::Store(arrays.positionZ + i, L::Add(L::Load(arrays.positionZ + i), L::Mul(vz, dt)));
+
+        const Float age = L::Add(L::Load(arrays.ages + i), dt);
+        L::Store(arrays.ages + i, age);
+        const Float life = L::Mul(age, L::Load(arrays.inverseLifetimes + i));
+        const Float t = L::Min(life, one);
+
+        L::Store(arrays.red + i, L::Add(r0, L::Mul(dr, t)));
+        L::Store(arrays.green + i, L::Add(g0, L::Mul(dg, t)));
+        L::Store(arrays.blue + i, L::Add(b0, L::Mul(db, t)));
+        L::Store(arrays.alpha + i, L::Add(a0, L::Mul(da, t)));
+        L::Store(arrays.sizes + i, L::Add(s0, L::Mul(ds, t)));
+
+        uint32_t mask = L::MoveMask(L::GreaterEqual(life, one));
+        while (mask != 0) {
+            const size_t index = i + simd::CountTrailingZeros(mask);
+            if (index < arrays.count) {
+                dead[deadCount++] = static_cast<uint32_t>(index);
+            }
+            mask &= mask - 1;
+        }
+    }
+    return deadCount;
+}
@@ -0,0 +1,599 @@
+#include "ParticleSystem.h"
+#include "SimdLanes.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace agl {
+
+namespace {
+
+// Pools pad to this many lanes so the kernel never needs a scalar tail
+constexpr size_t LanePadding = 8;
+
+/**
+ * @brief Raw view of one emitter's pool handed to the update kernel
+ */
+struct ParticleUpdateArrays {
+    size_t count;
+    size_t paddedCount;
+    float *positionX, *positionY, *positionZ;
+    float *velocityX, *velocityY, *velocityZ;
+    float *ages;
+    const float *inverseLifetimes;
+    float *red, *green, *blue, *alpha;
+    float *sizes;
+};
+
+/**
+ * @brief Per-emitter constants of one update step
+ */
+struct ParticleUpdateParams {
+    float deltaTime;
+    float damping; // Velocity scale from drag over the step
+    glm::vec3 gravity;
+    glm::vec4 startColor;
+    glm::vec4 endColor;
+    float startSize;
+    float endSize;
+};
+
+namespace scalar {
+#define AGL_PARTICLE_LANES simd::ScalarLanes
+#define AGL_PARTICLE_TARGET
+#include "ParticleKernels.h"
+#undef AGL_PARTICLE_LANES
+#undef AGL_PARTICLE_TARGET
+} // namespace scalar
+
+#if defined(AGL_SIMD_X86)
+
+namespace sse2 {
+#define AGL_PARTICLE_LANES simd::SSE2Lanes
+#define AGL_PARTICLE_TARGET AGL_TARGET_SSE2
+#include "ParticleKernels.h"
+#undef AGL_PARTICLE_LANES
+#undef AGL_PARTICLE_TARGET
+} // namespace sse2
+
+namespace avx2 {
+#define AGL_PARTICLE_LANES simd::AVX2Lanes
+#define AGL_PARTICLE_TARGET AGL_TARGET_AVX2
+#include "ParticleKernels.h"
+#undef AGL_PARTICLE_LANES
+#undef AGL_PARTICLE_TARGET
+} // namespace avx2
+
+#endif // AGL_SIMD_X86
+
+size_t UpdateParticles(const ParticleUpdateArrays &arrays, const ParticleUpdateParams &params, uint32_t *dead) {
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        return avx2::UpdateParticles(arrays, params, dead);
+    case simd::InstructionSet::SSE2:
+        return sse2::UpdateParticles(arrays, params, dead);
+#endif
+    default:
+        return scalar::UpdateParticles(arrays, params, dead);
+    }
+}
+
+// Map a float to an unsigned key with the same ordering
+uint32_t FloatSortKey(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits ^ ((bits >> 31) != 0 ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+// Stable LSD radix sort of indices by 32-bit key, 11 bits per pass
+void RadixSortIndices(std::vector<uint32_t> &keys, std::vector<uint32_t> &indices, std::vector<uint32_t> &keysScratch,
+                      std::vector<uint32_t> &indicesScratch) {
+    constexpr uint32_t RadixBits = 11;
+    constexpr uint32_t BucketCount = 1u << RadixBits;
+
+    const size_t count = keys.size();
+    keysScratch.resize(count);
+    indicesScratch.resize(count);
+
+    uint32_t offsets[BucketCount];
+    for (uint32_t shift = 0; shift < 32; shift += RadixBits) {
+        std::fill(offsets, offsets + BucketCount, 0u);
+        for (uint32_t key : keys) {
+            offsets[(key >> shift) & (BucketCount - 1)]++;
+        }
+
+        uint32_t sum = 0;
+        for (uint32_t &offset : offsets) {
+            const uint32_t bucketSize = offset;
+            offset = sum;
+            sum += bucketSize;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t destination = offsets[(keys[i] >> shift) & (BucketCount - 1)]++;
+            keysScratch[destination] = keys[i];
+            indicesScratch[destination] = indices[i];
+        }
+        keys.swap(keysScratch);
+        indices.swap(indicesScratch);
+    }
+}
+
+uint32_t PackColor(float r, float g, float b, float a) {
+    const auto channel = [](float value) {
+        return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+    };
+    return channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24);
+}
+
+} // namespace
+
+// ========== ParticleSystem Implementation ==========
+
+ParticleSystem::ParticleSystem() {
+    // Page 0 is the built-in white texture, created by Initialize
+    m_textures.emplace_back();
+}
+
+void ParticleSystem::Initialize() {
+    m_textures[0] = Texture2D::CreateWhite();
+
+    // Unit quad; the vertex shader spans it along the camera's right and up axes
+    const float corners[] = {-0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f};
+    const uint32_t indices[] = {0, 1, 2, 2, 3, 0};
+
+    VertexBufferLayout quadLayout;
+    quadLayout.PushFloat("a_Corner", 2);
+
+    VertexBufferLayout instanceLayout;
+    instanceLayout.PushFloat("a_InstancePositionSize", 4);
+    instanceLayout.PushByte("a_InstanceColor", 4, true);
+
+    m_quadVAO = VertexArray::Create();
+    m_quadVAO->AddVertexBuffer(std::make_shared<VertexBuffer>(corners, sizeof(corners)), quadLayout);
+    m_instanceBuffer = std::make_shared<VertexBuffer>(nullptr, 0, GL_STREAM_DRAW);
+    m_quadVAO->AddInstanceBuffer(m_instanceBuffer, instanceLayout);
+    m_quadVAO->SetIndexBuffer(std::make_shared<IndexBuffer>(indices, 6));
+    m_quadVAO->Unbind();
+
+    m_shader = CreateBillboardShader();
+}
+
+uint32_t ParticleSystem::AddTexture(std::shared_ptr<Texture2D> texture) {
+    m_textures.push_back(std::move(texture));
+    return static_cast<uint32_t>(m_textures.size() - 1);
+}
+
+// ========== Emitters ==========
+
+ParticleSystem::Emitter *ParticleSystem::GetEmitter(uint32_t emitter) {
+    if (emitter >= m_emitters.size() || !m_emitters[emitter].alive) {
+        return nullptr;
+    }
+    return &m_emitters[emitter];
+}
+
+const ParticleSystem::Emitter *ParticleSystem::GetEmitter(uint32_t emitter) const {
+    if (emitter >= m_emitters.size() || !m_emitters[emitter].alive) {
+        return nullptr;
+    }
+    return &m_emitters[emitter];
+}
+
+uint32_t ParticleSystem::CreateEmitter(const ParticleEmitterDesc &desc, const glm::vec3 &position) {
+    uint32_t index;
+    if (!m_freeEmitters.empty()) {
+        index = m_freeEmitters.back();
+        m_freeEmitters.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_emitters.size());
+        m_emitters.emplace_back();
+    }
+
+    Emitter &emitter = m_emitters[index];
+    emitter.desc = desc;
+    emitter.position = position;
+    emitter.alive = true;
+    emitter.active = true;
+    emitter.destroyWhenIdle = false;
+    emitter.spawnAccumulator = 0.0f;
+    emitter.count = 0;
+    ReservePool(emitter, desc.maxParticles);
+    return index;
+}
+
+void ParticleSystem::ReleaseEmitter(uint32_t index) {
+    // Keep the pool's memory for the next emitter that reuses this index
+    Emitter &emitter = m_emitters[index];
+    emitter.alive = false;
+    emitter.count = 0;
+    m_freeEmitters.push_back(index);
+}
+
+void ParticleSystem::DestroyEmitter(uint32_t emitter) {
+    if (GetEmitter(emitter)) {
+        ReleaseEmitter(emitter);
+    }
+}
+
+void ParticleSystem::DestroyEmitterWhenIdle(uint32_t emitter) {
+    if (Emitter *e = GetEmitter(emitter)) {
+        e->active = false;
+        e->destroyWhenIdle = true;
+    }
+}
+
+bool ParticleSystem::IsEmitterAlive(uint32_t emitter) const {
+    return GetEmitter(emitter) != nullptr;
+}
+
+void ParticleSystem::SetEmitterPosition(uint32_t emitter, const glm::vec3 &position) {
+    if (Emitter *e = GetEmitter(emitter)) {
+        e->position = position;
+    }
+}
+
+void ParticleSystem::SetEmitterDesc(uint32_t emitter, const ParticleEmitterDesc &desc) {
+    if (Emitter *e = GetEmitter(emitter)) {
+        e->desc = desc;
+        e->count = std::min(e->count, static_cast<size_t>(desc.maxParticles));
+        ReservePool(*e, desc.maxParticles);
+    }
+}
+
+void ParticleSystem::SetEmitterActive(uint32_t emitter, bool active) {
+    if (Emitter *e = GetEmitter(emitter)) {
+        e->active = active;
+    }
+}
+
+size_t ParticleSystem::Burst(uint32_t emitter, size_t count) {
+    Emitter *e = GetEmitter(emitter);
+    return e ? Spawn(*e, count) : 0;
+}
+
+size_t ParticleSystem::GetParticleCount(uint32_t emitter) const {
+    const Emitter *e = GetEmitter(emitter);
+    return e ? e->count : 0;
+}
+
+size_t ParticleSystem::GetTotalParticleCount() const {
+    size_t total = 0;
+    for (const Emitter &emitter : m_emitters) {
+        total += emitter.alive ? emitter.count : 0;
+    }
+    return total;
+}
+
+size_t ParticleSystem::GetEmitterCount() const {
+    return m_emitters.size() - m_freeEmitters.size();
+}
+
+void ParticleSystem::Clear() {
+    m_emitters.clear();
+    m_freeEmitters.clear();
+    m_batches.clear();
+    m_instances.clear();
+}
+
+void ParticleSystem::ReservePool(Emitter &emitter, size_t count) {
+    const size_t paddedCount = (count + LanePadding - 1) / LanePadding * LanePadding;
+    if (emitter.ages.size() >= paddedCount) {
+        return;
+    }
+
+    for (std::vector<float> *array :
+         {&emitter.positionX, &emitter.positionY, &emitter.positionZ, &emitter.velocityX, &emitter.velocityY,
+          &emitter.velocityZ, &emitter.ages, &emitter.inverseLifetimes, &emitter.red, &emitter.green, &emitter.blue,
+          &emitter.alpha, &emitter.sizes}) {
+        array->resize(paddedCount, 0.0f);
+    }
+}
+
+float ParticleSystem::NextRandom() {
+    // xorshift64*, top 24 bits
+    m_randomState ^= m_randomState >> 12;
+    m_randomState ^= m_randomState << 25;
+    m_randomState ^= m_randomState >> 27;
+    return static_cast<float>((m_randomState * 0x2545F4914F6CDD1Dull) >> 40) * (1.0f / 16777216.0f);
+}
+
+size_t ParticleSystem::Spawn(Emitter &emitter, size_t count) {
+    const ParticleEmitterDesc &desc = emitter.desc;
+    count = std::min(count, static_cast<size_t>(desc.maxParticles) - emitter.count);
+    if (count == 0) {
+        return 0;
+    }
+
+    // Orthonormal frame around the launch direction
+    glm::vec3 axis = glm::length(desc.direction) > 0.0f ? glm::normalize(desc.direction) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::vec3 helper = std::abs(axis.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    const glm::vec3 tangent = glm::normalize(glm::cross(helper, axis));
+    const glm::vec3 bitangent = glm::cross(axis, tangent);
+    const float capHeight = 1.0f - std::cos(desc.spreadAngle);
+    const float twoPi = glm::two_pi<float>();
+
+    for (size_t n = 0; n < count; ++n) {
+        const size_t i = emitter.count++;
+
+        // Uniform direction inside the cone
+        const float height = 1.0f - capHeight * NextRandom();
+        const float radius = std::sqrt(std::max(0.0f, 1.0f - height * height));
+        const float azimuth = twoPi * NextRandom();
+        const glm::vec3 direction =
+            tangent * (radius * std::cos(azimuth)) + bitangent * (radius * std::sin(azimuth)) + axis * height;
+        const float speed = desc.minSpeed + (desc.maxSpeed - desc.minSpeed) * NextRandom();
+
+        // Uniform offset inside the spawn sphere
+        glm::vec3 position = emitter.position;
+        if (desc.spawnRadius > 0.0f) {
+            const float z = 2.0f * NextRandom() - 1.0f;
+            const float ring = std::sqrt(std::max(0.0f, 1.0f - z * z));
+            const float phi = twoPi * NextRandom();
+            const float distance = desc.spawnRadius * std::cbrt(NextRandom());
+            position += glm::vec3(ring * std::cos(phi), ring * std::sin(phi), z) * distance;
+        }
+
+        const float lifetime = desc.minLifetime + (desc.maxLifetime - desc.minLifetime) * NextRandom();
+
+        emitter.positionX[i] = position.x;
+        emitter.positionY[i] = position.y;
+        emitter.positionZ[i] = position.z;
+        emitter.velocityX[i] = direction.x * speed;
+        emitter.velocityY[i] = direction.y * speed;
+        emitter.velocityZ[i] = direction.z * speed;
+        emitter.ages[i] = 0.0f;
+        emitter.inverseLifetimes[i] = lifetime > 0.0f ? 1.0f / lifetime : 1.0e30f;
+        emitter.red[i] = desc.startColor.x;
+        emitter.green[i] = desc.startColor.y;
+        emitter.blue[i] = desc.startColor.z;
+        emitter.alpha[i] = desc.startColor.w;
+        emitter.sizes[i] = desc.startSize;
+    }
+    return count;
+}
+
+// ========== Simulation ==========
+
+void ParticleSystem::Update(float deltaTime) {
+    for (uint32_t index = 0; index < m_emitters.size(); ++index) {
+        Emitter &emitter = m_emitters[index];
+        if (!emitter.alive) {
+            continue;
+        }
+
+        SimulateEmitter(emitter, deltaTime);
+
+        if (emitter.active && emitter.desc.spawnRate > 0.0f) {
+            emitter.spawnAccumulator += emitter.desc.spawnRate * deltaTime;
+            const float whole = std::floor(emitter.spawnAccumulator);
+            emitter.spawnAccumulator -= whole;
+            Spawn(emitter, static_cast<size_t>(whole));
+        }
+
+        if (emitter.destroyWhenIdle && emitter.count == 0) {
+            ReleaseEmitter(index);
+        }
+    }
+}
+
+void ParticleSystem::SimulateEmitter(Emitter &emitter, float deltaTime) {
+    if (emitter.count == 0) {
+        return;
+    }
+
+    const ParticleEmitterDesc &desc = emitter.desc;
+    ParticleUpdateParams params;
+    params.deltaTime = deltaTime;
+    params.damping = std::exp(-desc.drag * deltaTime);
+    params.gravity = desc.gravity;
+    params.startColor = desc.startColor;
+    params.endColor = desc.endColor;
+    params.startSize = desc.startSize;
+    params.endSize = desc.endSize;
+
+    ParticleUpdateArrays arrays;
+    arrays.count = emitter.count;
+    arrays.paddedCount = (emitter.count + LanePadding - 1) / LanePadding * LanePadding;
+    arrays.positionX = emitter.positionX.data();
+    arrays.positionY = emitter.positionY.data();
+    arrays.positionZ = emitter.positionZ.data();
+    arrays.velocityX = emitter.velocityX.data();
+    arrays.velocityY = emitter.velocityY.data();
+    arrays.velocityZ = emitter.velocityZ.data();
+    arrays.ages = emitter.ages.data();
+    arrays.inverseLifetimes = emitter.inverseLifetimes.data();
+    arrays.red = emitter.red.data();
+    arrays.green = emitter.green.data();
+    arrays.blue = emitter.blue.data();
+    arrays.alpha = emitter.alpha.data();
+    arrays.sizes = emitter.sizes.data();
+
+    m_deadScratch.resize(emitter.count);
+    const size_t deadCount = UpdateParticles(arrays, params, m_deadScratch.data());
+
+    // Swap the last particle into each dead slot, highest slot first, so every
+    // particle moved down is alive
+    std::vector<float> *pool[] = {&emitter.positionX, &emitter.positionY, &emitter.positionZ, &emitter.velocityX,
+                                  &emitter.velocityY, &emitter.velocityZ, &emitter.ages, &emitter.inverseLifetimes,
+                                  &emitter.red, &emitter.green, &emitter.blue, &emitter.alpha, &emitter.sizes};
+    for (size_t d = deadCount; d > 0; --d) {
+        const size_t slot = m_deadScratch[d - 1];
+        const size_t last = --emitter.count;
+        if (slot != last) {
+            for (std::vector<float> *array : pool) {
+                (*array)[slot] = (*array)[last];
+            }
+        }
+    }
+}
+
+// ========== Rendering ==========
+
+void ParticleSystem::BuildDrawBatches(const glm::mat4 &viewMatrix) {
+    m_batches.clear();
+    m_instances.clear();
+
+    // View-space depth (distance in front of the camera) of a world position
+    const glm::vec3 depthAxis(-viewMatrix[0][2], -viewMatrix[1][2], -viewMatrix[2][2]);
+    const float depthOffset = -viewMatrix[3][2];
+
+    // Alpha emitters draw far to near, so their texture pages only batch when neighbours in depth share one;
+    // additive emitters are order independent and group by texture page
+    m_emitterOrder.clear();
+    m_emitterDepths.resize(m_emitters.size());
+    size_t instanceCount = 0;
+    for (uint32_t i = 0; i < m_emitters.size(); ++i) {
+        if (m_emitters[i].alive && m_emitters[i].count > 0) {
+            m_emitterOrder.push_back(i);
+            m_emitterDepths[i] = glm::dot(depthAxis, m_emitters[i].position) + depthOffset;
+            instanceCount += m_emitters[i].count;
+        }
+    }
+
+    std::sort(m_emitterOrder.begin(), m_emitterOrder.end(), [this](uint32_t a, uint32_t b) {
+        const ParticleEmitterDesc &descA = m_emitters[a].desc;
+        const ParticleEmitterDesc &descB = m_emitters[b].desc;
+        if (descA.blendMode != descB.blendMode) {
+            return descA.blendMode < descB.blendMode;
+        }
+        const bool depthFirst = descA.blendMode == ParticleBlendMode::Alpha;
+        if (depthFirst && m_emitterDepths[a] != m_emitterDepths[b]) {
+            return m_emitterDepths[a] > m_emitterDepths[b];
+        }
+        if (descA.texture != descB.texture) {
+            return descA.texture < descB.texture;
+        }
+        if (m_emitterDepths[a] != m_emitterDepths[b]) {
+            return m_emitterDepths[a] > m_emitterDepths[b];
+        }
+        return a < b;
+    });
+
+    m_instances.resize(instanceCount);
+    size_t cursor = 0;
+    for (uint32_t index : m_emitterOrder) {
+        const Emitter &emitter = m_emitters[index];
+        const uint32_t texture = emitter.desc.texture < m_textures.size() ? emitter.desc.texture : 0;
+        if (m_batches.empty() || m_batches.back().texture != texture ||
+            m_batches.back().blendMode != emitter.desc.blendMode) {
+            m_batches.push_back(DrawBatch{texture, emitter.desc.blendMode, cursor, 0});
+        }
+
+        const size_t count = emitter.count;
+        m_sortIndices.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            m_sortIndices[i] = static_cast<uint32_t>(i);
+        }
+
+        // Alpha blending needs back to front order; additive blending is order independent
+        if (emitter.desc.blendMode == ParticleBlendMode::Alpha && count > 1) {
+            m_sortKeys.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                const float depth = depthAxis.x * emitter.positionX[i] + depthAxis.y * emitter.positionY[i] +
+                                    depthAxis.z * emitter.positionZ[i];
+                m_sortKeys[i] = ~FloatSortKey(depth); // Descending
+            }
+            RadixSortIndices(m_sortKeys, m_sortIndices, m_sortKeysScratch, m_sortIndicesScratch);
+        }
+
+        for (size_t n = 0; n < count; ++n) {
+            const uint32_t i = m_sortIndices[n];
+            ParticleInstance &instance = m_instances[cursor++];
+            instance.positionSize =
+                glm::vec4(emitter.positionX[i], emitter.positionY[i], emitter.positionZ[i], emitter.sizes[i]);
+            instance.color = PackColor(emitter.red[i], emitter.green[i], emitter.blue[i], emitter.alpha[i]);
+        }
+        m_batches.back().instanceCount += count;
+    }
+}
+
+void ParticleSystem::Render(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix) {
+    m_renderStats = ParticleRenderStats{};
+    BuildDrawBatches(viewMatrix);
+    if (!m_shader || !m_quadVAO || m_batches.empty()) {
+        return;
+    }
+
+    m_shader->Use();
+    m_shader->SetUniform("view", viewMatrix);
+    m_shader->SetUniform("projection", projectionMatrix);
+    m_shader->SetUniform("cameraRight", glm::vec3(viewMatrix[0][0], viewMatrix[1][0], viewMatrix[2][0]));
+    m_shader->SetUniform("cameraUp", glm::vec3(viewMatrix[0][1], viewMatrix[1][1], viewMatrix[2][1]));
+    m_shader->SetUniform("particleTexture", 0);
+
+    // Particles test against the scene but do not occlude each other
+    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);
+
+    for (const DrawBatch &batch : m_batches) {
+        if (batch.blendMode == ParticleBlendMode::Additive) {
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        } else {
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+
+        if (m_textures[batch.texture]) {
+            m_textures[batch.texture]->Bind(0);
+        }
+
+        // Re-specifying the store each draw lets the driver orphan the previous one
+        m_instanceBuffer->SetData(&m_instances[batch.firstInstance], batch.instanceCount * sizeof(ParticleInstance),
+                                  GL_STREAM_DRAW);
+        m_quadVAO->DrawElementsInstanced(GL_TRIANGLES, 6, static_cast<uint32_t>(batch.instanceCount));
+
+        m_renderStats.drawCalls++;
+        m_renderStats.instanceCount += static_cast<uint32_t>(batch.instanceCount);
+    }
+
+    m_quadVAO->Unbind();
+    glDepthMask(GL_TRUE);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_BLEND);
+}
+
+std::unique_ptr<ShaderProgram> ParticleSystem::CreateBillboardShader() {
+    const std::string vertexSource = R"(
+        #version 330 core
+
+        layout (location = 0) in vec2 a_Corner;
+        layout (location = 1) in vec4 a_InstancePositionSize;
+        layout (location = 2) in vec4 a_InstanceColor;
+
+        out vec2 TexCoord;
+        out vec4 Color;
+
+        uniform mat4 view;
+        uniform mat4 projection;
+        uniform vec3 cameraRight;
+        uniform vec3 cameraUp;
+
+        void main() {
+            vec3 offset = (cameraRight * a_Corner.x + cameraUp * a_Corner.y) * a_InstancePositionSize.w;
+            TexCoord = a_Corner + 0.5;
+            Color = a_InstanceColor;
+            gl_Position = projection * view * vec4(a_InstancePositionSize.xyz + offset, 1.0);
+        }
+    )";
+
+    const std::string fragmentSource = R"(
+        #version 330 core
+
+        in vec2 TexCoord;
+        in vec4 Color;
+
+        out vec4 FragColor;
+
+        uniform sampler2D particleTexture;
+
+        void main() {
+            FragColor = texture(particleTexture, TexCoord) * Color;
+        }
+    )";
+
+    return ShaderProgram::CreateFromSources(vertexSource, fragmentSource);
+}
+
+} // namespace agl
@@ -0,0 +1,178 @@
+#include "PrimitiveCache.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace agl {
+
+namespace {
+
+PrimitiveDesc MakeDesc(PrimitiveType type, float a = 0.0f, float b = 0.0f, float c = 0.0f, float d = 0.0f) {
+    PrimitiveDesc desc;
+    desc.type = type;
+    desc.params[0] = a;
+    desc.params[1] = b;
+    desc.params[2] = c;
+    desc.params[3] = d;
+    return desc;
+}
+
+int ToInt(float value) {
+    return static_cast<int>(std::lround(value));
+}
+
+} // namespace
+
+// ========== PrimitiveDesc ==========
+
+PrimitiveDesc PrimitiveDesc::Triangle() {
+    return MakeDesc(PrimitiveType::Triangle);
+}
+
+PrimitiveDesc PrimitiveDesc::Quad() {
+    return MakeDesc(PrimitiveType::Quad);
+}
+
+PrimitiveDesc PrimitiveDesc::Cube() {
+    return MakeDesc(PrimitiveType::Cube);
+}
+
+PrimitiveDesc PrimitiveDesc::Sphere(float radius, int segments, int rings) {
+    return MakeDesc(PrimitiveType::Sphere, radius, static_cast<float>(segments), static_cast<float>(rings));
+}
+
+PrimitiveDesc PrimitiveDesc::Plane(float width, float height, int widthSegments, int heightSegments) {
+    return MakeDesc(PrimitiveType::Plane, width, height, static_cast<float>(widthSegments),
+                    static_cast<float>(heightSegments));
+}
+
+PrimitiveDesc PrimitiveDesc::Cylinder(float radius, float height, int segments, int rings) {
+    return MakeDesc(PrimitiveType::Cylinder, radius, height, static_cast<float>(segments), static_cast<float>(rings));
+}
+
+PrimitiveDesc PrimitiveDesc::Capsule(float radius, float height, int segments, int rings) {
+    return MakeDesc(PrimitiveType::Capsule, radius, height, static_cast<float>(segments), static_cast<float>(rings));
+}
+
+PrimitiveDesc PrimitiveDesc::Bullet(float radius, float length) {
+    return MakeDesc(PrimitiveType::Bullet, radius, length);
+}
+
+PrimitiveDesc PrimitiveDesc::Projectile(ProjectileType projectileType, float scale) {
+    return MakeDesc(PrimitiveType::Projectile, static_cast<float>(projectileType), scale);
+}
+
+PrimitiveDesc PrimitiveDesc::GroundPlane(float size, int segments) {
+    return MakeDesc(PrimitiveType::GroundPlane, size, static_cast<float>(segments));
+}
+
+bool PrimitiveDesc::operator==(const PrimitiveDesc &other) const {
+    if (type != other.type) {
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (params[i] != other.params[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t PrimitiveDescHash::operator()(const PrimitiveDesc &desc) const {
+    // FNV-1a over the type and the parameter bits; adding 0.0f folds -0.0f into 0.0f, which compares equal
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint32_t value) {
+        for (int byte = 0; byte < 4; ++byte) {
+            hash ^= (value >> (byte * 8)) & 0xffu;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(static_cast<uint32_t>(desc.type));
+    for (float param : desc.params) {
+        const float normalized = param + 0.0f;
+        uint32_t bits;
+        std::memcpy(&bits, &normalized, sizeof(bits));
+        mix(bits);
+    }
+    return static_cast<size_t>(hash);
+}
+
+// ========== PrimitiveCache ==========
+
+PrimitiveCache &PrimitiveCache::Instance() {
+    static PrimitiveCache instance;
+    return instance;
+}
+
+std::shared_ptr<const Mesh> PrimitiveCache::GetGeometry(const PrimitiveDesc &desc) {
+    std::weak_ptr<const Mesh> &entry = m_entries[desc];
+    if (std::shared_ptr<const Mesh> geometry = entry.lock()) {
+        m_stats.hits++;
+        return geometry;
+    }
+
+    m_stats.misses++;
+    auto geometry = std::make_shared<Mesh>(Generate(desc));
+    geometry->SetResidency(m_residency);
+    entry = geometry;
+    return geometry;
+}
+
+Mesh PrimitiveCache::CreateMesh(const PrimitiveDesc &desc, const Material &material) {
+    Mesh mesh = Mesh::CreateShared(GetGeometry(desc));
+    mesh.SetMaterial(material);
+    return mesh;
+}
+
+size_t PrimitiveCache::GetLiveCount() const {
+    size_t count = 0;
+    for (const auto &entry : m_entries) {
+        if (!entry.second.expired()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t PrimitiveCache::Trim() {
+    size_t removed = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.expired()) {
+            it = m_entries.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+Mesh PrimitiveCache::Generate(const PrimitiveDesc &desc) {
+    const float *p = desc.params;
+    switch (desc.type) {
+    case PrimitiveType::Triangle:
+        return Mesh::CreateTriangle();
+    case PrimitiveType::Quad:
+        return Mesh::CreateQuad();
+    case PrimitiveType::Cube:
+        return Mesh::CreateCube();
+    case PrimitiveType::Sphere:
+        return Mesh::CreateSphere(p[0], ToInt(p[1]), ToInt(p[2]));
+    case PrimitiveType::Plane:
+        return Mesh::CreatePlane(p[0], p[1], ToInt(p[2]), ToInt(p[3]));
+    case PrimitiveType::Cylinder:
+        return Mesh::CreateCylinder(p[0], p[1], ToInt(p[2]), ToInt(p[3]));
+    case PrimitiveType::Capsule:
+        return Mesh::CreateCapsule(p[0], p[1], ToInt(p[2]), ToInt(p[3]));
+    case PrimitiveType::Bullet:
+        return Mesh::CreateBullet(p[0], p[1]);
+    case PrimitiveType::Projectile:
+        return Mesh::CreateProjectile(static_cast<ProjectileType>(ToInt(p[0])), p[1]);
+    case PrimitiveType::GroundPlane:
+        return Mesh::CreateGroundPlane(p[0], ToInt(p[1]));
+    }
+    return Mesh();
+}
+
+} // namespace agl
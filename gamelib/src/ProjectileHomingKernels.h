@@ -0,0 +1,90 @@
+// Homing steering kernel, compiled once per instruction set.
+//
+// No include guard: ProjectileKernels.cpp includes this file once per lane
+// wrapper, inside a namespace named after the instruction set, with
+// AGL_HOMING_LANES set to a simd::*Lanes type and AGL_HOMING_TARGET to the
+// matching target attribute.
+
+using L = AGL_HOMING_LANES;
+using Float = L::Float;
+using Mask = L::Mask;
+
+// Rotate each velocity toward its target by at most maxTurn radians, keeping speed
+AGL_HOMING_TARGET size_t SteerHoming(const SteeringArrays &arrays, size_t begin, size_t end) {
+    const Float zero = L::Set1(0.0f);
+    const Float one = L::Set1(1.0f);
+    const Float epsilon = L::Set1(1e-12f);
+
+    size_t i = begin;
+    for (; i + L::Width <= end; i += L::Width) {
+        const Float vx = L::Load(arrays.velocityX + i);
+        const Float vy = L::Load(arrays.velocityY + i);
+        const Float vz = L::Load(arrays.velocityZ + i);
+        const Float speedSquared = L::Add(L::Add(L::Mul(vx, vx), L::Mul(vy, vy)), L::Mul(vz, vz));
+        const Float speed = L::Sqrt(speedSquared);
+        const Float inverseSpeed = L::Div(one, speed);
+        const Float dx = L::Mul(vx, inverseSpeed);
+        const Float dy = L::Mul(vy, inverseSpeed);
+        const Float dz = L::Mul(vz, inverseSpeed);
+
+        // Unit vector to the target
+        Float wx = L::Sub(L::Load(arrays.targetX + i), L::Load(arrays.positionX + i));
+        Float wy = L::Sub(L::Load(arrays.targetY + i), L::Load(arrays.positionY + i));
+        Float wz = L::Sub(L::Load(arrays.targetZ + i), L::Load(arrays.positionZ + i));
+        const Float distanceSquared = L::Add(L::Add(L::Mul(wx, wx), L::Mul(wy, wy)), L::Mul(wz, wz));
+        const Float inverseDistance = L::Div(one, L::Sqrt(distanceSquared));
+        wx = L::Mul(wx, inverseDistance);
+        wy = L::Mul(wy, inverseDistance);
+        wz = L::Mul(wz, inverseDistance);
+
+        // Component of the target direction perpendicular to the heading; when the
+        // target is straight behind, turn about an arbitrary perpendicular instead
+        const Float cosAngle = L::Add(L::Add(L::Mul(dx, wx), L::Mul(dy, wy)), L::Mul(dz, wz));
+        Float px = L::Sub(wx, L::Mul(dx, cosAngle));
+        Float py = L::Sub(wy, L::Mul(dy, cosAngle));
+        Float pz = L::Sub(wz, L::Mul(dz, cosAngle));
+        Float perpSquared = L::Add(L::Add(L::Mul(px, px), L::Mul(py, py)), L::Mul(pz, pz));
+
+        const Mask degenerate = L::LessEqual(perpSquared, L::Set1(1e-10f));
+        const Mask nearZAxis = L::Greater(L::Mul(dz, dz), L::Set1(0.81f));
+        const Float ax = L::Select(nearZAxis, zero, L::Sub(zero, dy));
+        const Float ay = L::Select(nearZAxis, L::Sub(zero, dz), dx);
+        const Float az = L::Select(nearZAxis, dy, zero);
+        px = L::Select(degenerate, ax, px);
+        py = L::Select(degenerate, ay, py);
+        pz = L::Select(degenerate, az, pz);
+        perpSquared = L::Add(L::Add(L::Mul(px, px), L::Mul(py, py)), L::Mul(pz, pz));
+        const Float inversePerp = L::Div(one, L::Sqrt(perpSquared));
+
+        // Turn by min(maxTurn, pi/2) using Taylor series accurate to ~1e-4 over that range
+        const Float turn = L::Min(L::Load(arrays.maxTurn + i), L::Set1(1.57079632679f));
+        const Float t2 = L::Mul(turn, turn);
+        Float sine = L::Add(L::Set1(1.0f / 120.0f), L::Mul(t2, L::Set1(-1.0f / 5040.0f)));
+        sine = L::Add(L::Set1(-1.0f / 6.0f), L::Mul(t2, sine));
+        sine = L::Add(turn, L::Mul(L::Mul(turn, t2), sine));
+        Float cosine = L::Add(L::Set1(-1.0f / 720.0f), L::Mul(t2, L::Set1(1.0f / 40320.0f)));
+        cosine = L::Add(L::Set1(1.0f / 24.0f), L::Mul(t2, cosine));
+        cosine = L::Add(L::Set1(-0.5f), L::Mul(t2, cosine));
+        cosine = L::Add(one, L::Mul(t2, cosine));
+
+        const Float sinePerp = L::Mul(sine, inversePerp);
+        Float nx = L::Add(L::Mul(dx, cosine), L::Mul(px, sinePerp));
+        Float ny = L::Add(L::Mul(dy, cosine), L::Mul(py, sinePerp));
+        Float nz = L::Add(L::Mul(dz, cosine), L::Mul(pz, sinePerp));
+
+        // Within reach this frame: face the target exactly
+        const Mask reached = L::GreaterEqual(cosAngle, cosine);
+        nx = L::Select(reached, wx, nx);
+        ny = L::Select(reached, wy, ny);
+        nz = L::Select(reached, wz, nz);
+
+        const Float scale = L::Div(speed, L::Sqrt(L::Add(L::Add(L::Mul(nx, nx), L::Mul(ny, ny)), L::Mul(nz, nz))));
+
+        // Stationary missiles and missiles sitting on their target keep their velocity
+        const Mask valid = L::And(L::Greater(speedSquared, epsilon), L::Greater(distanceSquared, epsilon));
+        L::Store(arrays.velocityX + i, L::Select(valid, L::Mul(nx, scale), vx));
+        L::Store(arrays.velocityY + i, L::Select(valid, L::Mul(ny, scale), vy));
+        L::Store(arrays.velocityZ + i, L::Select(valid, L::Mul(nz, scale), vz));
+    }
+    return i;
+}
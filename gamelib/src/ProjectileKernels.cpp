@@ -0,0 +1,184 @@
+#include "ProjectileKernels.h"
+#include "SimdLanes.h"
+#include <cstring>
+
+#if defined(AGL_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace agl {
+namespace kernels {
+
+namespace {
+
+// ========== Scalar ==========
+
+// Scalar loops double as the tail of the vector paths, so all paths share the
+// same multiply-then-add sequence and give bit-identical results
+void AdvanceScalar(float *values, const float *rates, size_t begin, size_t end, float deltaTime) {
+    for (size_t i = begin; i < end; ++i) {
+        values[i] += rates[i] * deltaTime;
+    }
+}
+
+#if defined(AGL_SIMD_X86)
+
+// ========== SSE2 ==========
+
+AGL_TARGET_SSE2 void AdvanceSSE2(float *values, const float *rates, size_t begin, size_t end, float deltaTime) {
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 value = _mm_loadu_ps(values + i);
+        value = _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(rates + i), dt));
+        _mm_storeu_ps(values + i, value);
+    }
+    AdvanceScalar(values, rates, i, end, deltaTime);
+}
+
+// ========== AVX2 ==========
+
+AGL_TARGET_AVX2 void AdvanceAVX2(float *values, const float *rates, size_t begin, size_t end, float deltaTime) {
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 value = _mm256_loadu_ps(values + i);
+        value = _mm256_add_ps(value, _mm256_mul_ps(_mm256_loadu_ps(rates + i), dt));
+        _mm256_storeu_ps(values + i, value);
+    }
+    AdvanceScalar(values, rates, i, end, deltaTime);
+}
+
+#endif // AGL_SIMD_X86
+
+// ========== Spread directions ==========
+
+namespace scalar {
+#define AGL_SPREAD_LANES simd::ScalarLanes
+#define AGL_SPREAD_TARGET
+#include "ProjectileSpreadKernels.h"
+#undef AGL_SPREAD_LANES
+#undef AGL_SPREAD_TARGET
+} // namespace scalar
+
+#if defined(AGL_SIMD_X86)
+
+namespace sse2 {
+#define AGL_SPREAD_LANES simd::SSE2Lanes
+#define AGL_SPREAD_TARGET AGL_TARGET_SSE2
+#include "ProjectileSpreadKernels.h"
+#undef AGL_SPREAD_LANES
+#undef AGL_SPREAD_TARGET
+} // namespace sse2
+
+namespace avx2 {
+#define AGL_SPREAD_LANES simd::AVX2Lanes
+#define AGL_SPREAD_TARGET AGL_TARGET_AVX2
+#include "ProjectileSpreadKernels.h"
+#undef AGL_SPREAD_LANES
+#undef AGL_SPREAD_TARGET
+} // namespace avx2
+
+#endif // AGL_SIMD_X86
+
+// ========== Homing ==========
+
+namespace scalar {
+#define AGL_HOMING_LANES simd::ScalarLanes
+#define AGL_HOMING_TARGET
+#include "ProjectileHomingKernels.h"
+#undef AGL_HOMING_LANES
+#undef AGL_HOMING_TARGET
+} // namespace scalar
+
+#if defined(AGL_SIMD_X86)
+
+namespace sse2 {
+#define AGL_HOMING_LANES simd::SSE2Lanes
+#define AGL_HOMING_TARGET AGL_TARGET_SSE2
+#include "ProjectileHomingKernels.h"
+#undef AGL_HOMING_LANES
+#undef AGL_HOMING_TARGET
+} // namespace sse2
+
+namespace avx2 {
+#define AGL_HOMING_LANES simd::AVX2Lanes
+#define AGL_HOMING_TARGET AGL_TARGET_AVX2
+#include "ProjectileHomingKernels.h"
+#undef AGL_HOMING_LANES
+#undef AGL_HOMING_TARGET
+} // namespace avx2
+
+#endif // AGL_SIMD_X86
+
+} // namespace
+
+void IntegrateProjectiles(float *positions, float *previousPositions, const float *velocities, float *rotations,
+                          const float *rotationSpeeds, size_t begin, size_t end, float deltaTime) {
+    // Positions and velocities are packed xyz triples, so they can be streamed
+    // as one flat float array with no per-component shuffling
+    const size_t componentBegin = begin * 3;
+    const size_t componentEnd = end * 3;
+
+    // Keep the start of this step for swept collision tests
+    std::memcpy(previousPositions + componentBegin, positions + componentBegin,
+                (componentEnd - componentBegin) * sizeof(float));
+
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        AdvanceAVX2(positions, velocities, componentBegin, componentEnd, deltaTime);
+        AdvanceAVX2(rotations, rotationSpeeds, begin, end, deltaTime);
+        break;
+    case simd::InstructionSet::SSE2:
+        AdvanceSSE2(positions, velocities, componentBegin, componentEnd, deltaTime);
+        AdvanceSSE2(rotations, rotationSpeeds, begin, end, deltaTime);
+        break;
+#endif
+    default:
+        AdvanceScalar(positions, velocities, componentBegin, componentEnd, deltaTime);
+        AdvanceScalar(rotations, rotationSpeeds, begin, end, deltaTime);
+        break;
+    }
+}
+
+void GenerateSpreadDirections(const float *turns, const float *heights, size_t count, const glm::vec3 &tangent,
+                              const glm::vec3 &bitangent, const glm::vec3 &axis, float *x, float *y, float *z) {
+    const float frame[9] = {tangent.x, tangent.y, tangent.z, bitangent.x, bitangent.y, bitangent.z,
+                            axis.x,    axis.y,    axis.z};
+
+    size_t done = 0;
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        done = avx2::GenerateSpreadDirections(turns, heights, 0, count, frame, x, y, z);
+        break;
+    case simd::InstructionSet::SSE2:
+        done = sse2::GenerateSpreadDirections(turns, heights, 0, count, frame, x, y, z);
+        break;
+#endif
+    default:
+        break;
+    }
+    scalar::GenerateSpreadDirections(turns, heights, done, count, frame, x, y, z);
+}
+
+void SteerHomingProjectiles(const SteeringArrays &arrays, size_t count) {
+    size_t done = 0;
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        done = avx2::SteerHoming(arrays, 0, count);
+        break;
+    case simd::InstructionSet::SSE2:
+        done = sse2::SteerHoming(arrays, 0, count);
+        break;
+#endif
+    default:
+        break;
+    }
+    scalar::SteerHoming(arrays, done, count);
+}
+
+} // namespace kernels
+} // namespace agl
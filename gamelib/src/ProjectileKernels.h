@@ -0,0 +1,87 @@
+#ifndef PROJECTILE_KERNELS_H
+#define PROJECTILE_KERNELS_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+namespace agl {
+namespace kernels {
+
+/**
+ * @brief Advance projectiles [begin, end) by one step
+ *
+ * Copies each position into previousPositions, then applies
+ * position += velocity * dt and rotation += rotationSpeed * dt. Lifetimes are
+ * not touched; expiry is scheduled separately. Uses the instruction set
+ * reported by simd::GetInstructionSet(); every path and every split of the
+ * range produces identical results.
+ *
+ * @param positions Packed xyz positions (3 floats per projectile)
+ * @param previousPositions Receives the positions before the step (same layout)
+ * @param velocities Packed xyz velocities (3 floats per projectile)
+ * @param rotations Rotation angles
+ * @param rotationSpeeds Rotation speeds
+ * @param begin First projectile index
+ * @param end One past the last projectile index
+ * @param deltaTime Time step
+ */
+void IntegrateProjectiles(float *positions, float *previousPositions, const float *velocities, float *rotations,
+                          const float *rotationSpeeds, size_t begin, size_t end, float deltaTime);
+
+/**
+ * @brief Build unit directions on a sphere around an orthonormal frame
+ *
+ * Direction i is tangent * r cos(phi) + bitangent * r sin(phi) + axis * h, with
+ * phi = 2 * pi * turns[i], h = heights[i] and r = sqrt(1 - h^2). Sine and cosine
+ * come from a polynomial accurate to about 3e-7, evaluated with the instruction
+ * set reported by simd::GetInstructionSet().
+ *
+ * @param turns Azimuth of each direction as a fraction of a full turn, in [0, 1)
+ * @param heights Cosine of each direction's angle from the axis
+ * @param count Number of directions
+ * @param tangent Frame vector at azimuth 0
+ * @param bitangent Frame vector at a quarter turn
+ * @param axis Frame vector at height 1
+ * @param x Receives the x components
+ * @param y Receives the y components
+ * @param z Receives the z components
+ */
+void GenerateSpreadDirections(const float *turns, const float *heights, size_t count, const glm::vec3 &tangent,
+                              const glm::vec3 &bitangent, const glm::vec3 &axis, float *x, float *y, float *z);
+
+/**
+ * @brief Compact SoA view of the homing projectiles steered in one batch
+ *
+ * Every array holds one entry per missile; SteerHomingProjectiles() rewrites
+ * the velocity arrays in place.
+ */
+struct SteeringArrays {
+    float *velocityX;
+    float *velocityY;
+    float *velocityZ;
+    const float *positionX;
+    const float *positionY;
+    const float *positionZ;
+    const float *targetX;
+    const float *targetY;
+    const float *targetZ;
+    const float *maxTurn; // Largest turn this step, in radians
+};
+
+/**
+ * @brief Turn each velocity toward its target by at most maxTurn radians
+ *
+ * Speed is preserved. A missile already within maxTurn of its target is pointed
+ * straight at it; one with zero speed or sitting on its target is left alone.
+ * Turns are capped at pi/2 per step. Uses the instruction set reported by
+ * simd::GetInstructionSet().
+ *
+ * @param arrays Missile data
+ * @param count Number of missiles
+ */
+void SteerHomingProjectiles(const SteeringArrays &arrays, size_t count);
+
+} // namespace kernels
+} // namespace agl
+
+#endif // PROJECTILE_KERNELS_H
@@ -0,0 +1,71 @@
+// Spread-pattern direction kernel, compiled once per instruction set.
+//
+// No include guard: ProjectileKernels.cpp includes this file once per lane
+// wrapper, inside a namespace named after the instruction set, with
+// AGL_SPREAD_LANES set to a simd::*Lanes type and AGL_SPREAD_TARGET to the
+// matching target attribute.
+
+using L = AGL_SPREAD_LANES;
+using Float = L::Float;
+using Mask = L::Mask;
+
+// Sine and cosine of 2*pi*turns for turns in [0, 1). The turn is split into a
+// quadrant and an offset in [-pi/4, pi/4) around the quadrant's midpoint, where
+// short Taylor polynomials are accurate to about 3e-7.
+AGL_SPREAD_TARGET inline void SinCosTurns(Float turns, Float &sine, Float &cosine) {
+    const Float zero = L::Set1(0.0f);
+    const Float quarters = L::Mul(turns, L::Set1(4.0f));
+    const Float quadrant = L::Floor(quarters);
+    const Float a = L::Mul(L::Sub(L::Sub(quarters, quadrant), L::Set1(0.5f)), L::Set1(1.57079632679f));
+    const Float a2 = L::Mul(a, a);
+
+    Float s = L::Add(L::Set1(1.0f / 120.0f), L::Mul(a2, L::Set1(-1.0f / 5040.0f)));
+    s = L::Add(L::Set1(-1.0f / 6.0f), L::Mul(a2, s));
+    s = L::Add(a, L::Mul(L::Mul(a, a2), s));
+
+    Float c = L::Add(L::Set1(-1.0f / 720.0f), L::Mul(a2, L::Set1(1.0f / 40320.0f)));
+    c = L::Add(L::Set1(1.0f / 24.0f), L::Mul(a2, c));
+    c = L::Add(L::Set1(-0.5f), L::Mul(a2, c));
+    c = L::Add(L::Set1(1.0f), L::Mul(a2, c));
+
+    // Shift by the eighth turn to the quadrant midpoint
+    const Float halfSqrt2 = L::Set1(0.70710678118f);
+    const Float s1 = L::Mul(L::Add(s, c), halfSqrt2);
+    const Float c1 = L::Mul(L::Sub(c, s), halfSqrt2);
+
+    // Rotate by whole quadrants: (sin, cos) -> (cos, -sin) -> (-sin, -cos) -> (-cos, sin)
+    const Mask q1 = L::Equal(quadrant, L::Set1(1.0f));
+    const Mask q2 = L::Equal(quadrant, L::Set1(2.0f));
+    const Mask q3 = L::Equal(quadrant, L::Set1(3.0f));
+    const Float ns1 = L::Sub(zero, s1);
+    const Float nc1 = L::Sub(zero, c1);
+    sine = L::Select(q1, c1, L::Select(q2, ns1, L::Select(q3, nc1, s1)));
+    cosine = L::Select(q1, ns1, L::Select(q2, nc1, L::Select(q3, s1, c1)));
+}
+
+// Directions on the unit sphere around an orthonormal frame: azimuth from turns,
+// polar cosine from heights. Outputs are structure-of-arrays.
+AGL_SPREAD_TARGET size_t GenerateSpreadDirections(const float *turns, const float *heights, size_t begin, size_t end,
+                                                  const float *frame, float *x, float *y, float *z) {
+    const Float tx = L::Set1(frame[0]), ty = L::Set1(frame[1]), tz = L::Set1(frame[2]);
+    const Float bx = L::Set1(frame[3]), by = L::Set1(frame[4]), bz = L::Set1(frame[5]);
+    const Float ax = L::Set1(frame[6]), ay = L::Set1(frame[7]), az = L::Set1(frame[8]);
+    const Float one = L::Set1(1.0f);
+    const Float zero = L::Set1(0.0f);
+
+    size_t i = begin;
+    for (; i + L::Width <= end; i += L::Width) {
+        Float sine, cosine;
+        SinCosTurns(L::Load(turns + i), sine, cosine);
+
+        const Float h = L::Load(heights + i);
+        const Float radius = L::Sqrt(L::Max(L::Sub(one, L::Mul(h, h)), zero));
+        const Float lx = L::Mul(radius, cosine);
+        const Float ly = L::Mul(radius, sine);
+
+        L::Store(x + i, L::Add(L::Add(L::Mul(tx, lx), L::Mul(bx, ly)), L::Mul(ax, h)));
+        L::Store(y + i, L::Add(L::Add(L::Mul(ty, lx), L::Mul(by, ly)), L::Mul(ay, h)));
+        L::Store(z + i, L::Add(L::Add(L::Mul(tz, lx), L::Mul(bz, ly)), L::Mul(az, h)));
+    }
+    return i;
+}
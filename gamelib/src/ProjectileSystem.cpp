@@ -1,5 +1,9 @@
 #include "ProjectileSystem.h"
+#include "PrimitiveCache.h"
+#include "ProjectileKernels.h"
+#include <glm/gtc/constants.hpp>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #if defined(__APPLE__)
@@ -11,30 +15,182 @@
 
 namespace agl {
 
+// Kernels stream glm::vec3 arrays as packed floats
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
+
+// Resolution of lifetime expiry; projectiles die in the first Update at or after
+// the end of their lifetime, rounded up to a tick
+static constexpr double ExpiryTicksPerSecond = 120.0;
+
+// Squared length below which a firing direction is treated as zero and cannot be normalized
+static constexpr float MinDirectionLengthSquared = 1e-12f;
+
+// ========== ProjectileStorage Implementation ==========
+
+void ProjectileStorage::Resize(size_t size) {
+    positions.resize(size);
+    origins.resize(size);
+    spawnTimes.resize(size);
+    previousPositions.resize(size);
+    velocities.resize(size);
+    directions.resize(size);
+    maxLifetimes.resize(size);
+    rotations.resize(size);
+    rotationSpeeds.resize(size);
+    scales.resize(size);
+    types.resize(size);
+    slots.resize(size);
+}
+
+void ProjectileStorage::Reserve(size_t capacity) {
+    positions.reserve(capacity);
+    origins.reserve(capacity);
+    spawnTimes.reserve(capacity);
+    previousPositions.reserve(capacity);
+    velocities.reserve(capacity);
+    directions.reserve(capacity);
+    maxLifetimes.reserve(capacity);
+    rotations.reserve(capacity);
+    rotationSpeeds.reserve(capacity);
+    scales.reserve(capacity);
+    types.reserve(capacity);
+    slots.reserve(capacity);
+}
+
+void ProjectileStorage::Clear() {
+    positions.clear();
+    origins.clear();
+    spawnTimes.clear();
+    previousPositions.clear();
+    velocities.clear();
+    directions.clear();
+    maxLifetimes.clear();
+    rotations.clear();
+    rotationSpeeds.clear();
+    scales.clear();
+    types.clear();
+    slots.clear();
+}
+
+void ProjectileStorage::PushBack(const Projectile &projectile, uint32_t slot, double spawnTime) {
+    positions.push_back(projectile.position);
+    origins.push_back(projectile.position);
+    spawnTimes.push_back(spawnTime);
+    previousPositions.push_back(projectile.position);
+    velocities.push_back(projectile.velocity);
+    directions.push_back(projectile.direction);
+    maxLifetimes.push_back(projectile.maxLifetime);
+    rotations.push_back(projectile.rotation);
+    rotationSpeeds.push_back(projectile.rotationSpeed);
+    scales.push_back(projectile.scale);
+    types.push_back(projectile.type);
+    slots.push_back(slot);
+}
+
+void ProjectileStorage::SwapAndPop(size_t index) {
+    const size_t last = Size() - 1;
+    if (index != last) {
+        Move(last, index);
+    }
+    PopBack();
+}
+
+void ProjectileStorage::Move(size_t from, size_t to) {
+    positions[to] = positions[from];
+    origins[to] = origins[from];
+    spawnTimes[to] = spawnTimes[from];
+    previousPositions[to] = previousPositions[from];
+    velocities[to] = velocities[from];
+    directions[to] = directions[from];
+    maxLifetimes[to] = maxLifetimes[from];
+    rotations[to] = rotations[from];
+    rotationSpeeds[to] = rotationSpeeds[from];
+    scales[to] = scales[from];
+    types[to] = types[from];
+    slots[to] = slots[from];
+}
+
+void ProjectileStorage::Swap(size_t a, size_t b) {
+    std::swap(positions[a], positions[b]);
+    std::swap(origins[a], origins[b]);
+    std::swap(spawnTimes[a], spawnTimes[b]);
+    std::swap(previousPositions[a], previousPositions[b]);
+    std::swap(velocities[a], velocities[b]);
+    std::swap(directions[a], directions[b]);
+    std::swap(maxLifetimes[a], maxLifetimes[b]);
+    std::swap(rotations[a], rotations[b]);
+    std::swap(rotationSpeeds[a], rotationSpeeds[b]);
+    std::swap(scales[a], scales[b]);
+    std::swap(types[a], types[b]);
+    std::swap(slots[a], slots[b]);
+}
+
+void ProjectileStorage::PopBack() {
+    positions.pop_back();
+    origins.pop_back();
+    spawnTimes.pop_back();
+    previousPositions.pop_back();
+    velocities.pop_back();
+    directions.pop_back();
+    maxLifetimes.pop_back();
+    rotations.pop_back();
+    rotationSpeeds.pop_back();
+    scales.pop_back();
+    types.pop_back();
+    slots.pop_back();
+}
+
+Projectile ProjectileStorage::Get(size_t index) const {
+    Projectile projectile;
+    projectile.position = positions[index];
+    projectile.velocity = velocities[index];
+    projectile.direction = directions[index];
+    projectile.type = types[index];
+    projectile.speed = glm::length(velocities[index]);
+    projectile.maxLifetime = maxLifetimes[index];
+    projectile.scale = scales[index];
+    projectile.rotation = rotations[index];
+    projectile.rotationSpeed = rotationSpeeds[index];
+    return projectile;
+}
+
 // ========== ProjectileSystem Implementation ==========
 
+uint64_t ProjectileSystem::CurrentExpiryTick() const {
+    return static_cast<uint64_t>(std::floor(m_time * ExpiryTicksPerSecond));
+}
+
 ProjectileSystem::ProjectileSystem() {
-    m_projectiles.reserve(m_maxProjectiles);
+    m_grid.SetPointRadius(0.1f);
+    ResetSlots();
 }
 
 void ProjectileSystem::Initialize(size_t maxProjectiles) {
     m_maxProjectiles = maxProjectiles;
-    m_projectiles.clear();
-    m_projectiles.reserve(maxProjectiles);
+    ResetSlots();
 
     // Create meshes for different projectile types
     CreateProjectileMeshes();
+    m_instancedShader = CreateInstancedShader();
 
     std::cout << "ProjectileSystem initialized with " << maxProjectiles << " max projectiles" << std::endl;
 }
 
 void ProjectileSystem::CreateProjectileMeshes() {
     m_projectileMeshes.clear();
+    m_instanceBuffers.clear();
 
-    // Create one mesh for each projectile type
-    for (int i = 0; i < static_cast<int>(ProjectileType::Default) + 1; ++i) {
+    // Per-instance attributes, expanded into a model matrix by the vertex shader
+    VertexBufferLayout instanceLayout;
+    instanceLayout.PushFloat("a_InstancePositionScale", 4);
+    instanceLayout.PushFloat("a_InstanceDirectionRotation", 4);
+
+    // One mesh per projectile type; the geometry is shared with every other system using the same shapes,
+    // while the material and the vertex array holding the instance buffer stay per system
+    PrimitiveCache &primitives = PrimitiveCache::Instance();
+    for (int i = 0; i < static_cast<int>(ProjectileTypeCount); ++i) {
         ProjectileType type = static_cast<ProjectileType>(i);
-        auto mesh = std::make_unique<Mesh>(Mesh::CreateProjectile(type, m_defaultScale));
+        auto mesh = std::make_unique<Mesh>(primitives.CreateMesh(PrimitiveDesc::Projectile(type, m_defaultScale)));
 
         // Set appropriate materials for different projectile types
         Material material;
@@ -67,39 +223,132 @@ void ProjectileSystem::CreateProjectileMeshes() {
         }
 
         mesh->SetMaterial(material);
+
+        auto instanceBuffer = std::make_shared<VertexBuffer>(nullptr, 0, GL_STREAM_DRAW);
+        mesh->AddInstanceBuffer(instanceBuffer, instanceLayout);
+
+        m_instanceBuffers.push_back(std::move(instanceBuffer));
         m_projectileMeshes.push_back(std::move(mesh));
     }
 }
 
 void ProjectileSystem::Update(float deltaTime) {
-    // Update all active projectiles
-    for (auto it = m_projectiles.begin(); it != m_projectiles.end();) {
-        Projectile &projectile = *it;
+    // Only simulated projectiles are integrated; analytic ones just follow the clock
+    const size_t count = m_simulatedCount;
+    m_time += deltaTime;
+    m_lastDeltaTime = deltaTime;
 
-        if (!projectile.active) {
-            it = m_projectiles.erase(it);
-            continue;
+    SteerHomingProjectiles(deltaTime);
+
+    float *positions = reinterpret_cast<float *>(m_projectiles.positions.data());
+    float *previousPositions = reinterpret_cast<float *>(m_projectiles.previousPositions.data());
+    const float *velocities = reinterpret_cast<const float *>(m_projectiles.velocities.data());
+    float *rotations = m_projectiles.rotations.data();
+    const float *rotationSpeeds = m_projectiles.rotationSpeeds.data();
+
+    // Integrate positions and rotations with the widest SIMD path available
+    ThreadPool *pool = nullptr;
+    if (count >= m_parallelThreshold) {
+        pool = m_threadPool ? m_threadPool : &ThreadPool::Shared();
+    }
+
+    if (pool && pool->GetWorkerCount() > 0) {
+        pool->ParallelFor(count, m_parallelChunkSize, [&](size_t, size_t begin, size_t end) {
+            kernels::IntegrateProjectiles(positions, previousPositions, velocities, rotations, rotationSpeeds, begin,
+                                          end, deltaTime);
+        });
+    } else {
+        kernels::IntegrateProjectiles(positions, previousPositions, velocities, rotations, rotationSpeeds, 0, count,
+                                      deltaTime);
+    }
+
+    // Only the wheel slots that came due are visited, so expiry cost scales with
+    // the number of expired projectiles rather than the number alive
+    m_expiredScratch.clear();
+    m_expiryWheel.Advance(CurrentExpiryTick(), m_expiredScratch);
+    for (uint64_t id : m_expiredScratch) {
+        ProjectileHandle handle;
+        handle.slot = static_cast<uint32_t>(id >> 32);
+        handle.generation = static_cast<uint32_t>(id);
+
+        // Projectiles removed early leave stale entries behind; their handles no longer resolve
+        const size_t index = GetIndex(handle);
+        if (index != InvalidIndex) {
+            RemoveAt(index);
         }
+    }
 
-        // Update position
-        projectile.position += projectile.velocity * deltaTime;
+    ResolveHitscans();
 
-        // Update rotation for visual effect
-        projectile.rotation += projectile.rotationSpeed * deltaTime;
+    m_analyticDirty = m_projectiles.Size() > m_simulatedCount;
+    SyncProjectiles();
+    m_gridDirty = true;
+}
 
-        // Update lifetime
-        projectile.lifetime -= deltaTime;
-        if (projectile.lifetime <= 0.0f) {
-            projectile.active = false;
-            it = m_projectiles.erase(it);
-            continue;
+void ProjectileSystem::EvaluateBallistic(const ProjectileMotionModel &model, const glm::vec3 &origin,
+                                         const glm::vec3 &launchVelocity, float age, glm::vec3 &position,
+                                         glm::vec3 &velocity) {
+    if (model.drag > 1e-6f) {
+        // dv/dt = g - k v  =>  v(t) = g/k + (v0 - g/k) e^(-kt)
+        const float k = model.drag;
+        const glm::vec3 terminalVelocity = model.gravity / k;
+        const float decay = std::exp(-k * age);
+        velocity = terminalVelocity + (launchVelocity - terminalVelocity) * decay;
+        position = origin + terminalVelocity * age + (launchVelocity - terminalVelocity) * ((1.0f - decay) / k);
+    } else {
+        velocity = launchVelocity + model.gravity * age;
+        position = origin + launchVelocity * age + model.gravity * (0.5f * age * age);
+    }
+}
+
+void ProjectileSystem::SyncProjectiles() {
+    if (!m_analyticDirty) {
+        return;
+    }
+
+    for (size_t i = m_simulatedCount; i < m_projectiles.Size(); ++i) {
+        const ProjectileMotionModel &model = m_motionModels[static_cast<size_t>(m_projectiles.types[i])];
+        const float age = static_cast<float>(m_time - m_projectiles.spawnTimes[i]);
+        const float previousAge = std::max(age - m_lastDeltaTime, 0.0f);
+
+        glm::vec3 velocity;
+        glm::vec3 previousVelocity;
+        EvaluateBallistic(model, m_projectiles.origins[i], m_projectiles.velocities[i], previousAge,
+                          m_projectiles.previousPositions[i], previousVelocity);
+        EvaluateBallistic(model, m_projectiles.origins[i], m_projectiles.velocities[i], age,
+                          m_projectiles.positions[i], velocity);
+
+        if (glm::dot(velocity, velocity) > 0.0f) {
+            m_projectiles.directions[i] = glm::normalize(velocity);
         }
+        m_projectiles.rotations[i] = m_projectiles.rotationSpeeds[i] * age;
+    }
+
+    m_analyticDirty = false;
+}
 
-        ++it;
+Projectile ProjectileSystem::GetProjectile(size_t index) const {
+    Projectile projectile = m_projectiles.Get(index);
+    const float age = static_cast<float>(m_time - m_projectiles.spawnTimes[index]);
+    projectile.lifetime = projectile.maxLifetime - age;
+
+    if (index >= m_simulatedCount) {
+        const ProjectileMotionModel &model = m_motionModels[static_cast<size_t>(projectile.type)];
+        EvaluateBallistic(model, m_projectiles.origins[index], m_projectiles.velocities[index], age,
+                          projectile.position, projectile.velocity);
+        projectile.speed = glm::length(projectile.velocity);
+        if (projectile.speed > 0.0f) {
+            projectile.direction = projectile.velocity / projectile.speed;
+        }
+        projectile.rotation = projectile.rotationSpeed * age;
     }
+    return projectile;
 }
 
 void ProjectileSystem::Render(ShaderProgram &shader, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix) {
+    m_renderStats = ProjectileRenderStats{};
+    SyncProjectiles();
+
     shader.Use();
     shader.SetUniform("view", viewMatrix);
     shader.SetUniform("projection", projectionMatrix);
@@ -109,42 +358,192 @@ void ProjectileSystem::Render(ShaderProgram &shader, const glm::mat4 &viewMatrix
     shader.SetUniform("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
     shader.SetUniform("viewPos", glm::vec3(0.0f, 0.0f, 5.0f)); // This should come from camera
 
-    for (const Projectile &projectile : m_projectiles) {
-        if (!projectile.active)
-            continue;
+    for (size_t i = 0; i < m_projectiles.Size(); ++i) {
+        const glm::vec3 &direction = m_projectiles.directions[i];
 
         // Create model matrix
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, projectile.position);
+        model = glm::translate(model, m_projectiles.positions[i]);
 
         // Rotate to face direction
         glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
-        glm::vec3 right = glm::normalize(glm::cross(up, projectile.direction));
-        up = glm::normalize(glm::cross(projectile.direction, right));
+        glm::vec3 right = glm::normalize(glm::cross(up, direction));
+        up = glm::normalize(glm::cross(direction, right));
 
-        glm::mat3 rotation = glm::mat3(right, up, projectile.direction);
+        glm::mat3 rotation = glm::mat3(right, up, direction);
         model = model * glm::mat4(rotation);
 
         // Apply additional rotation for visual effects
-        if (projectile.rotationSpeed != 0.0f) {
-            model = glm::rotate(model, projectile.rotation, glm::vec3(0.0f, 1.0f, 0.0f));
+        if (m_projectiles.rotationSpeeds[i] != 0.0f) {
+            model = glm::rotate(model, m_projectiles.rotations[i], glm::vec3(0.0f, 1.0f, 0.0f));
         }
 
         // Apply scale
-        model = glm::scale(model, glm::vec3(projectile.scale));
+        model = glm::scale(model, glm::vec3(m_projectiles.scales[i]));
 
         // Get appropriate mesh and render
-        Mesh *mesh = GetMeshForType(projectile.type);
+        Mesh *mesh = GetMeshForType(m_projectiles.types[i]);
         if (mesh) {
             mesh->Render(shader, model);
+            m_renderStats.drawCalls++;
         }
     }
+
+    m_renderStats.instanceCount = static_cast<uint32_t>(m_projectiles.Size());
+}
+
+void ProjectileSystem::RenderInstanced(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix) {
+    if (m_instancedShader) {
+        RenderInstanced(*m_instancedShader, viewMatrix, projectionMatrix);
+    }
 }
 
-bool ProjectileSystem::FireProjectile(const glm::vec3 &position, const glm::vec3 &direction, ProjectileType type,
-                                      float speed, float lifetime) {
-    if (m_projectiles.size() >= m_maxProjectiles) {
-        return false; // System is full
+void ProjectileSystem::RenderInstanced(ShaderProgram &shader, const glm::mat4 &viewMatrix,
+                                       const glm::mat4 &projectionMatrix) {
+    m_renderStats = ProjectileRenderStats{};
+    SyncProjectiles();
+
+    const size_t count = m_projectiles.Size();
+    if (count == 0 || m_instanceBuffers.size() != ProjectileTypeCount) {
+        return;
+    }
+
+    // Counting sort by type so each type's instances are contiguous
+    size_t typeOffsets[ProjectileTypeCount + 1] = {};
+    for (ProjectileType type : m_projectiles.types) {
+        typeOffsets[static_cast<size_t>(type) + 1]++;
+    }
+    for (size_t t = 0; t < ProjectileTypeCount; ++t) {
+        typeOffsets[t + 1] += typeOffsets[t];
+    }
+
+    // Two vec4 per instance: (position, scale) and (direction, rotation)
+    m_instanceData.resize(count * 2);
+    size_t cursor[ProjectileTypeCount];
+    std::copy(typeOffsets, typeOffsets + ProjectileTypeCount, cursor);
+    for (size_t i = 0; i < count; ++i) {
+        const size_t slot = cursor[static_cast<size_t>(m_projectiles.types[i])]++;
+        m_instanceData[slot * 2] = glm::vec4(m_projectiles.positions[i], m_projectiles.scales[i]);
+        m_instanceData[slot * 2 + 1] = glm::vec4(m_projectiles.directions[i], m_projectiles.rotations[i]);
+    }
+
+    shader.Use();
+    shader.SetUniform("view", viewMatrix);
+    shader.SetUniform("projection", projectionMatrix);
+
+    // Set lighting (simple setup for projectiles)
+    shader.SetUniform("lightPos", glm::vec3(0.0f, 10.0f, 0.0f));
+    shader.SetUniform("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
+    shader.SetUniform("viewPos", glm::vec3(glm::inverse(viewMatrix)[3]));
+
+    for (size_t t = 0; t < ProjectileTypeCount; ++t) {
+        const size_t instanceCount = typeOffsets[t + 1] - typeOffsets[t];
+        if (instanceCount == 0) {
+            continue;
+        }
+
+        // Re-specifying the store each frame lets the driver orphan the previous one
+        m_instanceBuffers[t]->SetData(&m_instanceData[typeOffsets[t] * 2], instanceCount * 2 * sizeof(glm::vec4),
+                                      GL_STREAM_DRAW);
+
+        m_projectileMeshes[t]->RenderInstanced(shader, static_cast<uint32_t>(instanceCount));
+        m_renderStats.drawCalls++;
+    }
+
+    m_renderStats.instanceCount = static_cast<uint32_t>(count);
+}
+
+std::unique_ptr<ShaderProgram> ProjectileSystem::CreateInstancedShader() {
+    const std::string vertexSource = R"(
+        #version 330 core
+
+        layout (location = 0) in vec3 a_Position;
+        layout (location = 1) in vec3 a_Normal;
+        layout (location = 2) in vec2 a_TexCoords;
+        layout (location = 5) in vec4 a_InstancePositionScale;
+        layout (location = 6) in vec4 a_InstanceDirectionRotation;
+
+        out vec3 FragPos;
+        out vec3 Normal;
+        out vec2 TexCoord;
+
+        uniform mat4 view;
+        uniform mat4 projection;
+
+        void main() {
+            // Rotate to face direction
+            vec3 direction = a_InstanceDirectionRotation.xyz;
+            vec3 right = normalize(cross(vec3(0.0, 1.0, 0.0), direction));
+            vec3 up = normalize(cross(direction, right));
+
+            // Additional spin around the local Y axis
+            float s = sin(a_InstanceDirectionRotation.w);
+            float c = cos(a_InstanceDirectionRotation.w);
+            mat3 spin = mat3(c, 0.0, -s, 0.0, 1.0, 0.0, s, 0.0, c);
+
+            mat3 rotation = mat3(right, up, direction) * spin;
+
+            FragPos = rotation * (a_Position * a_InstancePositionScale.w) + a_InstancePositionScale.xyz;
+            Normal = rotation * a_Normal;
+            TexCoord = a_TexCoords;
+
+            gl_Position = projection * view * vec4(FragPos, 1.0);
+        }
+    )";
+
+    const std::string fragmentSource = R"(
+        #version 330 core
+
+        struct Material {
+            vec3 ambient;
+            vec3 diffuse;
+            vec3 specular;
+            float shininess;
+        };
+
+        in vec3 FragPos;
+        in vec3 Normal;
+        in vec2 TexCoord;
+
+        out vec4 FragColor;
+
+        uniform vec3 lightPos;
+        uniform vec3 lightColor;
+        uniform vec3 viewPos;
+        uniform Material material;
+
+        void main() {
+            // Ambient
+            vec3 ambient = lightColor * material.ambient;
+
+            // Diffuse
+            vec3 norm = normalize(Normal);
+            vec3 lightDir = normalize(lightPos - FragPos);
+            float diff = max(dot(norm, lightDir), 0.0);
+            vec3 diffuse = lightColor * (diff * material.diffuse);
+
+            // Specular
+            vec3 viewDir = normalize(viewPos - FragPos);
+            vec3 reflectDir = reflect(-lightDir, norm);
+            float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+            vec3 specular = lightColor * (spec * material.specular);
+
+            FragColor = vec4(ambient + diffuse + specular, 1.0);
+        }
+    )";
+
+    return ShaderProgram::CreateFromSources(vertexSource, fragmentSource);
+}
+
+ProjectileHandle ProjectileSystem::FireProjectile(const glm::vec3 &position, const glm::vec3 &direction,
+                                                  ProjectileType type, float speed, float lifetime) {
+    if (m_motionModels[static_cast<size_t>(type)].hitscan) {
+        QueueHitscan(position, direction, speed * lifetime, type);
+        return ProjectileHandle{};
+    }
+
+    if (m_freeSlots.empty()) {
+        return ProjectileHandle{}; // System is full
     }
 
     Projectile projectile(position, direction, type);
@@ -159,22 +558,537 @@ bool ProjectileSystem::FireProjectile(const glm::vec3 &position, const glm::vec3
         projectile.rotationSpeed = 5.0f; // radians per second
     }
 
-    m_projectiles.push_back(projectile);
+    const ProjectileHandle handle = AllocateHandle();
+    m_projectiles.PushBack(projectile, handle.slot, m_time);
+    const size_t index = m_projectiles.Size() - 1;
+    RelinkSlot(index);
+    ScheduleExpiry(handle, lifetime);
+
+    if (!m_motionModels[static_cast<size_t>(type)].analytic) {
+        // Keep simulated projectiles in front by swapping with the first analytic one
+        if (index != m_simulatedCount) {
+            m_projectiles.Swap(index, m_simulatedCount);
+            RelinkSlot(index);
+            RelinkSlot(m_simulatedCount);
+        }
+        ++m_simulatedCount;
+    }
+
+    m_gridDirty = true;
+    return handle;
+}
+
+size_t ProjectileSystem::FireBatch(const glm::vec3 &origin, const SpreadPattern &pattern, size_t count,
+                                   ProjectileType type, float speed, float lifetime,
+                                   std::vector<ProjectileHandle> *handles) {
+    if (m_motionModels[static_cast<size_t>(type)].hitscan) {
+        if (!BuildSpreadDirections(pattern, count)) {
+            return 0;
+        }
+        size_t queued = 0;
+        for (size_t j = 0; j < count; ++j) {
+            const glm::vec3 direction(m_spreadX[j], m_spreadY[j], m_spreadZ[j]);
+            queued += QueueHitscan(origin, direction, speed * lifetime, type) ? 1 : 0;
+        }
+        return queued;
+    }
+
+    const size_t spawnCount = std::min(count, m_freeSlots.size());
+    if (spawnCount == 0) {
+        return 0;
+    }
+
+    if (!BuildSpreadDirections(pattern, spawnCount)) {
+        return 0;
+    }
+
+    // Grow storage once and open a contiguous block for the burst. Simulated
+    // projectiles must stay in front, so the block starts at m_simulatedCount and
+    // the analytic entries it covers move to the new tail.
+    const size_t oldSize = m_projectiles.Size();
+    const size_t newSize = oldSize + spawnCount;
+    m_projectiles.Resize(newSize);
+
+    size_t first = oldSize;
+    if (!m_motionModels[static_cast<size_t>(type)].analytic) {
+        first = m_simulatedCount;
+        const size_t moved = std::min(spawnCount, oldSize - m_simulatedCount);
+        for (size_t j = 0; j < moved; ++j) {
+            const size_t to = newSize - moved + j;
+            m_projectiles.Move(first + j, to);
+            RelinkSlot(to);
+        }
+        m_simulatedCount += spawnCount;
+    }
+
+    // Add some rotation for visual effect (except for laser)
+    const float rotationSpeed = type != ProjectileType::Laser ? 5.0f : 0.0f;
+    if (handles) {
+        handles->reserve(handles->size() + spawnCount);
+    }
+
+    for (size_t j = 0; j < spawnCount; ++j) {
+        const size_t i = first + j;
+        const glm::vec3 direction(m_spreadX[j], m_spreadY[j], m_spreadZ[j]);
+
+        m_projectiles.positions[i] = origin;
+        m_projectiles.origins[i] = origin;
+        m_projectiles.spawnTimes[i] = m_time;
+        m_projectiles.previousPositions[i] = origin;
+        m_projectiles.velocities[i] = direction * speed;
+        m_projectiles.directions[i] = direction;
+        m_projectiles.maxLifetimes[i] = lifetime;
+        m_projectiles.rotations[i] = 0.0f;
+        m_projectiles.rotationSpeeds[i] = rotationSpeed;
+        m_projectiles.scales[i] = m_defaultScale;
+        m_projectiles.types[i] = type;
+
+        const ProjectileHandle handle = AllocateHandle();
+        m_projectiles.slots[i] = handle.slot;
+        RelinkSlot(i);
+        ScheduleExpiry(handle, lifetime);
+
+        if (handles) {
+            handles->push_back(handle);
+        }
+    }
+
+    m_gridDirty = true;
+    return spawnCount;
+}
+
+bool ProjectileSystem::BuildSpreadDirections(const SpreadPattern &pattern, size_t count) {
+    // A zero axis has no frame to spread around and would turn every direction into NaN
+    const float axisLengthSquared = glm::dot(pattern.direction, pattern.direction);
+    if (!(axisLengthSquared >= MinDirectionLengthSquared)) {
+        return false;
+    }
+
+    m_spreadTurns.resize(count);
+    m_spreadHeights.resize(count);
+    m_spreadX.resize(count);
+    m_spreadY.resize(count);
+    m_spreadZ.resize(count);
+
+    // Heights are cosines of the angle from the axis; the cone spans [cos(angle), 1]
+    const float cosAngle = std::cos(glm::clamp(pattern.angle, 0.0f, glm::pi<float>()));
+    const float capHeight = 1.0f - cosAngle;
+    const float inverseCount = 1.0f / static_cast<float>(count);
+
+    switch (pattern.shape) {
+    case SpreadShape::Cone:
+        // Golden-angle spiral over equal-area rings of the spherical cap
+        for (size_t i = 0; i < count; ++i) {
+            const double turn = static_cast<double>(i) * 0.6180339887498949;
+            m_spreadTurns[i] = static_cast<float>(turn - std::floor(turn));
+            m_spreadHeights[i] = 1.0f - capHeight * (static_cast<float>(i) + 0.5f) * inverseCount;
+        }
+        break;
+    case SpreadShape::Ring:
+        for (size_t i = 0; i < count; ++i) {
+            m_spreadTurns[i] = static_cast<float>(i) * inverseCount;
+            m_spreadHeights[i] = cosAngle;
+        }
+        break;
+    case SpreadShape::Random:
+        // xorshift64*, top 24 bits as a float in [0, 1)
+        for (size_t i = 0; i < count * 2; ++i) {
+            m_spreadRandomState ^= m_spreadRandomState >> 12;
+            m_spreadRandomState ^= m_spreadRandomState << 25;
+            m_spreadRandomState ^= m_spreadRandomState >> 27;
+            const uint64_t bits = (m_spreadRandomState * 0x2545F4914F6CDD1Dull) >> 40;
+            const float value = static_cast<float>(bits) * (1.0f / 16777216.0f);
+            if (i < count) {
+                m_spreadTurns[i] = value;
+            } else {
+                m_spreadHeights[i - count] = 1.0f - capHeight * value;
+            }
+        }
+        break;
+    }
+
+    // Orthonormal frame around the spread axis
+    const glm::vec3 axis = pattern.direction / std::sqrt(axisLengthSquared);
+    const glm::vec3 reference =
+        std::abs(axis.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    const glm::vec3 tangent = glm::normalize(glm::cross(reference, axis));
+    const glm::vec3 bitangent = glm::cross(axis, tangent);
+
+    kernels::GenerateSpreadDirections(m_spreadTurns.data(), m_spreadHeights.data(), count, tangent, bitangent, axis,
+                                      m_spreadX.data(), m_spreadY.data(), m_spreadZ.data());
     return true;
 }
 
+ProjectileHandle ProjectileSystem::AllocateHandle() {
+    // Generations are odd while a slot is live and even while it is free
+    ProjectileHandle handle;
+    handle.slot = m_freeSlots.back();
+    handle.generation = ++m_slotGenerations[handle.slot];
+    m_freeSlots.pop_back();
+    return handle;
+}
+
+void ProjectileSystem::ScheduleExpiry(ProjectileHandle handle, float lifetime) {
+    // Round the expiry tick up so projectiles never die before their lifetime is over; the sum stays in double
+    // so a short lifetime is not absorbed by a large clock
+    const uint64_t expiryTick =
+        static_cast<uint64_t>(std::ceil((m_time + static_cast<double>(lifetime)) * ExpiryTicksPerSecond));
+    m_expiryWheel.Schedule(expiryTick, (static_cast<uint64_t>(handle.slot) << 32) | handle.generation);
+}
+
 void ProjectileSystem::RemoveProjectile(size_t index) {
-    if (index < m_projectiles.size()) {
-        m_projectiles.erase(m_projectiles.begin() + index);
+    if (index < m_projectiles.Size()) {
+        RemoveAt(index);
+        m_gridDirty = true;
+    }
+}
+
+bool ProjectileSystem::RemoveProjectile(ProjectileHandle handle) {
+    const size_t index = GetIndex(handle);
+    if (index == InvalidIndex) {
+        return false;
+    }
+
+    RemoveAt(index);
+    m_gridDirty = true;
+    return true;
+}
+
+size_t ProjectileSystem::RemoveProjectiles(const std::vector<ProjectileHandle> &handles) {
+    size_t removed = 0;
+    for (const ProjectileHandle &handle : handles) {
+        const size_t index = GetIndex(handle);
+        if (index != InvalidIndex) {
+            RemoveAt(index);
+            ++removed;
+        }
+    }
+
+    if (removed > 0) {
+        m_gridDirty = true;
+    }
+    return removed;
+}
+
+void ProjectileSystem::RemoveAt(size_t index) {
+    // Bumping the generation invalidates every outstanding handle to this slot
+    const uint32_t slot = m_projectiles.slots[index];
+    ++m_slotGenerations[slot];
+    m_freeSlots.push_back(slot);
+
+    if (index < m_simulatedCount) {
+        // Fill the hole with the last simulated projectile, then fill that one's
+        // index with the last analytic projectile so both ranges stay contiguous
+        const size_t lastSimulated = --m_simulatedCount;
+        if (index != lastSimulated) {
+            m_projectiles.Move(lastSimulated, index);
+            RelinkSlot(index);
+        }
+        const size_t last = m_projectiles.Size() - 1;
+        if (lastSimulated != last) {
+            m_projectiles.Move(last, lastSimulated);
+            RelinkSlot(lastSimulated);
+        }
+        m_projectiles.PopBack();
+    } else {
+        m_projectiles.SwapAndPop(index);
+        if (index < m_projectiles.Size()) {
+            RelinkSlot(index);
+        }
     }
 }
 
 void ProjectileSystem::ClearAll() {
-    m_projectiles.clear();
+    for (uint32_t slot : m_projectiles.slots) {
+        ++m_slotGenerations[slot];
+        m_freeSlots.push_back(slot);
+    }
+
+    m_projectiles.Clear();
+    m_simulatedCount = 0;
+    m_expiryWheel.Clear();
+
+    m_hitscanOrigins.clear();
+    m_hitscanDirections.clear();
+    m_hitscanRanges.clear();
+    m_hitscanTypes.clear();
+    m_hitscanEvents.clear();
+
+    m_homingHandles.clear();
+    m_homingTargetIndices.clear();
+    m_homingAimPoints.clear();
+    m_homingTurnRates.clear();
+    std::fill(m_slotHomingEntries.begin(), m_slotHomingEntries.end(), NoHomingEntry);
+    m_gridDirty = true;
+}
+
+void ProjectileSystem::SetMaxProjectiles(size_t maxProjectiles) {
+    m_maxProjectiles = maxProjectiles;
+    ResetSlots();
+}
+
+void ProjectileSystem::ResetSlots() {
+    ClearAll();
+    m_projectiles.Reserve(m_maxProjectiles);
+
+    // Generations are never discarded, so handles from before a shrink and regrow stay stale
+    if (m_slotGenerations.size() < m_maxProjectiles) {
+        m_slotGenerations.resize(m_maxProjectiles, 0);
+        m_slotIndices.resize(m_maxProjectiles, 0);
+        m_slotHomingEntries.resize(m_maxProjectiles, NoHomingEntry);
+    }
+
+    // Hand out low slots first
+    m_freeSlots.clear();
+    for (size_t slot = m_maxProjectiles; slot > 0; --slot) {
+        m_freeSlots.push_back(static_cast<uint32_t>(slot - 1));
+    }
+}
+
+bool ProjectileSystem::IsAlive(ProjectileHandle handle) const {
+    return GetIndex(handle) != InvalidIndex;
+}
+
+size_t ProjectileSystem::GetIndex(ProjectileHandle handle) const {
+    if (handle.slot >= m_slotGenerations.size() || m_slotGenerations[handle.slot] != handle.generation ||
+        (handle.generation & 1u) == 0) {
+        return InvalidIndex;
+    }
+    return m_slotIndices[handle.slot];
+}
+
+ProjectileHandle ProjectileSystem::GetHandle(size_t index) const {
+    ProjectileHandle handle;
+    if (index < m_projectiles.Size()) {
+        handle.slot = m_projectiles.slots[index];
+        handle.generation = m_slotGenerations[handle.slot];
+    }
+    return handle;
+}
+
+// ========== Homing ==========
+
+bool ProjectileSystem::SetHoming(ProjectileHandle handle, const HomingParams &params) {
+    const size_t index = GetIndex(handle);
+    if (index == InvalidIndex || index >= m_simulatedCount) {
+        return false;
+    }
+
+    // A slot may still own the entry of an earlier projectile that has not been
+    // dropped yet; take it over rather than adding a second entry for the slot
+    uint32_t entry = m_slotHomingEntries[handle.slot];
+    if (entry == NoHomingEntry) {
+        entry = static_cast<uint32_t>(m_homingHandles.size());
+        m_homingHandles.push_back(handle);
+        m_homingTargetIndices.push_back(params.targetIndex);
+        m_homingAimPoints.push_back(params.targetPosition);
+        m_homingTurnRates.push_back(params.turnRate);
+        m_slotHomingEntries[handle.slot] = entry;
+    } else {
+        m_homingHandles[entry] = handle;
+        m_homingTargetIndices[entry] = params.targetIndex;
+        m_homingAimPoints[entry] = params.targetPosition;
+        m_homingTurnRates[entry] = params.turnRate;
+    }
+    return true;
+}
+
+void ProjectileSystem::ClearHoming(ProjectileHandle handle) {
+    if (!IsAlive(handle)) {
+        return;
+    }
+
+    const uint32_t entry = m_slotHomingEntries[handle.slot];
+    if (entry != NoHomingEntry) {
+        RemoveHomingEntry(entry);
+    }
+}
+
+void ProjectileSystem::RemoveHomingEntry(size_t entry) {
+    const uint32_t slot = m_homingHandles[entry].slot;
+    if (m_slotHomingEntries[slot] == entry) {
+        m_slotHomingEntries[slot] = NoHomingEntry;
+    }
+
+    const size_t last = m_homingHandles.size() - 1;
+    if (entry != last) {
+        m_homingHandles[entry] = m_homingHandles[last];
+        m_homingTargetIndices[entry] = m_homingTargetIndices[last];
+        m_homingAimPoints[entry] = m_homingAimPoints[last];
+        m_homingTurnRates[entry] = m_homingTurnRates[last];
+        m_slotHomingEntries[m_homingHandles[entry].slot] = static_cast<uint32_t>(entry);
+    }
+
+    m_homingHandles.pop_back();
+    m_homingTargetIndices.pop_back();
+    m_homingAimPoints.pop_back();
+    m_homingTurnRates.pop_back();
+}
+
+void ProjectileSystem::SteerHomingProjectiles(float deltaTime) {
+    // Drop entries whose projectiles were removed since the last step
+    m_steeringIndices.clear();
+    for (size_t entry = 0; entry < m_homingHandles.size();) {
+        const size_t index = GetIndex(m_homingHandles[entry]);
+        if (index == InvalidIndex) {
+            RemoveHomingEntry(entry);
+            continue;
+        }
+        m_steeringIndices.push_back(static_cast<uint32_t>(index));
+        ++entry;
+    }
+
+    const size_t count = m_homingHandles.size();
+    if (count == 0) {
+        return;
+    }
+
+    m_steeringScratch.resize(count * 10);
+    float *scratch = m_steeringScratch.data();
+    kernels::SteeringArrays arrays;
+    arrays.velocityX = scratch;
+    arrays.velocityY = scratch + count;
+    arrays.velocityZ = scratch + count * 2;
+    float *positionX = scratch + count * 3;
+    float *positionY = scratch + count * 4;
+    float *positionZ = scratch + count * 5;
+    float *targetX = scratch + count * 6;
+    float *targetY = scratch + count * 7;
+    float *targetZ = scratch + count * 8;
+    float *maxTurn = scratch + count * 9;
+
+    // Gather every missile and its aim point into compact arrays
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t targetIndex = m_homingTargetIndices[i];
+        if (targetIndex < m_homingTargets.size()) {
+            m_homingAimPoints[i] = m_homingTargets[targetIndex];
+        }
+
+        const uint32_t index = m_steeringIndices[i];
+        const glm::vec3 &position = m_projectiles.positions[index];
+        const glm::vec3 &velocity = m_projectiles.velocities[index];
+        const glm::vec3 &target = m_homingAimPoints[i];
+        arrays.velocityX[i] = velocity.x;
+        arrays.velocityY[i] = velocity.y;
+        arrays.velocityZ[i] = velocity.z;
+        positionX[i] = position.x;
+        positionY[i] = position.y;
+        positionZ[i] = position.z;
+        targetX[i] = target.x;
+        targetY[i] = target.y;
+        targetZ[i] = target.z;
+        maxTurn[i] = m_homingTurnRates[i] * deltaTime;
+    }
+
+    arrays.positionX = positionX;
+    arrays.positionY = positionY;
+    arrays.positionZ = positionZ;
+    arrays.targetX = targetX;
+    arrays.targetY = targetY;
+    arrays.targetZ = targetZ;
+    arrays.maxTurn = maxTurn;
+    kernels::SteerHomingProjectiles(arrays, count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t index = m_steeringIndices[i];
+        const glm::vec3 velocity(arrays.velocityX[i], arrays.velocityY[i], arrays.velocityZ[i]);
+        m_projectiles.velocities[index] = velocity;
+        if (glm::dot(velocity, velocity) > 0.0f) {
+            m_projectiles.directions[index] = glm::normalize(velocity);
+        }
+    }
+}
+
+// ========== Hitscan ==========
+
+bool ProjectileSystem::QueueHitscan(const glm::vec3 &origin, const glm::vec3 &direction, float range,
+                                    ProjectileType type) {
+    // A NaN ray would poison the batched trace, so shots without a direction are dropped
+    const float lengthSquared = glm::dot(direction, direction);
+    if (!(lengthSquared >= MinDirectionLengthSquared)) {
+        return false;
+    }
+
+    m_hitscanOrigins.push_back(origin);
+    m_hitscanDirections.push_back(direction / std::sqrt(lengthSquared));
+    m_hitscanRanges.push_back(range);
+    m_hitscanTypes.push_back(type);
+    return true;
+}
+
+void ProjectileSystem::ResolveHitscans() {
+    const size_t count = m_hitscanOrigins.size();
+    m_hitscanScene.Trace(m_hitscanOrigins.data(), m_hitscanDirections.data(), m_hitscanRanges.data(), count,
+                         m_hitscanHits);
+
+    m_hitscanEvents.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        HitscanEvent &event = m_hitscanEvents[i];
+        event.origin = m_hitscanOrigins[i];
+        event.direction = m_hitscanDirections[i];
+        event.type = m_hitscanTypes[i];
+        event.targetIndex = m_hitscanHits[i].targetIndex;
+        event.targetType = m_hitscanHits[i].targetType;
+        event.distance =
+            event.targetType != CollisionShapeType::None ? m_hitscanHits[i].distance : m_hitscanRanges[i];
+    }
+
+    m_hitscanOrigins.clear();
+    m_hitscanDirections.clear();
+    m_hitscanRanges.clear();
+    m_hitscanTypes.clear();
+}
+
+// ========== Collision Queries ==========
+
+void ProjectileSystem::UpdateSpatialGrid() {
+    if (m_gridDirty) {
+        SyncProjectiles();
+        m_grid.Build(m_projectiles.positions.data(), m_projectiles.Size());
+        m_gridDirty = false;
+    }
+}
+
+void ProjectileSystem::QuerySphere(const glm::vec3 &center, float radius, std::vector<uint32_t> &results) {
+    UpdateSpatialGrid();
+    m_grid.QuerySphere(center, radius, results);
+}
+
+void ProjectileSystem::QueryAABB(const glm::vec3 &min, const glm::vec3 &max, std::vector<uint32_t> &results) {
+    UpdateSpatialGrid();
+    m_grid.QueryAABB(min, max, results);
+}
+
+void ProjectileSystem::QueryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                                std::vector<uint32_t> &results) {
+    UpdateSpatialGrid();
+    m_grid.QueryRay(origin, direction, maxDistance, results);
+}
+
+void ProjectileSystem::CollideSpheres(const std::vector<CollisionSphere> &targets, std::vector<CollisionPair> &hits) {
+    UpdateSpatialGrid();
+    m_grid.CollideSpheres(targets.data(), targets.size(), hits);
+}
+
+void ProjectileSystem::SweepTargets(const std::vector<CollisionSphere> &spheres,
+                                    const std::vector<CollisionAABB> &boxes,
+                                    const std::vector<CollisionCapsule> &capsules, std::vector<SweptHit> &hits) {
+    SyncProjectiles();
+    m_sweptBatch.SetSegments(m_projectiles.previousPositions.data(), m_projectiles.positions.data(),
+                             m_projectiles.Size(), GetCollisionRadius());
+    m_sweptBatch.SweepSpheres(spheres.data(), spheres.size());
+    m_sweptBatch.SweepAABBs(boxes.data(), boxes.size());
+    m_sweptBatch.SweepCapsules(capsules.data(), capsules.size());
+    m_sweptBatch.GetHits(hits);
+}
+
+const SpatialHashGrid &ProjectileSystem::GetSpatialGrid() {
+    UpdateSpatialGrid();
+    return m_grid;
 }
 
 size_t ProjectileSystem::GetActiveCount() const {
-    return m_projectiles.size();
+    return m_projectiles.Size();
 }
 
 Mesh *ProjectileSystem::GetMeshForType(ProjectileType type) {
@@ -198,7 +1112,9 @@ bool Shooter::Fire(const glm::vec3 &position, const glm::vec3 &direction, Projec
         return false;
     }
 
-    bool success = m_projectileSystem->FireProjectile(position, direction, type, projectileSpeed, projectileLifetime);
+    const ProjectileHandle handle =
+        m_projectileSystem->FireProjectile(position, direction, type, projectileSpeed, projectileLifetime);
+    bool success = static_cast<bool>(handle) || m_projectileSystem->GetMotionModel(type).hitscan;
 
     if (success) {
         m_cooldownTime = 1.0f / fireRate; // Set cooldown based on fire rate
@@ -208,6 +1124,22 @@ bool Shooter::Fire(const glm::vec3 &position, const glm::vec3 &direction, Projec
     return success;
 }
 
+size_t Shooter::FireBatch(const glm::vec3 &position, const SpreadPattern &pattern, size_t count, ProjectileType type,
+                          std::vector<ProjectileHandle> *handles) {
+    if (!m_projectileSystem || !CanFire()) {
+        return 0;
+    }
+
+    const size_t spawned =
+        m_projectileSystem->FireBatch(position, pattern, count, type, projectileSpeed, projectileLifetime, handles);
+    if (spawned > 0) {
+        m_cooldownTime = 1.0f / fireRate;
+        m_lastFireTime = 0.0f;
+    }
+
+    return spawned;
+}
+
 void Shooter::Update(float deltaTime) {
     if (m_cooldownTime > 0.0f) {
         m_cooldownTime -= deltaTime;
@@ -0,0 +1,303 @@
+#include "ProjectileTrails.h"
+#include <algorithm>
+#include <cmath>
+
+namespace agl {
+
+namespace {
+
+uint32_t PackColor(const glm::vec4 &color) {
+    auto channel = [](float value) {
+        return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+    };
+    return channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16) | (channel(color.w) << 24);
+}
+
+} // namespace
+
+ProjectileTrails::ProjectileTrails(ProjectileSystem *projectileSystem, size_t maxTrails, size_t pointsPerTrail)
+    : m_projectileSystem(projectileSystem), m_pointsPerTrail(std::max<size_t>(pointsPerTrail, 2)),
+      m_trails(maxTrails), m_points(maxTrails * m_pointsPerTrail), m_pointTimes(maxTrails * m_pointsPerTrail) {
+    m_ribbonPoints.reserve(m_pointsPerTrail + 1);
+    m_ribbonAges.reserve(m_pointsPerTrail + 1);
+
+    // Hand out low ids first
+    m_freeTrails.reserve(maxTrails);
+    for (size_t i = maxTrails; i-- > 0;) {
+        m_freeTrails.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void ProjectileTrails::Initialize() {
+    VertexBufferLayout layout;
+    layout.PushFloat("a_Position", 3);
+    layout.PushByte("a_Color", 4, true);
+
+    m_vertexBuffer = std::make_shared<StreamingVertexBuffer>();
+    m_vertexBuffer->Allocate(GetMaxVertexCount() * sizeof(TrailVertex));
+
+    m_vertexArray = VertexArray::Create();
+    m_vertexArray->AddVertexBuffer(m_vertexBuffer, layout);
+    m_vertexArray->Unbind();
+
+    m_shader = CreateRibbonShader();
+}
+
+// ========== Trails ==========
+
+uint32_t ProjectileTrails::Attach(ProjectileHandle handle, const TrailStyle &style) {
+    if (!m_projectileSystem || m_freeTrails.empty()) {
+        return InvalidTrail;
+    }
+
+    const size_t index = m_projectileSystem->GetIndex(handle);
+    if (index == ProjectileSystem::InvalidIndex) {
+        return InvalidTrail;
+    }
+
+    const uint32_t trailIndex = m_freeTrails.back();
+    m_freeTrails.pop_back();
+
+    Trail &trail = m_trails[trailIndex];
+    trail = Trail{};
+    trail.handle = handle;
+    trail.style = style;
+    trail.alive = true;
+    trail.attached = true;
+    trail.head = m_projectileSystem->GetProjectiles().positions[index];
+    RecordPoint(trailIndex, trail.head);
+    return trailIndex;
+}
+
+void ProjectileTrails::Detach(uint32_t trail) {
+    if (trail < m_trails.size() && m_trails[trail].alive && m_trails[trail].attached) {
+        m_trails[trail].attached = false;
+        RecordPoint(trail, m_trails[trail].head);
+    }
+}
+
+void ProjectileTrails::Clear() {
+    for (uint32_t i = 0; i < m_trails.size(); ++i) {
+        if (m_trails[i].alive) {
+            ReleaseTrail(i);
+        }
+    }
+}
+
+void ProjectileTrails::RecordPoint(uint32_t trailIndex, const glm::vec3 &position) {
+    Trail &trail = m_trails[trailIndex];
+    if (trail.count > 0) {
+        trail.newest = (trail.newest + 1) % m_pointsPerTrail;
+    }
+    trail.count = std::min<uint32_t>(trail.count + 1, static_cast<uint32_t>(m_pointsPerTrail));
+
+    const size_t slot = trailIndex * m_pointsPerTrail + trail.newest;
+    m_points[slot] = position;
+    m_pointTimes[slot] = m_time;
+}
+
+void ProjectileTrails::ReleaseTrail(uint32_t trailIndex) {
+    m_trails[trailIndex].alive = false;
+    m_trails[trailIndex].attached = false;
+    m_freeTrails.push_back(trailIndex);
+}
+
+// ========== Update ==========
+
+void ProjectileTrails::Update(float deltaTime) {
+    m_time += deltaTime;
+
+    // Fetched lazily, as it evaluates every analytic projectile
+    const ProjectileStorage *projectiles = nullptr;
+
+    for (uint32_t i = 0; i < m_trails.size(); ++i) {
+        Trail &trail = m_trails[i];
+        if (!trail.alive) {
+            continue;
+        }
+
+        if (trail.attached) {
+            const size_t index = m_projectileSystem->GetIndex(trail.handle);
+            if (index == ProjectileSystem::InvalidIndex) {
+                // Projectile hit something or expired; leave the trail where it ended
+                trail.attached = false;
+                RecordPoint(i, trail.head);
+            } else {
+                if (!projectiles) {
+                    projectiles = &m_projectileSystem->GetProjectiles();
+                }
+                trail.head = projectiles->positions[index];
+
+                const glm::vec3 delta = trail.head - m_points[i * m_pointsPerTrail + trail.newest];
+                if (glm::dot(delta, delta) >= trail.style.minSegmentLength * trail.style.minSegmentLength) {
+                    RecordPoint(i, trail.head);
+                }
+            }
+        }
+
+        // Drop expired points from the oldest end
+        const float oldestTime = m_time - trail.style.lifetime;
+        while (trail.count > 0) {
+            const uint32_t oldest = static_cast<uint32_t>(
+                (trail.newest + m_pointsPerTrail - (trail.count - 1)) % m_pointsPerTrail);
+            if (m_pointTimes[i * m_pointsPerTrail + oldest] >= oldestTime) {
+                break;
+            }
+            trail.count--;
+        }
+
+        if (!trail.attached && trail.count == 0) {
+            ReleaseTrail(i);
+        }
+    }
+}
+
+// ========== Rendering ==========
+
+size_t ProjectileTrails::GenerateRibbons(const glm::vec3 &cameraPosition, TrailVertex *vertices) {
+    size_t written = 0;
+    m_renderStats.trailCount = 0;
+
+    for (uint32_t i = 0; i < m_trails.size(); ++i) {
+        const Trail &trail = m_trails[i];
+        if (!trail.alive) {
+            continue;
+        }
+
+        // Gather the trail newest first, led by the live head while attached
+        m_ribbonPoints.clear();
+        m_ribbonAges.clear();
+        if (trail.attached) {
+            m_ribbonPoints.push_back(trail.head);
+            m_ribbonAges.push_back(0.0f);
+        }
+        const size_t base = i * m_pointsPerTrail;
+        for (uint32_t k = 0; k < trail.count; ++k) {
+            const size_t slot = base + (trail.newest + m_pointsPerTrail - k) % m_pointsPerTrail;
+            m_ribbonPoints.push_back(m_points[slot]);
+            m_ribbonAges.push_back(m_time - m_pointTimes[slot]);
+        }
+
+        const size_t count = m_ribbonPoints.size();
+        if (count < 2) {
+            continue;
+        }
+
+        // Join to the previous strip with a degenerate pair: its last vertex and this
+        // strip's first one (filled in below). Strips have an even vertex count, so every
+        // strip starts on an even index and keeps the same winding.
+        const bool join = written > 0;
+        if (join) {
+            vertices[written] = vertices[written - 1];
+            written += 2;
+        }
+        const size_t stripStart = written;
+
+        const float inverseLifetime = trail.style.lifetime > 0.0f ? 1.0f / trail.style.lifetime : 0.0f;
+        glm::vec3 side(0.0f);
+        for (size_t k = 0; k < count; ++k) {
+            const glm::vec3 &point = m_ribbonPoints[k];
+
+            // Central difference along the trail; one-sided at the ends
+            const glm::vec3 tangent = m_ribbonPoints[k == 0 ? 0 : k - 1] - m_ribbonPoints[std::min(k + 1, count - 1)];
+            const glm::vec3 normal = glm::cross(tangent, cameraPosition - point);
+            const float normalLengthSquared = glm::dot(normal, normal);
+            if (normalLengthSquared > 1e-12f) {
+                side = normal / std::sqrt(normalLengthSquared);
+            }
+
+            const TrailStyle &style = trail.style;
+            const float t = std::min(m_ribbonAges[k] * inverseLifetime, 1.0f);
+            const float halfWidth = 0.5f * (style.headWidth + (style.tailWidth - style.headWidth) * t);
+            const uint32_t color = PackColor(style.headColor + (style.tailColor - style.headColor) * t);
+
+            vertices[written++] = TrailVertex{point + side * halfWidth, color};
+            vertices[written++] = TrailVertex{point - side * halfWidth, color};
+        }
+
+        if (join) {
+            vertices[stripStart - 1] = vertices[stripStart];
+        }
+        m_renderStats.trailCount++;
+    }
+
+    m_renderStats.vertexCount = static_cast<uint32_t>(written);
+    return written;
+}
+
+void ProjectileTrails::Render(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix) {
+    m_renderStats.drawCalls = 0;
+    if (!m_shader || !m_vertexArray || GetTrailCount() == 0) {
+        m_renderStats.trailCount = 0;
+        m_renderStats.vertexCount = 0;
+        return;
+    }
+
+    const glm::vec3 cameraPosition = glm::vec3(glm::inverse(viewMatrix)[3]);
+    auto *vertices =
+        static_cast<TrailVertex *>(m_vertexBuffer->Map(GetMaxVertexCount() * sizeof(TrailVertex)));
+    if (!vertices) {
+        return;
+    }
+    const size_t vertexCount = GenerateRibbons(cameraPosition, vertices);
+    const size_t firstVertex = m_vertexBuffer->Unmap() / sizeof(TrailVertex);
+    if (vertexCount == 0) {
+        return;
+    }
+
+    m_shader->Use();
+    m_shader->SetUniform("viewProjection", projectionMatrix * viewMatrix);
+
+    // Ribbons are two-sided and test against the scene without occluding each other
+    const GLboolean cullFace = glIsEnabled(GL_CULL_FACE);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+
+    m_vertexArray->DrawArrays(GL_TRIANGLE_STRIP, static_cast<uint32_t>(firstVertex),
+                              static_cast<uint32_t>(vertexCount));
+    m_vertexBuffer->Fence();
+    m_renderStats.drawCalls = 1;
+
+    m_vertexArray->Unbind();
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    if (cullFace) {
+        glEnable(GL_CULL_FACE);
+    }
+}
+
+std::unique_ptr<ShaderProgram> ProjectileTrails::CreateRibbonShader() {
+    const std::string vertexSource = R"(
+        #version 330 core
+
+        layout (location = 0) in vec3 a_Position;
+        layout (location = 1) in vec4 a_Color;
+
+        out vec4 Color;
+
+        uniform mat4 viewProjection;
+
+        void main() {
+            Color = a_Color;
+            gl_Position = viewProjection * vec4(a_Position, 1.0);
+        }
+    )";
+
+    const std::string fragmentSource = R"(
+        #version 330 core
+
+        in vec4 Color;
+
+        out vec4 FragColor;
+
+        void main() {
+            FragColor = Color;
+        }
+    )";
+
+    return ShaderProgram::CreateFromSources(vertexSource, fragmentSource);
+}
+
+} // namespace agl
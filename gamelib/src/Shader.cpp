@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "VertexCompression.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -197,6 +198,18 @@ int ShaderProgram::GetUniformLocation(const std::string &name) const {
     return location;
 }
 
+bool ShaderProgram::HasUniform(const std::string &name) const {
+    // Cached like GetUniformLocation, so a later SetUniform on a missing name stays silent too
+    auto it = m_uniformLocationCache.find(name);
+    if (it != m_uniformLocationCache.end()) {
+        return it->second != -1;
+    }
+
+    const int location = glGetUniformLocation(m_programID, name.c_str());
+    m_uniformLocationCache[name] = location;
+    return location != -1;
+}
+
 void ShaderProgram::SetUniform(const std::string &name, bool value) {
     glUniform1i(GetUniformLocation(name), static_cast<int>(value));
 }
@@ -488,6 +501,82 @@ std::unique_ptr<ShaderProgram> ShaderProgram::CreatePhongShader() {
     return CreateFromSources(vertexSource, fragmentSource);
 }
 
+std::unique_ptr<ShaderProgram> ShaderProgram::CreateMeshShader() {
+    const std::string vertexSource = std::string("#version 330 core\n") + GetCompactVertexDecodeGLSL() + R"(
+        layout (location = 0) in vec3 a_Position;
+        layout (location = 1) in vec4 a_Normal;
+        layout (location = 2) in vec2 a_TexCoords;
+
+        out vec3 FragPos;
+        out vec3 Normal;
+        out vec2 TexCoords;
+
+        uniform mat4 model;
+        uniform mat4 view;
+        uniform mat4 projection;
+        uniform mat3 normalMatrix;
+
+        void main() {
+            FragPos = vec3(model * vec4(agl_DecodePosition(a_Position), 1.0));
+            Normal = normalMatrix * agl_DecodeNormal(a_Normal);
+            TexCoords = a_TexCoords;
+
+            gl_Position = projection * view * vec4(FragPos, 1.0);
+        }
+    )";
+
+    const std::string fragmentSource = R"(
+        #version 330 core
+
+        in vec3 FragPos;
+        in vec3 Normal;
+        in vec2 TexCoords;
+
+        out vec4 FragColor;
+
+        uniform vec3 lightPos;
+        uniform vec3 lightColor;
+        uniform vec3 viewPos;
+
+        struct Material {
+            vec3 ambient;
+            vec3 diffuse;
+            vec3 specular;
+            float shininess;
+            bool hasDiffuseTexture;
+            sampler2D diffuseTexture;
+        };
+
+        uniform Material material;
+
+        void main() {
+            vec3 albedo = material.diffuse;
+            if (material.hasDiffuseTexture) {
+                albedo *= texture(material.diffuseTexture, TexCoords).rgb;
+            }
+
+            // Ambient
+            vec3 ambient = lightColor * material.ambient;
+
+            // Diffuse
+            vec3 norm = normalize(Normal);
+            vec3 lightDir = normalize(lightPos - FragPos);
+            float diff = max(dot(norm, lightDir), 0.0);
+            vec3 diffuse = lightColor * (diff * albedo);
+
+            // Specular
+            vec3 viewDir = normalize(viewPos - FragPos);
+            vec3 reflectDir = reflect(-lightDir, norm);
+            float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+            vec3 specular = lightColor * (spec * material.specular);
+
+            FragColor = vec4(ambient + diffuse + specular, 1.0);
+        }
+    )";
+
+    return CreateFromSources(vertexSource, fragmentSource);
+}
+
 // ===== ShaderManager Class =====
 
 ShaderManager &ShaderManager::Instance() {
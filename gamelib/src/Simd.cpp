@@ -0,0 +1,89 @@
+#include "Simd.h"
+
+#include <atomic>
+
+#if defined(AGL_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace agl {
+namespace simd {
+
+namespace {
+
+std::atomic<int> s_limit{static_cast<int>(InstructionSet::AVX2)};
+
+InstructionSet QueryCpu() {
+#if defined(AGL_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    // AVX registers are only usable if the OS saves YMM state on context switch
+    bool ymmEnabled = false;
+    if (osxsave && avx) {
+        ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+    }
+
+    bool avx2 = false;
+    if (maxLeaf >= 7 && ymmEnabled) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+
+    if (avx2) {
+        return InstructionSet::AVX2;
+    }
+    if (sse2) {
+        return InstructionSet::SSE2;
+    }
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return InstructionSet::SSE2;
+    }
+#endif
+#endif
+    return InstructionSet::Scalar;
+}
+
+} // namespace
+
+InstructionSet DetectInstructionSet() {
+    static const InstructionSet detected = QueryCpu();
+    return detected;
+}
+
+InstructionSet GetInstructionSet() {
+    const int detected = static_cast<int>(DetectInstructionSet());
+    const int limit = s_limit.load(std::memory_order_relaxed);
+    return static_cast<InstructionSet>(detected < limit ? detected : limit);
+}
+
+void SetInstructionSetLimit(InstructionSet limit) {
+    s_limit.store(static_cast<int>(limit), std::memory_order_relaxed);
+}
+
+const char *GetInstructionSetName(InstructionSet set) {
+    switch (set) {
+    case InstructionSet::AVX2:
+        return "AVX2";
+    case InstructionSet::SSE2:
+        return "SSE2";
+    default:
+        return "Scalar";
+    }
+}
+
+} // namespace simd
+} // namespace agl
@@ -0,0 +1,235 @@
+#ifndef SIMD_LANES_H
+#define SIMD_LANES_H
+
+// Lane wrappers that let one kernel body run as scalar, SSE2 or AVX2 code.
+// Kernels are written against the static interface below and compiled once per
+// wrapper, with the matching AGL_TARGET_* attribute on every kernel function.
+//
+// Min/Max follow the SSE semantics (a < b ? a : b) in every implementation, so
+// NaN inputs resolve the same way on all paths.
+
+#include "Simd.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(AGL_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace agl {
+namespace simd {
+
+struct ScalarLanes {
+    using Float = float;
+    using Mask = bool;
+    static constexpr size_t Width = 1;
+
+    static Float Load(const float *p) {
+        return *p;
+    }
+    static void Store(float *p, Float v) {
+        *p = v;
+    }
+    static Float Set1(float v) {
+        return v;
+    }
+    static Float Add(Float a, Float b) {
+        return a + b;
+    }
+    static Float Sub(Float a, Float b) {
+        return a - b;
+    }
+    static Float Mul(Float a, Float b) {
+        return a * b;
+    }
+    static Float Div(Float a, Float b) {
+        return a / b;
+    }
+    static Float Sqrt(Float a) {
+        return std::sqrt(a);
+    }
+    static Float Min(Float a, Float b) {
+        return a < b ? a : b;
+    }
+    static Float Max(Float a, Float b) {
+        return a > b ? a : b;
+    }
+    static Float Floor(Float a) {
+        return std::floor(a);
+    }
+    static Mask Less(Float a, Float b) {
+        return a < b;
+    }
+    static Mask LessEqual(Float a, Float b) {
+        return a <= b;
+    }
+    static Mask Greater(Float a, Float b) {
+        return a > b;
+    }
+    static Mask Equal(Float a, Float b) {
+        return a == b;
+    }
+    static Mask GreaterEqual(Float a, Float b) {
+        return a >= b;
+    }
+    static Mask And(Mask a, Mask b) {
+        return a && b;
+    }
+    static Mask Or(Mask a, Mask b) {
+        return a || b;
+    }
+    static Float Select(Mask m, Float a, Float b) {
+        return m ? a : b;
+    }
+    static uint32_t MoveMask(Mask m) {
+        return m ? 1u : 0u;
+    }
+};
+
+#if defined(AGL_SIMD_X86)
+
+struct SSE2Lanes {
+    using Float = __m128;
+    using Mask = __m128;
+    static constexpr size_t Width = 4;
+
+    AGL_TARGET_SSE2 static Float Load(const float *p) {
+        return _mm_loadu_ps(p);
+    }
+    AGL_TARGET_SSE2 static void Store(float *p, Float v) {
+        _mm_storeu_ps(p, v);
+    }
+    AGL_TARGET_SSE2 static Float Set1(float v) {
+        return _mm_set1_ps(v);
+    }
+    AGL_TARGET_SSE2 static Float Add(Float a, Float b) {
+        return _mm_add_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Float Sub(Float a, Float b) {
+        return _mm_sub_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Float Mul(Float a, Float b) {
+        return _mm_mul_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Float Div(Float a, Float b) {
+        return _mm_div_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Float Sqrt(Float a) {
+        return _mm_sqrt_ps(a);
+    }
+    AGL_TARGET_SSE2 static Float Min(Float a, Float b) {
+        return _mm_min_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Float Max(Float a, Float b) {
+        return _mm_max_ps(a, b);
+    }
+    // SSE2 has no rounding instruction: truncate, then step down where truncation
+    // rounded up (negative inputs). Valid for |a| < 2^31.
+    AGL_TARGET_SSE2 static Float Floor(Float a) {
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.0f)));
+    }
+    AGL_TARGET_SSE2 static Mask Less(Float a, Float b) {
+        return _mm_cmplt_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Mask LessEqual(Float a, Float b) {
+        return _mm_cmple_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Mask Greater(Float a, Float b) {
+        return _mm_cmpgt_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Mask Equal(Float a, Float b) {
+        return _mm_cmpeq_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Mask GreaterEqual(Float a, Float b) {
+        return _mm_cmpge_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Mask And(Mask a, Mask b) {
+        return _mm_and_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Mask Or(Mask a, Mask b) {
+        return _mm_or_ps(a, b);
+    }
+    AGL_TARGET_SSE2 static Float Select(Mask m, Float a, Float b) {
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+    AGL_TARGET_SSE2 static uint32_t MoveMask(Mask m) {
+        return static_cast<uint32_t>(_mm_movemask_ps(m));
+    }
+};
+
+struct AVX2Lanes {
+    using Float = __m256;
+    using Mask = __m256;
+    static constexpr size_t Width = 8;
+
+    AGL_TARGET_AVX2 static Float Load(const float *p) {
+        return _mm256_loadu_ps(p);
+    }
+    AGL_TARGET_AVX2 static void Store(float *p, Float v) {
+        _mm256_storeu_ps(p, v);
+    }
+    AGL_TARGET_AVX2 static Float Set1(float v) {
+        return _mm256_set1_ps(v);
+    }
+    AGL_TARGET_AVX2 static Float Add(Float a, Float b) {
+        return _mm256_add_ps(a, b);
+    }
+    AGL_TARGET_AVX2 static Float Sub(Float a, Float b) {
+        return _mm256_sub_ps(a, b);
+    }
+    AGL_TARGET_AVX2 static Float Mul(Float a, Float b) {
+        return _mm256_mul_ps(a, b);
+    }
+    AGL_TARGET_AVX2 static Float Div(Float a, Float b) {
+        return _mm256_div_ps(a, b);
+    }
+    AGL_TARGET_AVX2 static Float Sqrt(Float a) {
+        return _mm256_sqrt_ps(a);
+    }
+    AGL_TARGET_AVX2 static Float Min(Float a, Float b) {
+        return _mm256_min_ps(a, b);
+    }
+    AGL_TARGET_AVX2 static Float Max(Float a, Float b) {
+        return _mm256_max_ps(a, b);
+    }
+    AGL_TARGET_AVX2 static Float Floor(Float a) {
+        return _mm256_floor_ps(a);
+    }
+    AGL_TARGET_AVX2 static Mask Less(Float a, Float b) {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    AGL_TARGET_AVX2 static Mask LessEqual(Float a, Float b) {
+        return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+    }
+    AGL_TARGET_AVX2 static Mask Greater(Float a, Float b) {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    }
+    AGL_TARGET_AVX2 static Mask Equal(Float a, Float b) {
+        return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+    }
+    AGL_TARGET_AVX2 static Mask GreaterEqual(Float a, Float b) {
+        return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+    }
+    AGL_TARGET_AVX2 static Mask And(Mask a, Mask b) {
+        return _mm256_and_ps(a, b);
+    }
+    AGL_TARGET_AVX2 static Mask Or(Mask a, Mask b) {
+        return _mm256_or_ps(a, b);
+    }
+    AGL_TARGET_AVX2 static Float Select(Mask m, Float a, Float b) {
+        return _mm256_blendv_ps(b, a, m);
+    }
+    AGL_TARGET_AVX2 static uint32_t MoveMask(Mask m) {
+        return static_cast<uint32_t>(_mm256_movemask_ps(m));
+    }
+};
+
+#endif // AGL_SIMD_X86
+
+} // namespace simd
+} // namespace agl
+
+#endif // SIMD_LANES_H
@@ -0,0 +1,303 @@
+#include "SpatialHashGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace agl {
+
+namespace {
+
+// Keeps cell coordinates well inside int range for far-away or huge positions
+constexpr float MaxCellCoordinate = 1.0e9f;
+
+uint32_t NextPowerOfTwo(size_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+float DistanceSquaredToSegment(const glm::vec3 &point, const glm::vec3 &start, const glm::vec3 &direction,
+                               float length) {
+    const float t = glm::clamp(glm::dot(point - start, direction), 0.0f, length);
+    const glm::vec3 offset = point - (start + direction * t);
+    return glm::dot(offset, offset);
+}
+
+} // namespace
+
+SpatialHashGrid::SpatialHashGrid(float cellSize) {
+    SetCellSize(cellSize);
+}
+
+void SpatialHashGrid::SetCellSize(float cellSize) {
+    m_cellSize = cellSize > 0.0f ? cellSize : 1.0f;
+    m_inverseCellSize = 1.0f / m_cellSize;
+}
+
+glm::ivec3 SpatialHashGrid::CellOf(const glm::vec3 &position) const {
+    const glm::vec3 scaled =
+        glm::clamp(glm::floor(position * m_inverseCellSize), -MaxCellCoordinate, MaxCellCoordinate);
+    return glm::ivec3(static_cast<int>(scaled.x), static_cast<int>(scaled.y), static_cast<int>(scaled.z));
+}
+
+uint32_t SpatialHashGrid::HashCell(const glm::ivec3 &cell) const {
+    const uint32_t hash = (static_cast<uint32_t>(cell.x) * 73856093u) ^ (static_cast<uint32_t>(cell.y) * 19349663u) ^
+                          (static_cast<uint32_t>(cell.z) * 83492791u);
+    return hash & m_bucketMask;
+}
+
+void SpatialHashGrid::Build(const glm::vec3 *positions, size_t count) {
+    if (count == 0) {
+        Clear();
+        return;
+    }
+
+    // Load factor of at most one point per bucket keeps chains short
+    const uint32_t bucketCount = NextPowerOfTwo(std::max<size_t>(count, 64));
+    m_bucketMask = bucketCount - 1;
+    m_bucketStarts.assign(bucketCount + 1, 0);
+    m_pointBuckets.resize(count);
+    m_points.resize(count);
+
+    m_boundsMin = positions[0];
+    m_boundsMax = positions[0];
+
+    // Count points per bucket
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t bucket = HashCell(CellOf(positions[i]));
+        m_pointBuckets[i] = bucket;
+        m_bucketStarts[bucket + 1]++;
+
+        m_boundsMin = glm::min(m_boundsMin, positions[i]);
+        m_boundsMax = glm::max(m_boundsMax, positions[i]);
+    }
+
+    // Prefix sum gives each bucket's first slot
+    for (uint32_t b = 0; b < bucketCount; ++b) {
+        m_bucketStarts[b + 1] += m_bucketStarts[b];
+    }
+
+    // Scatter; each bucket's start advances to its end, i.e. the next bucket's start
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t slot = m_bucketStarts[m_pointBuckets[i]]++;
+        m_points[slot] = GridPoint{positions[i], static_cast<uint32_t>(i)};
+    }
+
+    // Shift back so m_bucketStarts[b] is the start of bucket b again
+    for (uint32_t b = bucketCount; b > 0; --b) {
+        m_bucketStarts[b] = m_bucketStarts[b - 1];
+    }
+    m_bucketStarts[0] = 0;
+}
+
+void SpatialHashGrid::Clear() {
+    m_points.clear();
+    m_bucketStarts.assign(1, 0);
+    m_bucketMask = 0;
+    m_boundsMin = glm::vec3(0.0f);
+    m_boundsMax = glm::vec3(0.0f);
+}
+
+template <typename Visitor>
+void SpatialHashGrid::VisitCells(glm::ivec3 minCell, glm::ivec3 maxCell, Visitor &&visit) const {
+    if (m_points.empty()) {
+        return;
+    }
+
+    // Nothing outside the occupied bounds can match
+    const glm::ivec3 boundsMinCell = CellOf(m_boundsMin);
+    const glm::ivec3 boundsMaxCell = CellOf(m_boundsMax);
+    for (int axis = 0; axis < 3; ++axis) {
+        minCell[axis] = std::max(minCell[axis], boundsMinCell[axis]);
+        maxCell[axis] = std::min(maxCell[axis], boundsMaxCell[axis]);
+        if (minCell[axis] > maxCell[axis]) {
+            return;
+        }
+    }
+
+    const int64_t cellCount = static_cast<int64_t>(maxCell.x - minCell.x + 1) *
+                              static_cast<int64_t>(maxCell.y - minCell.y + 1) *
+                              static_cast<int64_t>(maxCell.z - minCell.z + 1);
+
+    if (cellCount > static_cast<int64_t>(m_points.size())) {
+        for (const GridPoint &point : m_points) {
+            visit(point);
+        }
+        return;
+    }
+
+    glm::ivec3 cell;
+    for (cell.z = minCell.z; cell.z <= maxCell.z; ++cell.z) {
+        for (cell.y = minCell.y; cell.y <= maxCell.y; ++cell.y) {
+            for (cell.x = minCell.x; cell.x <= maxCell.x; ++cell.x) {
+                const uint32_t bucket = HashCell(cell);
+                for (uint32_t k = m_bucketStarts[bucket]; k < m_bucketStarts[bucket + 1]; ++k) {
+                    // Buckets are shared by colliding cells; only report points of this cell
+                    // so a point is never visited twice
+                    if (CellOf(m_points[k].position) == cell) {
+                        visit(m_points[k]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename Visitor>
+void SpatialHashGrid::VisitSphere(const glm::vec3 &center, float radius, Visitor &&visit) const {
+    const float reach = radius + m_pointRadius;
+    const float reachSquared = reach * reach;
+
+    VisitCells(CellOf(center - glm::vec3(reach)), CellOf(center + glm::vec3(reach)), [&](const GridPoint &point) {
+        const glm::vec3 offset = point.position - center;
+        if (glm::dot(offset, offset) <= reachSquared) {
+            visit(point);
+        }
+    });
+}
+
+void SpatialHashGrid::QuerySphere(const glm::vec3 &center, float radius, std::vector<uint32_t> &results) const {
+    results.clear();
+    VisitSphere(center, radius, [&](const GridPoint &point) { results.push_back(point.index); });
+}
+
+void SpatialHashGrid::QueryAABB(const glm::vec3 &min, const glm::vec3 &max, std::vector<uint32_t> &results) const {
+    results.clear();
+
+    const float radiusSquared = m_pointRadius * m_pointRadius;
+    const glm::vec3 reach(m_pointRadius);
+
+    VisitCells(CellOf(min - reach), CellOf(max + reach), [&](const GridPoint &point) {
+        const glm::vec3 offset = point.position - glm::clamp(point.position, min, max);
+        if (glm::dot(offset, offset) <= radiusSquared) {
+            results.push_back(point.index);
+        }
+    });
+}
+
+void SpatialHashGrid::QueryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                               std::vector<uint32_t> &results) const {
+    results.clear();
+    if (m_points.empty()) {
+        return;
+    }
+
+    const float directionLength = glm::length(direction);
+    if (directionLength <= 0.0f) {
+        QuerySphere(origin, 0.0f, results);
+        return;
+    }
+    const glm::vec3 dir = direction / directionLength;
+    const float length =
+        std::isfinite(maxDistance) ? std::max(maxDistance, 0.0f) : std::numeric_limits<float>::infinity();
+    const float radiusSquared = m_pointRadius * m_pointRadius;
+
+    // Clip the segment to the occupied bounds grown by the point radius; outside them
+    // there is nothing to find, so far-away origins or ends cost no extra cells
+    const glm::vec3 boundsMin = m_boundsMin - glm::vec3(m_pointRadius);
+    const glm::vec3 boundsMax = m_boundsMax + glm::vec3(m_pointRadius);
+    float tEnter = 0.0f;
+    float tExit = length;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (dir[axis] == 0.0f) {
+            if (origin[axis] < boundsMin[axis] || origin[axis] > boundsMax[axis]) {
+                return;
+            }
+            continue;
+        }
+        const float t0 = (boundsMin[axis] - origin[axis]) / dir[axis];
+        const float t1 = (boundsMax[axis] - origin[axis]) / dir[axis];
+        tEnter = std::max(tEnter, std::min(t0, t1));
+        tExit = std::min(tExit, std::max(t0, t1));
+    }
+    if (tEnter > tExit) {
+        return;
+    }
+
+    const glm::vec3 start = origin + dir * tEnter;
+    glm::ivec3 cell = CellOf(start);
+    const glm::ivec3 endCell = CellOf(origin + dir * tExit);
+
+    // Points within the point radius of the segment can sit in cells next to the ones
+    // the segment crosses, so each crossed cell brings its neighbourhood. When that
+    // adds up to more cells than there are points, testing every point is cheaper.
+    const float reachCells = std::ceil(m_pointRadius * m_inverseCellSize);
+    const int64_t steps = std::abs(static_cast<int64_t>(endCell.x) - cell.x) +
+                          std::abs(static_cast<int64_t>(endCell.y) - cell.y) +
+                          std::abs(static_cast<int64_t>(endCell.z) - cell.z) + 1;
+    const double side = 2.0 * static_cast<double>(reachCells) + 1.0;
+    if (static_cast<double>(steps) * side * side * side > static_cast<double>(m_points.size())) {
+        for (const GridPoint &point : m_points) {
+            if (DistanceSquaredToSegment(point.position, origin, dir, length) <= radiusSquared) {
+                results.push_back(point.index);
+            }
+        }
+        return;
+    }
+    const int neighbourhood = static_cast<int>(reachCells);
+
+    // Amanatides-Woo traversal
+    glm::ivec3 step(0);
+    glm::vec3 tMax(std::numeric_limits<float>::infinity());
+    glm::vec3 tDelta(std::numeric_limits<float>::infinity());
+    for (int axis = 0; axis < 3; ++axis) {
+        if (dir[axis] > 0.0f) {
+            step[axis] = 1;
+            tMax[axis] = ((static_cast<float>(cell[axis]) + 1.0f) * m_cellSize - start[axis]) / dir[axis];
+            tDelta[axis] = m_cellSize / dir[axis];
+        } else if (dir[axis] < 0.0f) {
+            step[axis] = -1;
+            tMax[axis] = (static_cast<float>(cell[axis]) * m_cellSize - start[axis]) / dir[axis];
+            tDelta[axis] = -m_cellSize / dir[axis];
+        }
+    }
+
+    m_rayCells.clear();
+    for (int64_t i = 0; i < steps; ++i) {
+        glm::ivec3 offset;
+        for (offset.z = -neighbourhood; offset.z <= neighbourhood; ++offset.z) {
+            for (offset.y = -neighbourhood; offset.y <= neighbourhood; ++offset.y) {
+                for (offset.x = -neighbourhood; offset.x <= neighbourhood; ++offset.x) {
+                    m_rayCells.push_back(glm::ivec3(cell.x + offset.x, cell.y + offset.y, cell.z + offset.z));
+                }
+            }
+        }
+
+        if (cell == endCell) {
+            break;
+        }
+
+        const int axis = (tMax.x < tMax.y) ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+        cell[axis] += step[axis];
+        tMax[axis] += tDelta[axis];
+    }
+
+    // Neighbourhoods of consecutive cells overlap
+    std::sort(m_rayCells.begin(), m_rayCells.end(), [](const glm::ivec3 &a, const glm::ivec3 &b) {
+        return a.z != b.z ? a.z < b.z : (a.y != b.y ? a.y < b.y : a.x < b.x);
+    });
+    m_rayCells.erase(std::unique(m_rayCells.begin(), m_rayCells.end()), m_rayCells.end());
+
+    for (const glm::ivec3 &visitCell : m_rayCells) {
+        VisitCells(visitCell, visitCell, [&](const GridPoint &point) {
+            if (DistanceSquaredToSegment(point.position, origin, dir, length) <= radiusSquared) {
+                results.push_back(point.index);
+            }
+        });
+    }
+}
+
+void SpatialHashGrid::CollideSpheres(const CollisionSphere *targets, size_t targetCount,
+                                     std::vector<CollisionPair> &hits) const {
+    hits.clear();
+    for (size_t t = 0; t < targetCount; ++t) {
+        const uint32_t targetIndex = static_cast<uint32_t>(t);
+        VisitSphere(targets[t].center, targets[t].radius,
+                    [&](const GridPoint &point) { hits.push_back(CollisionPair{point.index, targetIndex}); });
+    }
+}
+
+} // namespace agl
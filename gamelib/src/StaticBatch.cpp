@@ -0,0 +1,351 @@
+#include "StaticBatch.h"
+#include "DispatchQueue.h"
+#include "MemoryStats.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#if defined(__APPLE__)
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl3.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace agl {
+
+namespace {
+
+// Objects per ParallelFor chunk; batched objects are small, so chunks hold many
+constexpr size_t ObjectChunkSize = 16;
+
+bool SameMaterial(const Material &a, const Material &b) {
+    return a.ambient == b.ambient && a.diffuse == b.diffuse && a.specular == b.specular &&
+           a.shininess == b.shininess && a.diffuseTexture == b.diffuseTexture &&
+           a.specularTexture == b.specularTexture && a.normalTexture == b.normalTexture;
+}
+
+glm::vec3 NormalizeOrZero(const glm::vec3 &v) {
+    const float length = glm::length(v);
+    return length > 0.0f ? v / length : v;
+}
+
+// Transform one object's vertices and rebase its indices into the merged buffers
+void TransformObject(const StaticBatchSource &source, uint32_t baseVertex, Vertex *vertices, uint32_t *indices,
+                     StaticBatchRange &range) {
+    const std::vector<Vertex> &sourceVertices = source.mesh->GetVertices();
+    const std::vector<uint32_t> &sourceIndices = source.mesh->GetIndices();
+    const size_t vertexCount = sourceVertices.size();
+
+    const glm::mat4 &model = source.transform;
+    const glm::mat3 linear(model);
+    const glm::mat3 normalMatrix = glm::transpose(glm::inverse(linear));
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const Vertex &in = sourceVertices[i];
+        Vertex &out = vertices[i];
+        out.position = glm::vec3(model * glm::vec4(in.position, 1.0f));
+        out.normal = NormalizeOrZero(normalMatrix * in.normal);
+        out.texCoords = in.texCoords;
+        out.tangent = NormalizeOrZero(linear * in.tangent);
+        out.bitangent = NormalizeOrZero(linear * in.bitangent);
+        boundsMin = glm::min(boundsMin, out.position);
+        boundsMax = glm::max(boundsMax, out.position);
+    }
+
+    // A mirroring transform turns counter-clockwise triangles clockwise
+    const bool mirrored = glm::determinant(linear) < 0.0f;
+    for (uint32_t triangle = 0; triangle < range.indexCount / 3; ++triangle) {
+        uint32_t corner[3];
+        for (uint32_t c = 0; c < 3; ++c) {
+            corner[c] = sourceIndices.empty() ? triangle * 3 + c : sourceIndices[triangle * 3 + c];
+        }
+        // Out-of-range triangles would reach into other objects, so they collapse instead
+        if (corner[0] >= vertexCount || corner[1] >= vertexCount || corner[2] >= vertexCount) {
+            corner[0] = corner[1] = corner[2] = 0;
+        }
+        uint32_t *out = indices + triangle * 3;
+        out[0] = baseVertex + corner[0];
+        out[1] = baseVertex + (mirrored ? corner[2] : corner[1]);
+        out[2] = baseVertex + (mirrored ? corner[1] : corner[2]);
+    }
+
+    // The mesh's sphere carried along, or the sphere around the world box, whichever is smaller
+    const BoundingSphere sphere = source.mesh->GetBoundingSphere();
+    const float scale = std::max(std::max(glm::length(linear[0]), glm::length(linear[1])), glm::length(linear[2]));
+    range.bounds.center = glm::vec3(model * glm::vec4(sphere.center, 1.0f));
+    range.bounds.radius = sphere.radius * scale;
+    if (vertexCount > 0) {
+        const float boxRadius = glm::length(boundsMax - boundsMin) * 0.5f;
+        if (boxRadius < range.bounds.radius) {
+            range.bounds.center = (boundsMin + boundsMax) * 0.5f;
+            range.bounds.radius = boxRadius;
+        }
+        range.boundsMin = boundsMin;
+        range.boundsMax = boundsMax;
+    }
+}
+
+} // namespace
+
+StaticBatch::StaticBatch() : m_lifetime(std::make_shared<StaticBatch *>(this)) {}
+
+StaticBatch::~StaticBatch() {
+    MemoryStats::Free(MemoryCategory::MeshGPU, m_trackedGPUBytes);
+}
+
+// ========== Objects ==========
+
+size_t StaticBatch::Add(std::shared_ptr<const Mesh> mesh, const glm::mat4 &transform) {
+    const Material material = mesh ? mesh->GetMaterial() : Material();
+    return Add(std::move(mesh), transform, material);
+}
+
+size_t StaticBatch::Add(std::shared_ptr<const Mesh> mesh, const glm::mat4 &transform, const Material &material) {
+    StaticBatchSource source;
+    source.mesh = std::move(mesh);
+    source.transform = transform;
+    source.material = material;
+    m_sources.push_back(std::move(source));
+    const size_t object = m_sources.size() - 1;
+    if (object < m_enabled.size()) {
+        m_enabled[object] = 1;
+    } else {
+        m_enabled.push_back(1);
+    }
+    return object;
+}
+
+void StaticBatch::SetTransform(size_t object, const glm::mat4 &transform) {
+    if (object < m_sources.size()) {
+        m_sources[object].transform = transform;
+    }
+}
+
+void StaticBatch::Clear() {
+    // Visibility flags stay for the built objects, which are still drawn
+    m_sources.clear();
+}
+
+void StaticBatch::SetEnabled(size_t object, bool enabled) {
+    if (object < m_enabled.size()) {
+        m_enabled[object] = enabled ? 1 : 0;
+    }
+}
+
+// ========== Building ==========
+
+bool StaticBatch::Merge(const std::vector<StaticBatchSource> &sources, StaticBatchGeometry &geometry) {
+    geometry = StaticBatchGeometry();
+    const size_t objectCount = sources.size();
+
+    // Groups in order of first use, then a counting sort of the objects by group
+    std::vector<uint32_t> objectGroups(objectCount);
+    for (size_t object = 0; object < objectCount; ++object) {
+        const Material &material = sources[object].material;
+        size_t group = 0;
+        while (group < geometry.materials.size() && !SameMaterial(geometry.materials[group], material)) {
+            ++group;
+        }
+        if (group == geometry.materials.size()) {
+            geometry.materials.push_back(material);
+        }
+        objectGroups[object] = static_cast<uint32_t>(group);
+    }
+
+    const size_t groupCount = geometry.materials.size();
+    geometry.groupOffsets.assign(groupCount + 1, 0);
+    for (uint32_t group : objectGroups) {
+        ++geometry.groupOffsets[group + 1];
+    }
+    for (size_t group = 0; group < groupCount; ++group) {
+        geometry.groupOffsets[group + 1] += geometry.groupOffsets[group];
+    }
+    geometry.drawOrder.resize(objectCount);
+    std::vector<uint32_t> cursor(geometry.groupOffsets.begin(), geometry.groupOffsets.end() - 1);
+    for (size_t object = 0; object < objectCount; ++object) {
+        geometry.drawOrder[cursor[objectGroups[object]]++] = static_cast<uint32_t>(object);
+    }
+
+    // Buffer offsets in draw order
+    geometry.ranges.resize(objectCount);
+    std::vector<uint32_t> baseVertices(objectCount, 0);
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (uint32_t object : geometry.drawOrder) {
+        const StaticBatchSource &source = sources[object];
+        StaticBatchRange &range = geometry.ranges[object];
+        range.group = objectGroups[object];
+        range.firstIndex = static_cast<uint32_t>(indexCount);
+        if (!source.mesh || !source.mesh->HasCPUData()) {
+            std::cerr << "StaticBatch: object " << object << " has no CPU vertices to merge" << std::endl;
+            continue;
+        }
+
+        const size_t meshVertices = source.mesh->GetVertices().size();
+        const size_t meshIndices =
+            source.mesh->GetIndices().empty() ? meshVertices / 3 * 3 : source.mesh->GetIndices().size() / 3 * 3;
+        baseVertices[object] = static_cast<uint32_t>(vertexCount);
+        range.indexCount = static_cast<uint32_t>(meshIndices);
+        vertexCount += meshVertices;
+        indexCount += meshIndices;
+        if (vertexCount > std::numeric_limits<uint32_t>::max() || indexCount > std::numeric_limits<uint32_t>::max()) {
+            std::cerr << "StaticBatch: merged geometry exceeds 32-bit indices" << std::endl;
+            geometry = StaticBatchGeometry();
+            return false;
+        }
+    }
+
+    geometry.vertices.resize(vertexCount);
+    geometry.indices.resize(indexCount);
+    ThreadPool::Shared().ParallelFor(objectCount, ObjectChunkSize, [&](size_t, size_t begin, size_t end) {
+        for (size_t object = begin; object < end; ++object) {
+            const StaticBatchSource &source = sources[object];
+            if (source.mesh && source.mesh->HasCPUData()) {
+                StaticBatchRange &range = geometry.ranges[object];
+                TransformObject(source, baseVertices[object], geometry.vertices.data() + baseVertices[object],
+                                geometry.indices.data() + range.firstIndex, range);
+            }
+        }
+    });
+    return true;
+}
+
+bool StaticBatch::Build() {
+    StaticBatchGeometry geometry;
+    if (!Merge(m_sources, geometry)) {
+        return false;
+    }
+
+    // Anything still in flight is older than this
+    ++m_buildGeneration;
+    Upload(geometry);
+    return true;
+}
+
+void StaticBatch::BuildAsync(BuildCallback onBuilt) {
+    const uint64_t generation = ++m_buildGeneration;
+    ++m_pendingBuilds;
+
+    // The worker merges a snapshot, so objects can be added while it runs
+    auto sources = std::make_shared<std::vector<StaticBatchSource>>(m_sources);
+    std::weak_ptr<StaticBatch *> lifetime = m_lifetime;
+    ThreadPool::Shared().Enqueue([sources, generation, lifetime, onBuilt]() mutable {
+        auto geometry = std::make_shared<StaticBatchGeometry>();
+        const bool merged = Merge(*sources, *geometry);
+
+        // Buffers are GL objects, so they are created on the main thread. The snapshot goes along: it may
+        // hold the last reference to a mesh or texture, which must be destroyed there too.
+        DispatchQueue::main().async([sources = std::move(sources), geometry, merged, generation, lifetime, onBuilt]() {
+            std::shared_ptr<StaticBatch *> alive = lifetime.lock();
+            if (!alive) {
+                return;
+            }
+            StaticBatch &batch = **alive;
+            --batch.m_pendingBuilds;
+            const bool current = merged && generation == batch.m_buildGeneration;
+            if (current) {
+                batch.Upload(*geometry);
+            }
+            if (onBuilt) {
+                onBuilt(current);
+            }
+        });
+    });
+}
+
+void StaticBatch::Upload(StaticBatchGeometry &geometry) {
+    m_VAO = std::make_unique<VertexArray>();
+    m_VBO = std::make_shared<VertexBuffer>(geometry.vertices);
+    m_VAO->AddVertexBuffer(m_VBO, VertexBufferLayout::StandardMesh());
+    m_EBO.reset();
+    if (!geometry.indices.empty()) {
+        m_EBO = std::make_shared<IndexBuffer>(geometry.indices);
+        m_VAO->SetIndexBuffer(m_EBO);
+    }
+    m_VAO->Unbind();
+
+    // Only the draw ranges stay on the CPU
+    m_vertexCount = geometry.vertices.size();
+    m_indexCount = geometry.indices.size();
+    m_ranges = std::move(geometry.ranges);
+    m_materials = std::move(geometry.materials);
+    m_drawOrder = std::move(geometry.drawOrder);
+    m_groupOffsets = std::move(geometry.groupOffsets);
+    geometry = StaticBatchGeometry();
+
+    const size_t gpuBytes = m_VBO->GetSize() + (m_EBO ? m_EBO->GetSize() : 0);
+    if (gpuBytes > m_trackedGPUBytes) {
+        MemoryStats::Allocate(MemoryCategory::MeshGPU, gpuBytes - m_trackedGPUBytes);
+    } else {
+        MemoryStats::Free(MemoryCategory::MeshGPU, m_trackedGPUBytes - gpuBytes);
+    }
+    m_trackedGPUBytes = gpuBytes;
+}
+
+// ========== Rendering ==========
+
+void StaticBatch::Render(ShaderProgram &shader) {
+    Draw(shader, nullptr);
+}
+
+void StaticBatch::Render(ShaderProgram &shader, const Frustum &frustum) {
+    Draw(shader, &frustum);
+}
+
+void StaticBatch::Draw(ShaderProgram &shader, const Frustum *frustum) {
+    m_stats = StaticBatchStats{};
+    if (!m_VAO || m_indexCount == 0) {
+        return;
+    }
+
+    shader.Use();
+    shader.SetUniform("model", glm::mat4(1.0f));
+    shader.SetUniform("normalMatrix", glm::mat3(1.0f));
+    m_VAO->Bind();
+
+    for (size_t group = 0; group < m_materials.size(); ++group) {
+        // Visible objects of the group, with neighbours in the buffer joined into one range
+        m_drawCounts.clear();
+        m_drawOffsets.clear();
+        uint32_t rangeEnd = 0;
+        for (uint32_t i = m_groupOffsets[group]; i < m_groupOffsets[group + 1]; ++i) {
+            const uint32_t object = m_drawOrder[i];
+            const StaticBatchRange &range = m_ranges[object];
+            if (range.indexCount == 0 || !IsEnabled(object)) {
+                continue;
+            }
+            if (frustum && (!frustum->IntersectsSphere(range.bounds.center, range.bounds.radius) ||
+                            !frustum->IntersectsBox(range.boundsMin, range.boundsMax))) {
+                continue;
+            }
+
+            m_stats.visibleObjects++;
+            if (!m_drawCounts.empty() && rangeEnd == range.firstIndex) {
+                m_drawCounts.back() += static_cast<GLsizei>(range.indexCount);
+            } else {
+                m_drawCounts.push_back(static_cast<GLsizei>(range.indexCount));
+                m_drawOffsets.push_back(
+                    reinterpret_cast<const void *>(static_cast<uintptr_t>(range.firstIndex) * sizeof(uint32_t)));
+            }
+            rangeEnd = range.firstIndex + range.indexCount;
+        }
+        if (m_drawCounts.empty()) {
+            continue;
+        }
+
+        ApplyMaterial(shader, m_materials[group]);
+        glMultiDrawElements(GL_TRIANGLES, m_drawCounts.data(), GL_UNSIGNED_INT, m_drawOffsets.data(),
+                            static_cast<GLsizei>(m_drawCounts.size()));
+        m_stats.drawCalls++;
+        m_stats.ranges += static_cast<uint32_t>(m_drawCounts.size());
+    }
+
+    m_VAO->Unbind();
+}
+
+} // namespace agl
@@ -0,0 +1,176 @@
+#include "SweptCollision.h"
+#include "SimdLanes.h"
+#include <limits>
+
+namespace agl {
+
+namespace {
+
+// Every path pads to this many lanes so kernels never need a scalar tail
+constexpr size_t LanePadding = 8;
+
+// Padding segments start far outside any sensible scene and never move, so they
+// never report a hit
+constexpr float PaddingCoordinate = 1.0e30f;
+
+constexpr float NoHit = std::numeric_limits<float>::infinity();
+
+} // namespace
+
+/**
+ * @brief Raw view of a batch's arrays handed to the kernels
+ */
+struct SweptSegmentArrays {
+    explicit SweptSegmentArrays(SweptCollisionBatch &batch)
+        : paddedCount(batch.m_paddedCount), radius(batch.m_radius), startX(batch.m_startX.data()),
+          startY(batch.m_startY.data()), startZ(batch.m_startZ.data()), deltaX(batch.m_deltaX.data()),
+          deltaY(batch.m_deltaY.data()), deltaZ(batch.m_deltaZ.data()), inverseDeltaX(batch.m_inverseDeltaX.data()),
+          inverseDeltaY(batch.m_inverseDeltaY.data()), inverseDeltaZ(batch.m_inverseDeltaZ.data()),
+          lengthSquared(batch.m_lengthSquared.data()), times(batch.m_times.data()), targets(batch.m_targets.data()),
+          types(batch.m_types.data()) {}
+
+    size_t paddedCount;
+    float radius;
+    const float *startX, *startY, *startZ;
+    const float *deltaX, *deltaY, *deltaZ;
+    const float *inverseDeltaX, *inverseDeltaY, *inverseDeltaZ;
+    const float *lengthSquared;
+    float *times;
+    uint32_t *targets;
+    CollisionShapeType *types;
+};
+
+namespace scalar {
+#define AGL_SWEPT_LANES simd::ScalarLanes
+#define AGL_SWEPT_TARGET
+#include "SweptCollisionKernels.h"
+#undef AGL_SWEPT_LANES
+#undef AGL_SWEPT_TARGET
+} // namespace scalar
+
+#if defined(AGL_SIMD_X86)
+
+namespace sse2 {
+#define AGL_SWEPT_LANES simd::SSE2Lanes
+#define AGL_SWEPT_TARGET AGL_TARGET_SSE2
+#include "SweptCollisionKernels.h"
+#undef AGL_SWEPT_LANES
+#undef AGL_SWEPT_TARGET
+} // namespace sse2
+
+namespace avx2 {
+#define AGL_SWEPT_LANES simd::AVX2Lanes
+#define AGL_SWEPT_TARGET AGL_TARGET_AVX2
+#include "SweptCollisionKernels.h"
+#undef AGL_SWEPT_LANES
+#undef AGL_SWEPT_TARGET
+} // namespace avx2
+
+#endif // AGL_SIMD_X86
+
+// ========== SweptCollisionBatch Implementation ==========
+
+void SweptCollisionBatch::SetSegments(const glm::vec3 *starts, const glm::vec3 *ends, size_t count, float radius) {
+    m_segmentCount = count;
+    m_paddedCount = (count + LanePadding - 1) / LanePadding * LanePadding;
+    m_radius = radius;
+
+    m_startX.resize(m_paddedCount);
+    m_startY.resize(m_paddedCount);
+    m_startZ.resize(m_paddedCount);
+    m_deltaX.resize(m_paddedCount);
+    m_deltaY.resize(m_paddedCount);
+    m_deltaZ.resize(m_paddedCount);
+    m_inverseDeltaX.resize(m_paddedCount);
+    m_inverseDeltaY.resize(m_paddedCount);
+    m_inverseDeltaZ.resize(m_paddedCount);
+    m_lengthSquared.resize(m_paddedCount);
+
+    for (size_t i = 0; i < m_paddedCount; ++i) {
+        glm::vec3 start(PaddingCoordinate);
+        glm::vec3 delta(0.0f);
+        if (i < count) {
+            start = starts[i];
+            delta = ends[i] - starts[i];
+        }
+
+        m_startX[i] = start.x;
+        m_startY[i] = start.y;
+        m_startZ[i] = start.z;
+        m_deltaX[i] = delta.x;
+        m_deltaY[i] = delta.y;
+        m_deltaZ[i] = delta.z;
+        // Division by zero gives +-infinity, which the slab test handles
+        m_inverseDeltaX[i] = 1.0f / delta.x;
+        m_inverseDeltaY[i] = 1.0f / delta.y;
+        m_inverseDeltaZ[i] = 1.0f / delta.z;
+        m_lengthSquared[i] = glm::dot(delta, delta);
+    }
+
+    ResetHits();
+}
+
+void SweptCollisionBatch::ResetHits() {
+    m_times.assign(m_paddedCount, NoHit);
+    m_targets.assign(m_paddedCount, 0);
+    m_types.assign(m_paddedCount, CollisionShapeType::None);
+}
+
+void SweptCollisionBatch::SweepSpheres(const CollisionSphere *targets, size_t targetCount) {
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        avx2::SweepSpheres(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+    case simd::InstructionSet::SSE2:
+        sse2::SweepSpheres(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+#endif
+    default:
+        scalar::SweepSpheres(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+    }
+}
+
+void SweptCollisionBatch::SweepAABBs(const CollisionAABB *targets, size_t targetCount) {
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        avx2::SweepAABBs(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+    case simd::InstructionSet::SSE2:
+        sse2::SweepAABBs(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+#endif
+    default:
+        scalar::SweepAABBs(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+    }
+}
+
+void SweptCollisionBatch::SweepCapsules(const CollisionCapsule *targets, size_t targetCount) {
+    switch (simd::GetInstructionSet()) {
+#if defined(AGL_SIMD_X86)
+    case simd::InstructionSet::AVX2:
+        avx2::SweepCapsules(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+    case simd::InstructionSet::SSE2:
+        sse2::SweepCapsules(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+#endif
+    default:
+        scalar::SweepCapsules(SweptSegmentArrays(*this), targets, targetCount);
+        break;
+    }
+}
+
+void SweptCollisionBatch::GetHits(std::vector<SweptHit> &hits) const {
+    hits.clear();
+    for (size_t i = 0; i < m_segmentCount; ++i) {
+        if (m_types[i] != CollisionShapeType::None) {
+            hits.push_back(SweptHit{static_cast<uint32_t>(i), m_targets[i], m_types[i], m_times[i]});
+        }
+    }
+}
+
+} // namespace agl
@@ -0,0 +1,95 @@
+// Swept collision kernels, compiled once per instruction set.
+//
+// No include guard: SweptCollision.cpp includes this file once per lane wrapper,
+// inside a namespace named after the instruction set, with AGL_SWEPT_LANES set
+// to a simd::*Lanes type and AGL_SWEPT_TARGET to the matching target attribute.
+// Each kernel keeps the earliest time per segment in SweptSegmentArrays::times.
+
+using L = AGL_SWEPT_LANES;
+using Float = L::Float;
+using Mask = L::Mask;
+
+#define AGL_SHAPE_TARGET AGL_SWEPT_TARGET
+#include "CollisionShapeKernels.h"
+#undef AGL_SHAPE_TARGET
+
+// Merge one block of candidate times into the batch results
+AGL_SWEPT_TARGET inline void Commit(const SweptSegmentArrays &segments, size_t i, Mask hit, Float time,
+                                    uint32_t targetIndex, CollisionShapeType type) {
+    const Float best = L::Load(segments.times + i);
+    const Mask improve = L::And(hit, L::Less(time, best));
+    uint32_t mask = L::MoveMask(improve);
+    if (mask == 0) {
+        return;
+    }
+
+    L::Store(segments.times + i, L::Select(improve, time, best));
+    while (mask != 0) {
+        const size_t lane = i + simd::CountTrailingZeros(mask);
+        segments.targets[lane] = targetIndex;
+        segments.types[lane] = type;
+        mask &= mask - 1;
+    }
+}
+
+AGL_SWEPT_TARGET void SweepSpheres(const SweptSegmentArrays &segments, const CollisionSphere *targets,
+                                   size_t targetCount) {
+    for (size_t t = 0; t < targetCount; ++t) {
+        const float radius = targets[t].radius + segments.radius;
+        const Float cx = L::Set1(targets[t].center.x);
+        const Float cy = L::Set1(targets[t].center.y);
+        const Float cz = L::Set1(targets[t].center.z);
+        const Float radiusSquared = L::Set1(radius * radius);
+
+        for (size_t i = 0; i < segments.paddedCount; i += L::Width) {
+            const Float mx = L::Sub(L::Load(segments.startX + i), cx);
+            const Float my = L::Sub(L::Load(segments.startY + i), cy);
+            const Float mz = L::Sub(L::Load(segments.startZ + i), cz);
+
+            Float time;
+            const Mask hit = SphereTime(mx, my, mz, L::Load(segments.deltaX + i), L::Load(segments.deltaY + i),
+                                        L::Load(segments.deltaZ + i), L::Load(segments.lengthSquared + i),
+                                        radiusSquared, time);
+            Commit(segments, i, hit, time, static_cast<uint32_t>(t), CollisionShapeType::Sphere);
+        }
+    }
+}
+
+AGL_SWEPT_TARGET void SweepAABBs(const SweptSegmentArrays &segments, const CollisionAABB *targets,
+                                 size_t targetCount) {
+    const Float one = L::Set1(1.0f);
+
+    for (size_t t = 0; t < targetCount; ++t) {
+        const Float minX = L::Set1(targets[t].min.x - segments.radius);
+        const Float minY = L::Set1(targets[t].min.y - segments.radius);
+        const Float minZ = L::Set1(targets[t].min.z - segments.radius);
+        const Float maxX = L::Set1(targets[t].max.x + segments.radius);
+        const Float maxY = L::Set1(targets[t].max.y + segments.radius);
+        const Float maxZ = L::Set1(targets[t].max.z + segments.radius);
+
+        for (size_t i = 0; i < segments.paddedCount; i += L::Width) {
+            Float time;
+            const Mask hit = BoxTime(L::Load(segments.startX + i), L::Load(segments.startY + i),
+                                     L::Load(segments.startZ + i), L::Load(segments.inverseDeltaX + i),
+                                     L::Load(segments.inverseDeltaY + i), L::Load(segments.inverseDeltaZ + i), minX,
+                                     minY, minZ, maxX, maxY, maxZ, one, time);
+            Commit(segments, i, hit, time, static_cast<uint32_t>(t), CollisionShapeType::AABB);
+        }
+    }
+}
+
+AGL_SWEPT_TARGET void SweepCapsules(const SweptSegmentArrays &segments, const CollisionCapsule *targets,
+                                    size_t targetCount) {
+    for (size_t t = 0; t < targetCount; ++t) {
+        const CapsuleLanes capsule = MakeCapsuleLanes(targets[t], targets[t].radius + segments.radius);
+
+        for (size_t i = 0; i < segments.paddedCount; i += L::Width) {
+            Float time;
+            const Mask hit = CapsuleTime(capsule, L::Load(segments.startX + i), L::Load(segments.startY + i),
+                                         L::Load(segments.startZ + i), L::Load(segments.deltaX + i),
+                                         L::Load(segments.deltaY + i), L::Load(segments.deltaZ + i),
+                                         L::Load(segments.lengthSquared + i), time);
+            Commit(segments, i, hit, time, static_cast<uint32_t>(t), CollisionShapeType::Capsule);
+        }
+    }
+}
@@ -143,7 +143,22 @@ void Texture2D::CreateFromData(uint32_t width, uint32_t height, TextureFormat fo
 }
 
 bool Texture2D::LoadFromFile(const std::string &filepath, bool flipVertically) {
-    stbi_set_flip_vertically_on_load(flipVertically);
+    TextureImage image;
+    if (!DecodeFile(filepath, image, flipVertically)) {
+        return false;
+    }
+
+    CreateFromImage(image);
+    return true;
+}
+
+void Texture2D::CreateFromImage(const TextureImage &image) {
+    CreateFromData(image.width, image.height, image.format, TextureDataType::UnsignedByte, image.pixels.data());
+}
+
+bool Texture2D::DecodeFile(const std::string &filepath, TextureImage &image, bool flipVertically) {
+    // The thread-local flag keeps concurrent decodes from changing each other's orientation
+    stbi_set_flip_vertically_on_load_thread(flipVertically);
 
     int width, height, channels;
     unsigned char *data = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
@@ -174,7 +189,10 @@ bool Texture2D::LoadFromFile(const std::string &filepath, bool flipVertically) {
         return false;
     }
 
-    CreateFromData(width, height, format, TextureDataType::UnsignedByte, data);
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.format = format;
+    image.pixels.assign(data, data + static_cast<size_t>(width) * height * channels);
 
     stbi_image_free(data);
 
@@ -413,6 +431,18 @@ std::shared_ptr<Texture2D> TextureManager::LoadTexture(const std::string &name,
     return nullptr;
 }
 
+std::shared_ptr<Texture2D> TextureManager::AddTexture(const std::string &name, const TextureImage &image) {
+    auto it = m_textures.find(name);
+    if (it != m_textures.end()) {
+        return it->second;
+    }
+
+    auto sharedTexture = std::make_shared<Texture2D>();
+    sharedTexture->CreateFromImage(image);
+    m_textures[name] = sharedTexture;
+    return sharedTexture;
+}
+
 std::shared_ptr<Texture2D> TextureManager::CreateSolidColorTexture(const std::string &name, uint32_t width,
                                                                    uint32_t height, float r, float g, float b,
                                                                    float a) {
@@ -0,0 +1,118 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace agl {
+
+ThreadPool &ThreadPool::Shared() {
+    static ThreadPool sharedPool;
+    return sharedPool;
+}
+
+size_t ThreadPool::DefaultWorkerCount() {
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+ThreadPool::ThreadPool(size_t workerCount) {
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread &worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Enqueue(TaskType task) {
+    if (m_workers.empty()) {
+        task();
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        TaskType task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return; // Stopping and drained
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t chunkSize, const ChunkFunction &func) {
+    if (count == 0) {
+        return;
+    }
+
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    if (chunkCount == 1 || m_workers.empty()) {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            const size_t begin = chunk * chunkSize;
+            func(chunk, begin, std::min(begin + chunkSize, count));
+        }
+        return;
+    }
+
+    // Shared so helpers that start after the loop has finished find nothing left
+    // to claim and exit without touching the caller's stack
+    struct LoopState {
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> completedChunks{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<LoopState>();
+
+    auto runChunks = [state, &func, count, chunkSize, chunkCount]() {
+        size_t completed = 0;
+        for (size_t chunk = state->nextChunk.fetch_add(1); chunk < chunkCount;
+             chunk = state->nextChunk.fetch_add(1)) {
+            const size_t begin = chunk * chunkSize;
+            func(chunk, begin, std::min(begin + chunkSize, count));
+            ++completed;
+        }
+
+        if (completed > 0 && state->completedChunks.fetch_add(completed) + completed == chunkCount) {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->finished.notify_all();
+        }
+    };
+
+    const size_t helperCount = std::min(m_workers.size(), chunkCount - 1);
+    for (size_t i = 0; i < helperCount; ++i) {
+        Enqueue(runChunks);
+    }
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, chunkCount] { return state->completedChunks.load() == chunkCount; });
+}
+
+} // namespace agl
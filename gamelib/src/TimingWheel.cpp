@@ -0,0 +1,86 @@
+#include "TimingWheel.h"
+#include <utility>
+
+namespace agl {
+
+namespace {
+
+constexpr uint64_t SlotMask = TimingWheel::SlotCount - 1;
+
+// Number of ticks one slot of a level covers
+constexpr uint64_t LevelSpan(uint32_t level) {
+    return uint64_t(1) << (TimingWheel::SlotBits * level);
+}
+
+} // namespace
+
+void TimingWheel::Schedule(uint64_t tick, uint64_t id) {
+    // The current tick's slot has already been emptied, so overdue entries go into the next one
+    Insert(Entry{tick > m_currentTick ? tick : m_currentTick + 1, id});
+    ++m_size;
+}
+
+void TimingWheel::Insert(const Entry &entry) {
+    uint64_t tick = entry.tick;
+    const uint64_t delta = tick - m_currentTick;
+
+    uint32_t level = 0;
+    while (level + 1 < LevelCount && delta >= LevelSpan(level + 1)) {
+        ++level;
+    }
+
+    // Beyond the top level's reach: park in its furthest slot and re-file on cascade
+    const uint64_t reach = LevelSpan(LevelCount) - 1;
+    if (delta > reach) {
+        tick = m_currentTick + reach;
+    }
+
+    const uint32_t slot = static_cast<uint32_t>((tick >> (SlotBits * level)) & SlotMask);
+    m_slots[level][slot].push_back(entry);
+}
+
+void TimingWheel::Cascade(uint32_t level, uint32_t slot) {
+    m_cascadeScratch.clear();
+    std::swap(m_cascadeScratch, m_slots[level][slot]);
+    for (const Entry &entry : m_cascadeScratch) {
+        Insert(entry);
+    }
+}
+
+void TimingWheel::Advance(uint64_t tick, std::vector<uint64_t> &expired) {
+    while (m_currentTick < tick) {
+        ++m_currentTick;
+
+        // When a level wraps to slot 0, the next level's current slot becomes due
+        // and its entries move down
+        for (uint32_t level = 1; level < LevelCount; ++level) {
+            if ((m_currentTick & (LevelSpan(level) - 1)) != 0) {
+                break;
+            }
+            Cascade(level, static_cast<uint32_t>((m_currentTick >> (SlotBits * level)) & SlotMask));
+        }
+
+        std::vector<Entry> &due = m_slots[0][m_currentTick & SlotMask];
+        for (const Entry &entry : due) {
+            expired.push_back(entry.id);
+        }
+        m_size -= due.size();
+        due.clear();
+
+        // Nothing left to expire: jump straight to the target tick
+        if (m_size == 0) {
+            m_currentTick = tick;
+        }
+    }
+}
+
+void TimingWheel::Clear() {
+    for (auto &level : m_slots) {
+        for (std::vector<Entry> &slot : level) {
+            slot.clear();
+        }
+    }
+    m_size = 0;
+}
+
+} // namespace agl
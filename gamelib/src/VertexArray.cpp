@@ -54,13 +54,23 @@ void VertexArray::AddVertexBuffer(std::shared_ptr<VertexBuffer> vertexBuffer, co
     m_vertexBuffers.push_back(vertexBuffer);
 }
 
+void VertexArray::AddInstanceBuffer(std::shared_ptr<VertexBuffer> vertexBuffer, const VertexBufferLayout &layout,
+                                    uint32_t divisor) {
+    Bind();
+    vertexBuffer->Bind();
+
+    SetupVertexAttributes(layout, divisor);
+
+    m_vertexBuffers.push_back(vertexBuffer);
+}
+
 void VertexArray::SetIndexBuffer(std::shared_ptr<IndexBuffer> indexBuffer) {
     Bind();
     indexBuffer->Bind();
     m_indexBuffer = indexBuffer;
 }
 
-void VertexArray::SetupVertexAttributes(const VertexBufferLayout &layout) {
+void VertexArray::SetupVertexAttributes(const VertexBufferLayout &layout, uint32_t divisor) {
     const auto &elements = layout.GetElements();
 
     for (const auto &element : elements) {
@@ -70,6 +80,10 @@ void VertexArray::SetupVertexAttributes(const VertexBufferLayout &layout) {
                               element.normalized ? GL_TRUE : GL_FALSE, layout.GetStride(),
                               reinterpret_cast<const void *>(element.offset));
 
+        if (divisor != 0) {
+            glVertexAttribDivisor(m_vertexBufferIndex, divisor);
+        }
+
         m_vertexBufferIndex++;
     }
 }
@@ -90,6 +104,11 @@ void VertexArray::DrawElements(GLenum mode, uint32_t count) const {
     glDrawElements(mode, count, GL_UNSIGNED_INT, nullptr);
 }
 
+void VertexArray::DrawElementsInstanced(GLenum mode, uint32_t count, uint32_t instanceCount) const {
+    Bind();
+    glDrawElementsInstanced(mode, count, GL_UNSIGNED_INT, nullptr, instanceCount);
+}
+
 std::unique_ptr<VertexArray> VertexArray::Create() {
     return std::make_unique<VertexArray>();
 }
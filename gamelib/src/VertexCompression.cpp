@@ -0,0 +1,275 @@
+#include "VertexCompression.h"
+#include "mesh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace agl {
+
+namespace {
+
+constexpr float Pi = 3.14159265358979f;
+
+int8_t ToSnorm8(float value) {
+    return static_cast<int8_t>(std::lround(std::min(std::max(value, -1.0f), 1.0f) * 127.0f));
+}
+
+/**
+ * @brief Orthonormal basis around a unit normal (Duff et al. 2017), mirrored by the GLSL decoder
+ */
+void BuildBasis(const glm::vec3 &n, glm::vec3 &b1, glm::vec3 &b2) {
+    const float sign = n.z >= 0.0f ? 1.0f : -1.0f;
+    const float a = -1.0f / (sign + n.z);
+    const float b = n.x * n.y * a;
+    b1 = glm::vec3(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+    b2 = glm::vec3(b, sign + n.y * n.y * a, -n.y);
+}
+
+} // namespace
+
+size_t GetVertexStride(VertexFormat format) {
+    switch (format) {
+    case VertexFormat::Compact:
+        return sizeof(CompactVertex);
+    case VertexFormat::CompactQuantized:
+        return sizeof(QuantizedVertex);
+    case VertexFormat::Standard:
+        break;
+    }
+    return sizeof(Vertex);
+}
+
+// ========== Half floats ==========
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFFu) {
+        // Infinity stays infinity, NaN stays a (quiet) NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u));
+    }
+
+    const int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if (halfExponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+
+    uint32_t half;
+    uint32_t remainder;
+    uint32_t halfway;
+    if (halfExponent <= 0) {
+        // Subnormal half (or zero)
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        half = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1u);
+        halfway = 1u << (shift - 1u);
+    } else {
+        half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        remainder = mantissa & 0x1FFFu;
+        halfway = 0x1000u;
+    }
+
+    // Round to nearest even; a carry out of the mantissa correctly bumps the exponent
+    if (remainder > halfway || (remainder == halfway && (half & 1u) != 0)) {
+        ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1Fu;
+    const uint32_t mantissa = value & 0x3FFu;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign != 0 ? -magnitude : magnitude;
+    } else if (exponent == 0x1Fu) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// ========== Tangent frames ==========
+
+void EncodeOctahedral(const glm::vec3 &direction, int8_t encoded[2]) {
+    const float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (length <= 0.0f) {
+        encoded[0] = 0;
+        encoded[1] = 0;
+        return;
+    }
+
+    // Project onto the octahedron and fold the lower half over the upper one
+    glm::vec3 n = direction / length;
+    float x = n.x;
+    float y = n.y;
+    if (n.z < 0.0f) {
+        x = (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        y = (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    // Try the four surrounding grid points and keep the most accurate one
+    const glm::vec3 target = glm::normalize(direction);
+    const float baseX = std::floor(std::min(std::max(x, -1.0f), 1.0f) * 127.0f);
+    const float baseY = std::floor(std::min(std::max(y, -1.0f), 1.0f) * 127.0f);
+    float bestDot = -2.0f;
+    for (int dy = 0; dy <= 1; ++dy) {
+        for (int dx = 0; dx <= 1; ++dx) {
+            const int8_t candidate[2] = {static_cast<int8_t>(std::min(baseX + dx, 127.0f)),
+                                         static_cast<int8_t>(std::min(baseY + dy, 127.0f))};
+            const float dot = glm::dot(DecodeOctahedral(candidate), target);
+            if (dot > bestDot) {
+                bestDot = dot;
+                encoded[0] = candidate[0];
+                encoded[1] = candidate[1];
+            }
+        }
+    }
+}
+
+glm::vec3 DecodeOctahedral(const int8_t encoded[2]) {
+    glm::vec3 n(encoded[0] / 127.0f, encoded[1] / 127.0f, 0.0f);
+    n.z = 1.0f - std::abs(n.x) - std::abs(n.y);
+    const float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return glm::normalize(n);
+}
+
+void EncodeTangentFrame(const glm::vec3 &normal, const glm::vec3 &tangent, const glm::vec3 &bitangent,
+                        int8_t encoded[4]) {
+    EncodeOctahedral(normal, encoded);
+
+    // The tangent is stored as an angle in the basis the decoder rebuilds from the
+    // quantized normal, so both sides agree on the reference direction
+    glm::vec3 b1;
+    glm::vec3 b2;
+    BuildBasis(DecodeOctahedral(encoded), b1, b2);
+    const float u = glm::dot(tangent, b1);
+    const float v = glm::dot(tangent, b2);
+    encoded[2] = (u * u + v * v > 1e-12f) ? ToSnorm8(std::atan2(v, u) / Pi) : 0;
+
+    encoded[3] = glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -127 : 127;
+}
+
+void DecodeTangentFrame(const int8_t encoded[4], glm::vec3 &normal, glm::vec3 &tangent, glm::vec3 &bitangent) {
+    normal = DecodeOctahedral(encoded);
+
+    glm::vec3 b1;
+    glm::vec3 b2;
+    BuildBasis(normal, b1, b2);
+    const float angle = encoded[2] / 127.0f * Pi;
+    tangent = std::cos(angle) * b1 + std::sin(angle) * b2;
+    bitangent = glm::cross(normal, tangent) * (encoded[3] < 0 ? -1.0f : 1.0f);
+}
+
+// ========== Packing ==========
+
+void PackVertices(const Vertex *vertices, size_t count, VertexFormat format, const glm::vec3 &boundsMin,
+                  const glm::vec3 &boundsMax, void *destination) {
+    if (format == VertexFormat::Standard) {
+        std::memcpy(destination, vertices, count * sizeof(Vertex));
+        return;
+    }
+
+    if (format == VertexFormat::Compact) {
+        auto *packed = static_cast<CompactVertex *>(destination);
+        for (size_t i = 0; i < count; ++i) {
+            const Vertex &vertex = vertices[i];
+            CompactVertex &out = packed[i];
+            out.position[0] = vertex.position.x;
+            out.position[1] = vertex.position.y;
+            out.position[2] = vertex.position.z;
+            EncodeTangentFrame(vertex.normal, vertex.tangent, vertex.bitangent, out.normalTangent);
+            out.texCoords[0] = FloatToHalf(vertex.texCoords.x);
+            out.texCoords[1] = FloatToHalf(vertex.texCoords.y);
+        }
+        return;
+    }
+
+    // Flat axes quantize to 0 and decode back to the minimum
+    const glm::vec3 extent = boundsMax - boundsMin;
+    const glm::vec3 scale(extent.x > 0.0f ? 65535.0f / extent.x : 0.0f, extent.y > 0.0f ? 65535.0f / extent.y : 0.0f,
+                          extent.z > 0.0f ? 65535.0f / extent.z : 0.0f);
+    auto quantize = [](float value) {
+        return static_cast<uint16_t>(std::lround(std::min(std::max(value, 0.0f), 65535.0f)));
+    };
+
+    auto *packed = static_cast<QuantizedVertex *>(destination);
+    for (size_t i = 0; i < count; ++i) {
+        const Vertex &vertex = vertices[i];
+        QuantizedVertex &out = packed[i];
+        const glm::vec3 position = (vertex.position - boundsMin) * scale;
+        out.position[0] = quantize(position.x);
+        out.position[1] = quantize(position.y);
+        out.position[2] = quantize(position.z);
+        out.position[3] = 0;
+        EncodeTangentFrame(vertex.normal, vertex.tangent, vertex.bitangent, out.normalTangent);
+        out.texCoords[0] = FloatToHalf(vertex.texCoords.x);
+        out.texCoords[1] = FloatToHalf(vertex.texCoords.y);
+    }
+}
+
+// ========== Shader decoding ==========
+
+const char *GetCompactVertexDecodeGLSL() {
+    return R"(
+        // Quantized positions: object = stored * positionScale + positionOffset
+        uniform vec3 positionScale = vec3(1.0);
+        uniform vec3 positionOffset = vec3(0.0);
+
+        // True when location 1 holds the packed tangent frame rather than a float normal
+        uniform bool compactVertex = false;
+
+        vec3 agl_DecodePosition(vec3 position) {
+            return position * positionScale + positionOffset;
+        }
+
+        // Octahedral pair in [-127, 127] to unit vector
+        vec3 agl_DecodeOctahedral(vec2 encoded) {
+            vec2 e = encoded / 127.0;
+            vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+            float t = max(-n.z, 0.0);
+            n.x += n.x >= 0.0 ? -t : t;
+            n.y += n.y >= 0.0 ? -t : t;
+            return normalize(n);
+        }
+
+        void agl_DecodeTangentFrame(vec4 normalTangent, out vec3 normal, out vec3 tangent, out vec3 bitangent) {
+            normal = agl_DecodeOctahedral(normalTangent.xy);
+
+            float s = normal.z >= 0.0 ? 1.0 : -1.0;
+            float a = -1.0 / (s + normal.z);
+            float b = normal.x * normal.y * a;
+            vec3 b1 = vec3(1.0 + s * normal.x * normal.x * a, s * b, -s * normal.x);
+            vec3 b2 = vec3(b, s + normal.y * normal.y * a, -normal.y);
+
+            float angle = normalTangent.z / 127.0 * 3.14159265;
+            tangent = cos(angle) * b1 + sin(angle) * b2;
+            bitangent = cross(normal, tangent) * (normalTangent.w < 0.0 ? -1.0 : 1.0);
+        }
+
+        // Normal from location 1 declared as vec4, in any vertex format
+        vec3 agl_DecodeNormal(vec4 normalAttribute) {
+            return compactVertex ? agl_DecodeOctahedral(normalAttribute.xy) : normalAttribute.xyz;
+        }
+    )";
+}
+
+} // namespace agl
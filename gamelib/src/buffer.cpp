@@ -1,6 +1,17 @@
 #include "buffer.h"
+#include <GLFW/glfw3.h>
 #include <iostream>
 
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
 namespace agl {
 
 // ===== Base Buffer Class =====
@@ -94,6 +105,134 @@ void VertexBuffer::SetSubData(const void *data, size_t offset, size_t size) {
     Buffer::SetSubData(data, offset, size);
 }
 
+// ===== StreamingVertexBuffer Class =====
+
+namespace {
+
+// glBufferStorage is GL 4.4 / GL_ARB_buffer_storage, above the 3.3 core the engine
+// links against, so it is looked up at runtime
+using BufferStorageProc = void(APIENTRY *)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+BufferStorageProc GetBufferStorageProc() {
+    // Resolved once a context is current; a call made before that must not cache the miss
+    static BufferStorageProc proc = nullptr;
+    static bool resolved = false;
+    if (!resolved && glfwGetCurrentContext() != nullptr) {
+        resolved = true;
+        if (glfwExtensionSupported("GL_ARB_buffer_storage")) {
+            proc = reinterpret_cast<BufferStorageProc>(glfwGetProcAddress("glBufferStorage"));
+        }
+    }
+    return proc;
+}
+
+} // namespace
+
+StreamingVertexBuffer::~StreamingVertexBuffer() {
+    ReleaseStorage();
+}
+
+void StreamingVertexBuffer::ReleaseStorage() {
+    for (GLsync &fence : m_fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (m_bufferID != 0 && (m_persistentData || m_mapped)) {
+        Bind();
+        glUnmapBuffer(m_target);
+    }
+    m_persistentData = nullptr;
+    m_mapped = false;
+}
+
+void StreamingVertexBuffer::Allocate(size_t frameSize) {
+    ReleaseStorage();
+    m_frameSize = frameSize;
+    m_frame = 0;
+
+    // Immutable storage cannot be respecified, neither by glBufferStorage nor by
+    // glBufferData, so a reallocation needs a new buffer object
+    if (m_immutable) {
+        ReplaceBufferObject();
+    }
+
+    const size_t size = frameSize * FrameCount;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    BufferStorageProc bufferStorage = GetBufferStorageProc();
+    if (bufferStorage) {
+        Bind();
+        bufferStorage(m_target, static_cast<GLsizeiptr>(size), nullptr, flags);
+        m_persistentData = static_cast<uint8_t *>(glMapBufferRange(m_target, 0, size, flags));
+        m_size = size;
+        m_usage = GL_STREAM_DRAW;
+        if (m_persistentData) {
+            m_immutable = true;
+            return;
+        }
+
+        // Mapping failed; the mutable fallback below needs a buffer without the immutable store
+        ReplaceBufferObject();
+    }
+
+    Buffer::SetData(nullptr, size, GL_STREAM_DRAW);
+}
+
+void StreamingVertexBuffer::ReplaceBufferObject() {
+    glDeleteBuffers(1, &m_bufferID);
+    m_bufferID = 0;
+    m_size = 0;
+    m_immutable = false;
+    CreateBuffer(GL_ARRAY_BUFFER);
+}
+
+void *StreamingVertexBuffer::Map(size_t size) {
+    if (size > m_frameSize || m_mapped) {
+        return nullptr;
+    }
+
+    m_frame = (m_frame + 1) % FrameCount;
+    GLsync &fence = m_fences[m_frame];
+    if (fence) {
+        // Normally signalled long ago; only a GPU more than FrameCount frames behind blocks here
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    const size_t offset = static_cast<size_t>(m_frame) * m_frameSize;
+    if (m_persistentData) {
+        return m_persistentData + offset;
+    }
+
+    // The fence already guarantees the region is idle, so skip the driver's own synchronization
+    Bind();
+    void *data = glMapBufferRange(m_target, offset, size,
+                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    m_mapped = data != nullptr;
+    return data;
+}
+
+size_t StreamingVertexBuffer::Unmap() {
+    if (m_mapped) {
+        Bind();
+        glUnmapBuffer(m_target);
+        m_mapped = false;
+    }
+    return static_cast<size_t>(m_frame) * m_frameSize;
+}
+
+void StreamingVertexBuffer::Fence() {
+    GLsync &fence = m_fences[m_frame];
+    if (fence) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
 // ===== IndexBuffer Class =====
 
 IndexBuffer::IndexBuffer() : m_count(0) {
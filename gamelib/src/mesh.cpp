@@ -1,6 +1,17 @@
 #include "mesh.h"
+#include "Camera.h"
+#include "MemoryStats.h"
+#include "MeshKernels.h"
+#include "MeshOptimizer.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <tuple>
 
 #if defined(__APPLE__)
 #define GL_SILENCE_DEPRECATION
@@ -11,6 +22,111 @@
 
 namespace agl {
 
+namespace {
+
+// Clusters per ParallelFor chunk when their bounds are refreshed
+constexpr size_t MeshletChunkSize = 64;
+
+// clear() keeps the capacity; swapping with an empty vector returns the memory
+template <typename T>
+void ReleaseVector(std::vector<T> &vector) {
+    std::vector<T>().swap(vector);
+}
+
+// Report the difference between what was last reported and the current size
+void ReportMemory(MemoryCategory category, size_t &tracked, size_t bytes, bool released) {
+    if (bytes > tracked) {
+        MemoryStats::Allocate(category, bytes - tracked);
+    } else if (released) {
+        MemoryStats::Release(category, tracked - bytes);
+    } else {
+        MemoryStats::Free(category, tracked - bytes);
+    }
+    tracked = bytes;
+}
+
+std::pair<glm::vec3, glm::vec3> ComputeRangeBounds(const Vertex *vertices, size_t count) {
+    if (count == 0) {
+        return {glm::vec3(0.0f), glm::vec3(0.0f)};
+    }
+    glm::vec3 min = vertices[0].position;
+    glm::vec3 max = vertices[0].position;
+    for (size_t i = 1; i < count; ++i) {
+        min = glm::min(min, vertices[i].position);
+        max = glm::max(max, vertices[i].position);
+    }
+    return {min, max};
+}
+
+// Ritter's step: the smallest sphere containing both the sphere and the point
+void GrowSphere(glm::vec3 &center, float &radius, const glm::vec3 &point) {
+    const glm::vec3 offset = point - center;
+    const float distanceSquared = glm::dot(offset, offset);
+    if (distanceSquared <= radius * radius) {
+        return;
+    }
+    const float distance = std::sqrt(distanceSquared);
+    const float newRadius = (radius + distance) * 0.5f;
+    center += offset * ((newRadius - radius) / distance);
+    radius = newRadius;
+}
+
+// EPOS-14: the farthest pair among the extreme points along seven directions
+// seeds the sphere, then one Ritter pass takes in everything outside it
+void ComputeBoundingSphere(const Vertex *vertices, size_t count, glm::vec3 &center, float &radius) {
+    if (count == 0) {
+        center = glm::vec3(0.0f);
+        radius = 0.0f;
+        return;
+    }
+
+    static const glm::vec3 directions[7] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f},  {0.0f, 0.0f, 1.0f},
+                                            {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}, {1.0f, -1.0f, 1.0f},
+                                            {1.0f, -1.0f, -1.0f}};
+    size_t minIndex[7] = {};
+    size_t maxIndex[7] = {};
+    float minProjection[7];
+    float maxProjection[7];
+    for (int d = 0; d < 7; ++d) {
+        minProjection[d] = maxProjection[d] = glm::dot(vertices[0].position, directions[d]);
+    }
+    for (size_t i = 1; i < count; ++i) {
+        for (int d = 0; d < 7; ++d) {
+            const float projection = glm::dot(vertices[i].position, directions[d]);
+            if (projection < minProjection[d]) {
+                minProjection[d] = projection;
+                minIndex[d] = i;
+            }
+            if (projection > maxProjection[d]) {
+                maxProjection[d] = projection;
+                maxIndex[d] = i;
+            }
+        }
+    }
+
+    int widest = 0;
+    float widestSquared = -1.0f;
+    for (int d = 0; d < 7; ++d) {
+        const glm::vec3 span = vertices[maxIndex[d]].position - vertices[minIndex[d]].position;
+        const float lengthSquared = glm::dot(span, span);
+        if (lengthSquared > widestSquared) {
+            widestSquared = lengthSquared;
+            widest = d;
+        }
+    }
+    center = (vertices[minIndex[widest]].position + vertices[maxIndex[widest]].position) * 0.5f;
+    radius = std::sqrt(widestSquared) * 0.5f;
+
+    for (size_t i = 0; i < count; ++i) {
+        GrowSphere(center, radius, vertices[i].position);
+    }
+
+    // Absorb rounding in the incremental center updates
+    radius *= 1.0f + 4.0f * std::numeric_limits<float>::epsilon();
+}
+
+} // namespace
+
 // ========== Constructors ==========
 
 Mesh::Mesh() : m_isSetup(false) {
@@ -29,24 +145,69 @@ Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &ind
     SetupMesh();
 }
 
-Mesh::~Mesh() = default;
+Mesh::~Mesh() {
+    MemoryStats::Free(MemoryCategory::MeshCPU, m_trackedCPUBytes);
+    MemoryStats::Free(MemoryCategory::MeshGPU, m_trackedGPUBytes);
+}
 
 Mesh::Mesh(Mesh &&other) noexcept
     : m_vertices(std::move(other.m_vertices)), m_indices(std::move(other.m_indices)),
-      m_material(std::move(other.m_material)), m_VAO(std::move(other.m_VAO)), m_VBO(std::move(other.m_VBO)),
+      m_material(std::move(other.m_material)), m_vertexCount(other.m_vertexCount), m_indexCount(other.m_indexCount),
+      m_residency(other.m_residency), m_cpuDataReleased(other.m_cpuDataReleased),
+      m_positions(std::move(other.m_positions)), m_trackedCPUBytes(other.m_trackedCPUBytes),
+      m_trackedGPUBytes(other.m_trackedGPUBytes), m_sharedGeometry(std::move(other.m_sharedGeometry)),
+      m_vertexFormat(other.m_vertexFormat),
+      m_quantizationMin(other.m_quantizationMin), m_quantizationMax(other.m_quantizationMax),
+      m_lodIndices(std::move(other.m_lodIndices)), m_lods(std::move(other.m_lods)), m_activeLOD(other.m_activeLOD),
+      m_meshlets(std::move(other.m_meshlets)), m_meshletStats(other.m_meshletStats),
+      m_vertexTriangleOffsets(std::move(other.m_vertexTriangleOffsets)),
+      m_vertexTriangles(std::move(other.m_vertexTriangles)), m_boundsMin(other.m_boundsMin),
+      m_boundsMax(other.m_boundsMax), m_boundsCenter(other.m_boundsCenter),
+      m_boundsRadius(other.m_boundsRadius), m_instanceBuffers(std::move(other.m_instanceBuffers)),
+      m_VAO(std::move(other.m_VAO)), m_VBO(std::move(other.m_VBO)),
       m_EBO(std::move(other.m_EBO)), m_isSetup(other.m_isSetup) {
+    other.m_trackedCPUBytes = 0;
+    other.m_trackedGPUBytes = 0;
     other.m_isSetup = false;
 }
 
 Mesh &Mesh::operator=(Mesh &&other) noexcept {
     if (this != &other) {
+        MemoryStats::Free(MemoryCategory::MeshCPU, m_trackedCPUBytes);
+        MemoryStats::Free(MemoryCategory::MeshGPU, m_trackedGPUBytes);
+
         m_vertices = std::move(other.m_vertices);
         m_indices = std::move(other.m_indices);
         m_material = std::move(other.m_material);
+        m_vertexCount = other.m_vertexCount;
+        m_indexCount = other.m_indexCount;
+        m_residency = other.m_residency;
+        m_cpuDataReleased = other.m_cpuDataReleased;
+        m_positions = std::move(other.m_positions);
+        m_trackedCPUBytes = other.m_trackedCPUBytes;
+        m_trackedGPUBytes = other.m_trackedGPUBytes;
+        m_sharedGeometry = std::move(other.m_sharedGeometry);
+        m_vertexFormat = other.m_vertexFormat;
+        m_quantizationMin = other.m_quantizationMin;
+        m_quantizationMax = other.m_quantizationMax;
+        m_lodIndices = std::move(other.m_lodIndices);
+        m_lods = std::move(other.m_lods);
+        m_activeLOD = other.m_activeLOD;
+        m_meshlets = std::move(other.m_meshlets);
+        m_meshletStats = other.m_meshletStats;
+        m_vertexTriangleOffsets = std::move(other.m_vertexTriangleOffsets);
+        m_vertexTriangles = std::move(other.m_vertexTriangles);
+        m_boundsMin = other.m_boundsMin;
+        m_boundsMax = other.m_boundsMax;
+        m_boundsCenter = other.m_boundsCenter;
+        m_boundsRadius = other.m_boundsRadius;
+        m_instanceBuffers = std::move(other.m_instanceBuffers);
         m_VAO = std::move(other.m_VAO);
         m_VBO = std::move(other.m_VBO);
         m_EBO = std::move(other.m_EBO);
         m_isSetup = other.m_isSetup;
+        other.m_trackedCPUBytes = 0;
+        other.m_trackedGPUBytes = 0;
         other.m_isSetup = false;
     }
     return *this;
@@ -55,13 +216,43 @@ Mesh &Mesh::operator=(Mesh &&other) noexcept {
 // ========== Data Management ==========
 
 void Mesh::SetVertices(const std::vector<Vertex> &vertices) {
+    if (!RequireCPUData("Mesh::SetVertices")) {
+        return;
+    }
+
     m_vertices = vertices;
+    ClearLODs();
+    ClearMeshlets();
+    InvalidateAdjacency();
     m_isSetup = false;
     SetupMesh();
 }
 
 void Mesh::SetIndices(const std::vector<uint32_t> &indices) {
+    if (!RequireCPUData("Mesh::SetIndices")) {
+        return;
+    }
+
     m_indices = indices;
+    ClearLODs();
+    ClearMeshlets();
+    InvalidateAdjacency();
+    m_isSetup = false;
+    SetupMesh();
+}
+
+void Mesh::SetGeometry(std::vector<Vertex> vertices, std::vector<uint32_t> indices) {
+    m_vertices = std::move(vertices);
+    m_indices = std::move(indices);
+    ReleaseVector(m_positions);
+    m_cpuDataReleased = false;
+    if (m_sharedGeometry) {
+        m_sharedGeometry.reset();
+        m_EBO.reset();
+    }
+    ClearLODs();
+    ClearMeshlets();
+    InvalidateAdjacency();
     m_isSetup = false;
     SetupMesh();
 }
@@ -71,73 +262,199 @@ void Mesh::SetMaterial(const Material &material) {
 }
 
 void Mesh::UpdateVertices(const std::vector<Vertex> &vertices) {
+    if (!RequireCPUData("Mesh::UpdateVertices")) {
+        return;
+    }
     if (vertices.size() != m_vertices.size()) {
         SetVertices(vertices);
         return;
     }
 
     m_vertices = vertices;
-
-    if (m_VBO) {
-        m_VBO->Bind();
-        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
-        m_VBO->Unbind();
-    }
+    ComputeBounds();
+    RefreshMeshletBounds();
+    UploadVertexRange(0, vertices.size());
 }
 
 void Mesh::UpdateVertices(const std::vector<Vertex> &vertices, size_t offset) {
+    if (!RequireCPUData("Mesh::UpdateVertices")) {
+        return;
+    }
     if (offset + vertices.size() > m_vertices.size()) {
         return; // Invalid range
     }
 
-    // Update local data
+    // Update local data; the bounds only need a rescan if the old range was on their boundary
+    const auto [previousMin, previousMax] = ComputeRangeBounds(m_vertices.data() + offset, vertices.size());
     std::copy(vertices.begin(), vertices.end(), m_vertices.begin() + offset);
+    UpdateBounds(offset, vertices.size(), previousMin, previousMax);
+    RefreshMeshletBounds();
 
     // Update GPU buffer
-    if (m_VBO) {
-        m_VBO->Bind();
-        glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(Vertex), vertices.size() * sizeof(Vertex), vertices.data());
-        m_VBO->Unbind();
-    }
+    UploadVertexRange(offset, vertices.size());
 }
 
-// ========== Rendering ==========
+void Mesh::SetVertexFormat(VertexFormat format) {
+    if (format == m_vertexFormat || !RequireCPUData("Mesh::SetVertexFormat")) {
+        return;
+    }
 
-void Mesh::Render() {
-    if (!m_isSetup || m_vertices.empty()) {
+    m_vertexFormat = format;
+    m_isSetup = false;
+    SetupMesh();
+}
+
+void Mesh::UploadVertexRange(size_t offset, size_t count) {
+    if (!m_VBO || count == 0) {
         return;
     }
 
-    m_VAO->Bind();
+    if (m_vertexFormat == VertexFormat::CompactQuantized) {
+        // Positions outside the quantization box need a new box, so re-upload everything
+        for (size_t i = offset; i < offset + count; ++i) {
+            const glm::vec3 &position = m_vertices[i].position;
+            if (glm::min(position, m_quantizationMin) != m_quantizationMin ||
+                glm::max(position, m_quantizationMax) != m_quantizationMax) {
+                m_isSetup = false;
+                SetupMesh();
+                return;
+            }
+        }
+    }
 
-    if (HasIndices()) {
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), GL_UNSIGNED_INT, 0);
+    const size_t stride = GetVertexStride();
+    m_VBO->Bind();
+    if (m_vertexFormat == VertexFormat::Standard) {
+        glBufferSubData(GL_ARRAY_BUFFER, offset * stride, count * stride, m_vertices.data() + offset);
     } else {
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size()));
+        std::vector<uint8_t> packed(count * stride);
+        PackVertices(m_vertices.data() + offset, count, m_vertexFormat, m_quantizationMin, m_quantizationMax,
+                     packed.data());
+        glBufferSubData(GL_ARRAY_BUFFER, offset * stride, packed.size(), packed.data());
+    }
+    m_VBO->Unbind();
+}
+
+// ========== Residency ==========
+
+void Mesh::SetResidency(MeshResidency residency) {
+    m_residency = residency;
+    ApplyResidency();
+}
+
+size_t Mesh::GetCPUMemoryUsage() const {
+    const size_t indexCapacity = m_indices.capacity() + m_lodIndices.capacity() +
+                                 m_vertexTriangleOffsets.capacity() + m_vertexTriangles.capacity();
+    return m_vertices.capacity() * sizeof(Vertex) + indexCapacity * sizeof(uint32_t) +
+           m_positions.capacity() * sizeof(glm::vec3) + m_meshlets.capacity() * sizeof(Meshlet);
+}
+
+size_t Mesh::GetGPUMemoryUsage() const {
+    // Shared buffers are counted once, by their owner
+    if (m_sharedGeometry) {
+        return 0;
+    }
+    return (m_VBO ? m_VBO->GetSize() : 0) + (m_EBO ? m_EBO->GetSize() : 0);
+}
+
+void Mesh::ApplyResidency() {
+    bool released = false;
+    if (m_isSetup && m_residency != MeshResidency::KeepAll) {
+        // Count what was just uploaded before dropping it, so the release is visible in the stats
+        TrackMemory();
+        if (m_residency == MeshResidency::PositionsOnly && !m_cpuDataReleased) {
+            m_positions.resize(m_vertices.size());
+            for (size_t i = 0; i < m_vertices.size(); ++i) {
+                m_positions[i] = m_vertices[i].position;
+            }
+        } else if (m_residency == MeshResidency::GpuOnly) {
+            ReleaseVector(m_positions);
+            ReleaseVector(m_indices);
+        }
+        ReleaseVector(m_vertices);
+        ReleaseVector(m_lodIndices);
+        ReleaseVector(m_vertexTriangleOffsets);
+        ReleaseVector(m_vertexTriangles);
+        m_cpuDataReleased = true;
+        released = true;
+    }
+    TrackMemory(released);
+}
+
+void Mesh::TrackMemory(bool released) {
+    ReportMemory(MemoryCategory::MeshCPU, m_trackedCPUBytes, GetCPUMemoryUsage(), released);
+    ReportMemory(MemoryCategory::MeshGPU, m_trackedGPUBytes, GetGPUMemoryUsage(), false);
+}
+
+// ========== Shared Geometry ==========
+
+Mesh Mesh::CreateShared(std::shared_ptr<const Mesh> geometry) {
+    Mesh mesh;
+    if (!geometry || !geometry->m_isSetup) {
+        return mesh;
+    }
+
+    mesh.m_material = geometry->m_material;
+    mesh.m_vertexCount = geometry->m_vertexCount;
+    mesh.m_indexCount = geometry->m_indexCount;
+    mesh.m_cpuDataReleased = true;
+    mesh.m_vertexFormat = geometry->m_vertexFormat;
+    mesh.m_quantizationMin = geometry->m_quantizationMin;
+    mesh.m_quantizationMax = geometry->m_quantizationMax;
+    mesh.m_lods = geometry->m_lods;
+    mesh.m_meshlets = geometry->m_meshlets;
+    mesh.m_boundsMin = geometry->m_boundsMin;
+    mesh.m_boundsMax = geometry->m_boundsMax;
+    mesh.m_boundsCenter = geometry->m_boundsCenter;
+    mesh.m_boundsRadius = geometry->m_boundsRadius;
+
+    mesh.m_VBO = geometry->m_VBO;
+    mesh.m_EBO = geometry->m_EBO;
+    mesh.CreateVertexArray();
+    if (mesh.m_EBO && geometry->m_indexCount > 0) {
+        mesh.m_VAO->SetIndexBuffer(mesh.m_EBO);
+    }
+    mesh.m_VAO->Unbind();
+
+    mesh.m_sharedGeometry = std::move(geometry);
+    mesh.m_isSetup = true;
+    return mesh;
+}
+
+bool Mesh::RequireCPUData(const char *operation) const {
+    if (m_cpuDataReleased) {
+        std::cerr << operation << " needs the CPU vertices, which this mesh does not keep" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ========== Rendering ==========
+
+void Mesh::Render() {
+    if (!m_isSetup || m_vertexCount == 0) {
+        return;
     }
 
+    m_VAO->Bind();
+    DrawElements(1);
     m_VAO->Unbind();
 }
 
 void Mesh::Render(ShaderProgram &shader) {
-    if (!m_isSetup || m_vertices.empty()) {
+    if (!m_isSetup || m_vertexCount == 0) {
         return;
     }
 
     shader.Use();
-    BindMaterialTextures(shader);
-
-    // Set material properties
-    shader.SetUniform("material.ambient", m_material.ambient);
-    shader.SetUniform("material.diffuse", m_material.diffuse);
-    shader.SetUniform("material.specular", m_material.specular);
-    shader.SetUniform("material.shininess", m_material.shininess);
+    SetVertexDecodeUniforms(shader);
+    ApplyMaterial(shader, m_material);
 
     Render();
 }
 
 void Mesh::Render(ShaderProgram &shader, const glm::mat4 &modelMatrix) {
-    if (!m_isSetup || m_vertices.empty()) {
+    if (!m_isSetup || m_vertexCount == 0) {
         return;
     }
 
@@ -148,178 +465,482 @@ void Mesh::Render(ShaderProgram &shader, const glm::mat4 &modelMatrix) {
     glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
     shader.SetUniform("normalMatrix", normalMatrix);
 
-    BindMaterialTextures(shader);
-
-    // Set material properties
-    shader.SetUniform("material.ambient", m_material.ambient);
-    shader.SetUniform("material.diffuse", m_material.diffuse);
-    shader.SetUniform("material.specular", m_material.specular);
-    shader.SetUniform("material.shininess", m_material.shininess);
+    SetVertexDecodeUniforms(shader);
+    ApplyMaterial(shader, m_material);
 
     Render();
 }
 
-// ========== Utility Functions ==========
+void Mesh::RenderInstanced(ShaderProgram &shader, uint32_t instanceCount) {
+    if (!m_isSetup || m_vertexCount == 0 || instanceCount == 0) {
+        return;
+    }
 
-void Mesh::CalculateNormals() {
-    if (m_vertices.empty())
+    shader.Use();
+    SetVertexDecodeUniforms(shader);
+    ApplyMaterial(shader, m_material);
+
+    m_VAO->Bind();
+    DrawElements(instanceCount);
+    m_VAO->Unbind();
+}
+
+void Mesh::AddInstanceBuffer(std::shared_ptr<VertexBuffer> buffer, const VertexBufferLayout &layout) {
+    m_instanceBuffers.push_back({buffer, layout});
+    if (!m_isSetup) {
+        return;
+    }
+
+    m_VAO->AddInstanceBuffer(std::move(buffer), layout);
+    m_VAO->Unbind();
+}
+
+void Mesh::DrawElements(uint32_t instanceCount) {
+    if (!HasIndices()) {
+        if (instanceCount == 1) {
+            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertexCount));
+        } else {
+            glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertexCount),
+                                  static_cast<GLsizei>(instanceCount));
+        }
         return;
+    }
 
-    // Reset all normals
-    for (auto &vertex : m_vertices) {
-        vertex.normal = glm::vec3(0.0f);
+    const MeshLOD lod = GetLOD(m_activeLOD);
+    const void *offset = reinterpret_cast<const void *>(static_cast<uintptr_t>(lod.firstIndex) * sizeof(uint32_t));
+    if (instanceCount == 1) {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(lod.indexCount), GL_UNSIGNED_INT, offset);
+    } else {
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(lod.indexCount), GL_UNSIGNED_INT, offset,
+                                static_cast<GLsizei>(instanceCount));
     }
+}
 
-    // Calculate normals based on triangles
-    if (HasIndices()) {
-        // Use indices
-        for (size_t i = 0; i < m_indices.size(); i += 3) {
-            if (i + 2 < m_indices.size()) {
-                uint32_t i0 = m_indices[i];
-                uint32_t i1 = m_indices[i + 1];
-                uint32_t i2 = m_indices[i + 2];
+// ========== Levels of Detail ==========
 
-                if (i0 < m_vertices.size() && i1 < m_vertices.size() && i2 < m_vertices.size()) {
-                    glm::vec3 v0 = m_vertices[i0].position;
-                    glm::vec3 v1 = m_vertices[i1].position;
-                    glm::vec3 v2 = m_vertices[i2].position;
+size_t Mesh::GenerateLODs(const std::vector<float> &triangleRatios) {
+    if (!RequireCPUData("Mesh::GenerateLODs")) {
+        return GetLODCount();
+    }
 
-                    glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+    ClearLODs();
+    if (m_indices.size() < 3) {
+        return GetLODCount();
+    }
 
-                    m_vertices[i0].normal += normal;
-                    m_vertices[i1].normal += normal;
-                    m_vertices[i2].normal += normal;
-                }
-            }
+    std::vector<uint32_t> previous = m_indices;
+    std::vector<uint32_t> simplified;
+    float error = 0.0f;
+    auto [boundsMin, boundsMax] = GetBoundingBox();
+    const glm::vec3 extent = boundsMax - boundsMin;
+    const float largestExtent = std::max(std::max(extent.x, extent.y), extent.z);
+
+    for (float ratio : triangleRatios) {
+        const size_t targetIndexCount = static_cast<size_t>(m_indices.size() / 3 * std::max(ratio, 0.0f)) * 3;
+        if (targetIndexCount >= previous.size()) {
+            continue;
         }
-    } else {
-        // Use vertex order
-        for (size_t i = 0; i < m_vertices.size(); i += 3) {
-            if (i + 2 < m_vertices.size()) {
-                glm::vec3 v0 = m_vertices[i].position;
-                glm::vec3 v1 = m_vertices[i + 1].position;
-                glm::vec3 v2 = m_vertices[i + 2].position;
-
-                glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
-
-                m_vertices[i].normal += normal;
-                m_vertices[i + 1].normal += normal;
-                m_vertices[i + 2].normal += normal;
-            }
+
+        const float levelError = MeshSimplifier::Simplify(m_vertices, previous, targetIndexCount,
+                                                          std::numeric_limits<float>::max(), simplified);
+
+        // Locked geometry stops shrinking; a level that saves little is not worth a draw range
+        if (simplified.empty() || simplified.size() * 10 > previous.size() * 9) {
+            break;
         }
+
+        MeshOptimizer::OptimizeVertexCache(simplified, m_vertices.size());
+
+        // Each level is measured against the previous one, so the deviation from the full mesh is bounded by the sum
+        error += levelError * largestExtent;
+        MeshLOD lod;
+        lod.firstIndex = static_cast<uint32_t>(m_indices.size() + m_lodIndices.size());
+        lod.indexCount = static_cast<uint32_t>(simplified.size());
+        lod.error = error;
+        m_lods.push_back(lod);
+
+        m_lodIndices.insert(m_lodIndices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+
+    if (m_isSetup) {
+        UploadIndices();
+        m_VAO->Unbind();
+    }
+    TrackMemory();
+    return GetLODCount();
+}
+
+void Mesh::ClearLODs() {
+    const bool hadLODs = !m_lods.empty();
+    m_lodIndices.clear();
+    m_lods.clear();
+    m_activeLOD = 0;
+    if (hadLODs && m_isSetup) {
+        UploadIndices();
+        m_VAO->Unbind();
+        TrackMemory();
+    }
+}
+
+MeshLOD Mesh::GetLOD(size_t level) const {
+    if (level == 0 || level > m_lods.size()) {
+        MeshLOD lod;
+        lod.indexCount = static_cast<uint32_t>(m_indexCount);
+        return lod;
+    }
+    return m_lods[level - 1];
+}
+
+void Mesh::SetActiveLOD(size_t level) {
+    m_activeLOD = std::min(level, m_lods.size());
+}
+
+float Mesh::GetProjectedSize(const glm::mat4 &modelMatrix, const glm::mat4 &view, const glm::mat4 &projection,
+                             float viewportHeight) const {
+    const glm::vec3 center = glm::vec3(view * modelMatrix * glm::vec4(m_boundsCenter, 1.0f));
+    const float scale = std::max(std::max(glm::length(glm::vec3(modelMatrix[0])),
+                                          glm::length(glm::vec3(modelMatrix[1]))),
+                                 glm::length(glm::vec3(modelMatrix[2])));
+    const float radius = m_boundsRadius * scale;
+
+    // projection[1][1] is cot(fovY / 2) for perspective and 2 / height for orthographic projections
+    if (projection[3][3] == 1.0f) {
+        return radius * projection[1][1] * viewportHeight;
+    }
+    const float distance = -center.z;
+    if (distance <= radius) {
+        return std::numeric_limits<float>::max();
+    }
+    return radius * projection[1][1] / distance * viewportHeight;
+}
+
+size_t Mesh::SelectLOD(float projectedSize, size_t currentLOD, float pixelError, float hysteresis) const {
+    if (m_lods.empty() || m_boundsRadius <= 0.0f) {
+        return 0;
+    }
+
+    // Object space error to pixels
+    const float pixelsPerUnit = projectedSize / (2.0f * m_boundsRadius);
+    auto errorInPixels = [&](size_t level) { return GetLOD(level).error * pixelsPerUnit; };
+
+    size_t level = std::min(currentLOD, m_lods.size());
+    while (level > 0 && errorInPixels(level) > pixelError) {
+        --level;
     }
+    while (level < m_lods.size() && errorInPixels(level + 1) <= pixelError * (1.0f - hysteresis)) {
+        ++level;
+    }
+    return level;
+}
+
+size_t Mesh::SelectLOD(const Camera &camera, const glm::mat4 &modelMatrix, float viewportHeight, size_t currentLOD,
+                       float pixelError) const {
+    const float projectedSize =
+        GetProjectedSize(modelMatrix, camera.GetViewMatrix(), camera.GetProjectionMatrix(), viewportHeight);
+    return SelectLOD(projectedSize, currentLOD, pixelError);
+}
+
+// ========== Meshlets ==========
+
+size_t Mesh::GenerateMeshlets(uint32_t maxTriangles, float coneWeight) {
+    if (!RequireCPUData("Mesh::GenerateMeshlets")) {
+        return m_meshlets.size();
+    }
+
+    m_meshlets.clear();
+    if (m_indices.size() >= 3) {
+        m_meshlets = MeshletBuilder::Build(m_vertices, m_indices, maxTriangles, coneWeight);
+        m_indexCount = m_indices.size();
 
-    // Normalize all normals
-    for (auto &vertex : m_vertices) {
-        if (glm::length(vertex.normal) > 0.0f) {
-            vertex.normal = glm::normalize(vertex.normal);
+        // Triangle numbers changed with the order
+        InvalidateAdjacency();
+        if (m_isSetup) {
+            UploadIndices();
+            m_VAO->Unbind();
         }
     }
+    m_meshlets.shrink_to_fit();
+    TrackMemory();
+    return m_meshlets.size();
+}
 
-    // Update GPU buffer if already set up
-    if (m_isSetup) {
-        UpdateVertices(m_vertices);
+void Mesh::ClearMeshlets() {
+    if (m_meshlets.empty()) {
+        return;
     }
+    ReleaseVector(m_meshlets);
+    TrackMemory();
 }
 
-void Mesh::CalculateTangents() {
-    if (m_vertices.empty())
+void Mesh::RefreshMeshletBounds() {
+    if (m_meshlets.empty()) {
+        return;
+    }
+    ThreadPool::Shared().ParallelFor(m_meshlets.size(), MeshletChunkSize, [this](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            MeshletBuilder::ComputeBounds(m_vertices, m_indices, m_meshlets[i]);
+        }
+    });
+}
+
+void Mesh::RenderCulled(ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat4 &viewProjection,
+                        const glm::vec3 &cameraPosition, bool cullBackFaces) {
+    if (!m_isSetup || m_vertexCount == 0) {
+        return;
+    }
+    if (m_meshlets.empty() || m_activeLOD != 0) {
+        m_meshletStats = MeshletCullStats{};
+        m_meshletStats.ranges = 1;
+        Render(shader, modelMatrix);
         return;
+    }
 
-    // Reset tangents and bitangents
-    for (auto &vertex : m_vertices) {
-        vertex.tangent = glm::vec3(0.0f);
-        vertex.bitangent = glm::vec3(0.0f);
+    // Test in object space, so the clusters' bounds are used as they are
+    const Frustum frustum = Frustum::FromMatrix(viewProjection * modelMatrix);
+    const glm::vec3 eye = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(cameraPosition, 1.0f));
+
+    // Mirroring flips the winding, so what faces away in object space is drawn as front facing
+    const bool mirrored = glm::determinant(glm::mat3(modelMatrix)) < 0.0f;
+    m_meshletStats = MeshletBuilder::Cull(m_meshlets, frustum, eye, cullBackFaces && !mirrored, m_visibleMeshlets);
+    if (m_visibleMeshlets.empty()) {
+        return;
     }
 
-    auto calculateTriangleTangents = [&](uint32_t i0, uint32_t i1, uint32_t i2) {
-        if (i0 >= m_vertices.size() || i1 >= m_vertices.size() || i2 >= m_vertices.size()) {
-            return;
+    // Clusters are contiguous in the index buffer, so visible neighbours join into one range
+    m_drawCounts.clear();
+    m_drawOffsets.clear();
+    uint32_t rangeEnd = 0;
+    for (uint32_t i : m_visibleMeshlets) {
+        const Meshlet &meshlet = m_meshlets[i];
+        if (!m_drawCounts.empty() && rangeEnd == meshlet.firstIndex) {
+            m_drawCounts.back() += static_cast<GLsizei>(meshlet.indexCount);
+        } else {
+            m_drawCounts.push_back(static_cast<GLsizei>(meshlet.indexCount));
+            m_drawOffsets.push_back(
+                reinterpret_cast<const void *>(static_cast<uintptr_t>(meshlet.firstIndex) * sizeof(uint32_t)));
         }
+        rangeEnd = meshlet.firstIndex + meshlet.indexCount;
+    }
+    m_meshletStats.ranges = static_cast<uint32_t>(m_drawCounts.size());
 
-        glm::vec3 pos1 = m_vertices[i0].position;
-        glm::vec3 pos2 = m_vertices[i1].position;
-        glm::vec3 pos3 = m_vertices[i2].position;
+    shader.Use();
+    shader.SetUniform("model", modelMatrix);
+    shader.SetUniform("normalMatrix", glm::transpose(glm::inverse(glm::mat3(modelMatrix))));
+    SetVertexDecodeUniforms(shader);
+    ApplyMaterial(shader, m_material);
+
+    m_VAO->Bind();
+    glMultiDrawElements(GL_TRIANGLES, m_drawCounts.data(), GL_UNSIGNED_INT, m_drawOffsets.data(),
+                        static_cast<GLsizei>(m_drawCounts.size()));
+    m_VAO->Unbind();
+}
 
-        glm::vec2 uv1 = m_vertices[i0].texCoords;
-        glm::vec2 uv2 = m_vertices[i1].texCoords;
-        glm::vec2 uv3 = m_vertices[i2].texCoords;
+void Mesh::RenderCulled(ShaderProgram &shader, const glm::mat4 &modelMatrix, const Camera &camera) {
+    RenderCulled(shader, modelMatrix, camera.GetViewProjectionMatrix(), camera.Position,
+                 camera.Type == CameraType::Perspective);
+}
 
-        glm::vec3 edge1 = pos2 - pos1;
-        glm::vec3 edge2 = pos3 - pos1;
-        glm::vec2 deltaUV1 = uv2 - uv1;
-        glm::vec2 deltaUV2 = uv3 - uv1;
+// ========== Utility Functions ==========
 
-        float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
+namespace {
 
-        glm::vec3 tangent{f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x),
-                          f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y),
-                          f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z)};
+// Work items for ThreadPool::ParallelFor; both passes are a few nanoseconds per element
+constexpr size_t TriangleChunkSize = 4096;
+constexpr size_t VertexChunkSize = 4096;
 
-        glm::vec3 bitangent{f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x),
-                            f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y),
-                            f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z)};
+static_assert(sizeof(Vertex) % sizeof(float) == 0, "Vertex is read as a strided float array");
 
-        m_vertices[i0].tangent += tangent;
-        m_vertices[i1].tangent += tangent;
-        m_vertices[i2].tangent += tangent;
+kernels::MeshTriangleView MakeTriangleView(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) {
+    kernels::MeshTriangleView view;
+    view.positions = &vertices[0].position.x;
+    view.texCoords = &vertices[0].texCoords.x;
+    view.stride = sizeof(Vertex) / sizeof(float);
+    view.indices = indices.empty() ? nullptr : indices.data();
+    view.vertexCount = vertices.size();
+    return view;
+}
 
-        m_vertices[i0].bitangent += bitangent;
-        m_vertices[i1].bitangent += bitangent;
-        m_vertices[i2].bitangent += bitangent;
+// Counting sort of triangle corners by vertex; filling in triangle order keeps every row ascending.
+// Triangles with an out-of-range index are left out, as they contribute nothing.
+void BuildAdjacency(size_t vertexCount, const std::vector<uint32_t> &indices, std::vector<uint32_t> &offsets,
+                    std::vector<uint32_t> &triangles) {
+    const size_t triangleCount = indices.size() / 3;
+    auto isValid = [&](size_t triangle) {
+        return indices[triangle * 3] < vertexCount && indices[triangle * 3 + 1] < vertexCount &&
+               indices[triangle * 3 + 2] < vertexCount;
     };
 
-    // Calculate tangents for each triangle
-    if (HasIndices()) {
-        for (size_t i = 0; i < m_indices.size(); i += 3) {
-            if (i + 2 < m_indices.size()) {
-                calculateTriangleTangents(m_indices[i], m_indices[i + 1], m_indices[i + 2]);
+    offsets.assign(vertexCount + 1, 0);
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+        if (isValid(triangle)) {
+            for (size_t corner = 0; corner < 3; ++corner) {
+                ++offsets[indices[triangle * 3 + corner] + 1];
             }
         }
-    } else {
-        for (size_t i = 0; i < m_vertices.size(); i += 3) {
-            if (i + 2 < m_vertices.size()) {
-                calculateTriangleTangents(static_cast<uint32_t>(i), static_cast<uint32_t>(i + 1),
-                                          static_cast<uint32_t>(i + 2));
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    triangles.resize(offsets[vertexCount]);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+        if (isValid(triangle)) {
+            for (size_t corner = 0; corner < 3; ++corner) {
+                triangles[cursor[indices[triangle * 3 + corner]]++] = static_cast<uint32_t>(triangle);
             }
         }
     }
+}
 
-    // Normalize tangents and bitangents
-    for (auto &vertex : m_vertices) {
-        if (glm::length(vertex.tangent) > 0.0f) {
-            vertex.tangent = glm::normalize(vertex.tangent);
+// Tangent and bitangent of every triangle, then the sums around every vertex.
+// offsets is empty for non-indexed vertices, where every vertex has one triangle.
+void ComputeTangents(std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
+                     const std::vector<uint32_t> &offsets, const std::vector<uint32_t> &triangles) {
+    const kernels::MeshTriangleView view = MakeTriangleView(vertices, indices);
+    const size_t triangleCount = (indices.empty() ? vertices.size() : indices.size()) / 3;
+    const size_t vertexCount = vertices.size();
+    const kernels::VertexTriangleAdjacency adjacency{indices.empty() ? nullptr : offsets.data(), triangles.data(),
+                                                     triangleCount};
+
+    std::vector<float> triangleVectors(triangleCount * 6);
+    float *t[6];
+    for (int i = 0; i < 6; ++i) {
+        t[i] = triangleVectors.data() + i * triangleCount;
+    }
+    ThreadPool &pool = ThreadPool::Shared();
+    pool.ParallelFor(triangleCount, TriangleChunkSize, [&](size_t, size_t begin, size_t end) {
+        kernels::ComputeTriangleTangents(view, begin, end, t[0], t[1], t[2], t[3], t[4], t[5]);
+    });
+
+    std::vector<float> vertexVectors(vertexCount * 6);
+    float *v[6];
+    for (int i = 0; i < 6; ++i) {
+        v[i] = vertexVectors.data() + i * vertexCount;
+    }
+    pool.ParallelFor(vertexCount, VertexChunkSize, [&](size_t, size_t begin, size_t end) {
+        kernels::GatherVertexVectors(adjacency, t[0], t[1], t[2], begin, end, v[0], v[1], v[2]);
+        kernels::GatherVertexVectors(adjacency, t[3], t[4], t[5], begin, end, v[3], v[4], v[5]);
+        kernels::NormalizeVectors(v[0], v[1], v[2], begin, end);
+        kernels::NormalizeVectors(v[3], v[4], v[5], begin, end);
+        for (size_t i = begin; i < end; ++i) {
+            vertices[i].tangent = glm::vec3(v[0][i], v[1][i], v[2][i]);
+            vertices[i].bitangent = glm::vec3(v[3][i], v[4][i], v[5][i]);
         }
-        if (glm::length(vertex.bitangent) > 0.0f) {
-            vertex.bitangent = glm::normalize(vertex.bitangent);
+    });
+}
+
+} // namespace
+
+void Mesh::CalculateNormals() {
+    if (!RequireCPUData("Mesh::CalculateNormals") || m_vertices.empty())
+        return;
+
+    BuildVertexTriangleAdjacency();
+    const kernels::MeshTriangleView view = MakeTriangleView(m_vertices, m_indices);
+    const size_t triangleCount = (HasIndices() ? m_indices.size() : m_vertices.size()) / 3;
+    const size_t vertexCount = m_vertices.size();
+    const kernels::VertexTriangleAdjacency adjacency{
+        HasIndices() ? m_vertexTriangleOffsets.data() : nullptr, m_vertexTriangles.data(), triangleCount};
+
+    // Unit normal of every triangle, then the sum around every vertex
+    std::vector<float> triangleNormals(triangleCount * 3);
+    float *tx = triangleNormals.data();
+    float *ty = tx + triangleCount;
+    float *tz = ty + triangleCount;
+    ThreadPool &pool = ThreadPool::Shared();
+    pool.ParallelFor(triangleCount, TriangleChunkSize, [&](size_t, size_t begin, size_t end) {
+        kernels::ComputeTriangleNormals(view, begin, end, tx, ty, tz);
+    });
+
+    std::vector<float> vertexNormals(vertexCount * 3);
+    float *nx = vertexNormals.data();
+    float *ny = nx + vertexCount;
+    float *nz = ny + vertexCount;
+    pool.ParallelFor(vertexCount, VertexChunkSize, [&](size_t, size_t begin, size_t end) {
+        kernels::GatherVertexVectors(adjacency, tx, ty, tz, begin, end, nx, ny, nz);
+        kernels::NormalizeVectors(nx, ny, nz, begin, end);
+        for (size_t v = begin; v < end; ++v) {
+            m_vertices[v].normal = glm::vec3(nx[v], ny[v], nz[v]);
         }
-    }
+    });
 
-    // Update GPU buffer if already set up
+    // Update GPU buffer if already set up; the adjacency is new memory the first time
     if (m_isSetup) {
-        UpdateVertices(m_vertices);
+        UploadVertexRange(0, vertexCount);
     }
+    TrackMemory();
 }
 
-std::pair<glm::vec3, glm::vec3> Mesh::GetBoundingBox() const {
-    if (m_vertices.empty()) {
-        return {glm::vec3(0.0f), glm::vec3(0.0f)};
+void Mesh::CalculateTangents() {
+    if (!RequireCPUData("Mesh::CalculateTangents") || m_vertices.empty())
+        return;
+
+    BuildVertexTriangleAdjacency();
+    ComputeTangents(m_vertices, m_indices, m_vertexTriangleOffsets, m_vertexTriangles);
+
+    // Update GPU buffer if already set up; the adjacency is new memory the first time
+    if (m_isSetup) {
+        UploadVertexRange(0, m_vertices.size());
     }
+    TrackMemory();
+}
+
+void Mesh::CalculateTangents(std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) {
+    if (vertices.empty())
+        return;
 
-    glm::vec3 min = m_vertices[0].position;
-    glm::vec3 max = m_vertices[0].position;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+    if (!indices.empty()) {
+        BuildAdjacency(vertices.size(), indices, offsets, triangles);
+    }
+    ComputeTangents(vertices, indices, offsets, triangles);
+}
 
-    for (const auto &vertex : m_vertices) {
-        min = glm::min(min, vertex.position);
-        max = glm::max(max, vertex.position);
+void Mesh::BuildVertexTriangleAdjacency() {
+    if (!HasIndices() || m_vertexTriangleOffsets.size() == m_vertices.size() + 1) {
+        return;
     }
+    BuildAdjacency(m_vertices.size(), m_indices, m_vertexTriangleOffsets, m_vertexTriangles);
+}
 
-    return {min, max};
+void Mesh::InvalidateAdjacency() {
+    m_vertexTriangleOffsets.clear();
+    m_vertexTriangles.clear();
+}
+
+void Mesh::ComputeBounds() {
+    std::tie(m_boundsMin, m_boundsMax) = ComputeRangeBounds(m_vertices.data(), m_vertices.size());
+    ComputeBoundingSphere(m_vertices.data(), m_vertices.size(), m_boundsCenter, m_boundsRadius);
 }
 
-glm::vec3 Mesh::GetCenter() const {
-    auto [min, max] = GetBoundingBox();
-    return (min + max) * 0.5f;
+void Mesh::UpdateBounds(size_t offset, size_t count, const glm::vec3 &previousMin, const glm::vec3 &previousMax) {
+    if (count == 0) {
+        return;
+    }
+
+    // A face of the box can only move inward if the range held a vertex on it and no longer reaches it
+    const auto [rangeMin, rangeMax] = ComputeRangeBounds(m_vertices.data() + offset, count);
+    for (int axis = 0; axis < 3; ++axis) {
+        if ((previousMin[axis] <= m_boundsMin[axis] && rangeMin[axis] > m_boundsMin[axis]) ||
+            (previousMax[axis] >= m_boundsMax[axis] && rangeMax[axis] < m_boundsMax[axis])) {
+            ComputeBounds();
+            return;
+        }
+    }
+
+    // Otherwise the box only grows, and the sphere grows to take in any vertex that left it
+    m_boundsMin = glm::min(m_boundsMin, rangeMin);
+    m_boundsMax = glm::max(m_boundsMax, rangeMax);
+    const float radius = m_boundsRadius;
+    for (size_t i = offset; i < offset + count; ++i) {
+        GrowSphere(m_boundsCenter, m_boundsRadius, m_vertices[i].position);
+    }
+    if (m_boundsRadius != radius) {
+        m_boundsRadius *= 1.0f + 4.0f * std::numeric_limits<float>::epsilon();
+    }
 }
 
 // ========== Static Primitive Creation ==========
@@ -834,39 +1455,122 @@ Mesh Mesh::CreateProjectile(ProjectileType type, float scale) {
 // ========== Private Methods ==========
 
 void Mesh::SetupMesh() {
+    m_vertexCount = m_vertices.size();
+    m_indexCount = m_indices.size();
+    ComputeBounds();
     if (m_vertices.empty()) {
+        TrackMemory();
+        return;
+    }
+
+    if (m_vertexFormat == VertexFormat::Standard) {
+        UploadGeometry(m_vertices.data(), nullptr);
         return;
     }
 
-    // Create vertex buffer
-    m_VBO = std::make_shared<VertexBuffer>(m_vertices.data(), m_vertices.size() * sizeof(Vertex));
+    m_quantizationMin = m_boundsMin;
+    m_quantizationMax = m_boundsMax;
+    std::vector<uint8_t> packed(m_vertices.size() * GetVertexStride());
+    PackVertices(m_vertices.data(), m_vertices.size(), m_vertexFormat, m_quantizationMin, m_quantizationMax,
+                 packed.data());
+    UploadGeometry(packed.data(), nullptr);
+}
+
+void Mesh::UploadGeometry(const void *gpuVertices, const uint32_t *gpuIndices, size_t gpuIndexCount) {
+    m_VBO = std::make_shared<VertexBuffer>(gpuVertices, m_vertexCount * GetVertexStride());
+    CreateVertexArray();
+
+    // Create index buffer if we have indices
+    UploadIndices(gpuIndices, gpuIndexCount);
+
+    m_isSetup = true;
+    ApplyResidency();
+}
+
+void Mesh::CreateVertexArray() {
+    // Attribute locations are handed out in order, so a re-setup needs a fresh VAO
+    if (!m_VAO || !m_VAO->GetVertexBuffers().empty()) {
+        m_VAO = std::make_unique<VertexArray>();
+    }
 
-    // Create vertex buffer layout
+    // Layout of the mesh's vertex format
     VertexBufferLayout layout;
-    layout.PushFloat("a_Position", 3);  // position
-    layout.PushFloat("a_Normal", 3);    // normal
-    layout.PushFloat("a_TexCoords", 2); // texCoords
-    layout.PushFloat("a_Tangent", 3);   // tangent
-    layout.PushFloat("a_Bitangent", 3); // bitangent
+    switch (m_vertexFormat) {
+    case VertexFormat::Standard:
+        layout = VertexBufferLayout::StandardMesh();
+        break;
+    case VertexFormat::Compact:
+        layout = VertexBufferLayout::CompactMesh();
+        break;
+    case VertexFormat::CompactQuantized:
+        layout = VertexBufferLayout::CompactQuantizedMesh();
+        break;
+    }
 
     // Add vertex buffer to VAO
     m_VAO->AddVertexBuffer(m_VBO, layout);
 
-    // Create index buffer if we have indices
-    if (!m_indices.empty()) {
+    // Instance attributes take the locations after the new format's attributes
+    for (const InstanceBinding &instance : m_instanceBuffers) {
+        m_VAO->AddInstanceBuffer(instance.buffer, instance.layout);
+    }
+}
+
+void Mesh::UploadIndices(const uint32_t *gpuIndices, size_t gpuIndexCount) {
+    if (gpuIndices != nullptr ? gpuIndexCount == 0 : m_indices.empty()) {
+        return;
+    }
+
+    // Creating the buffer binds it to whichever VAO is current
+    m_VAO->Bind();
+    const size_t count = m_indices.size() + m_lodIndices.size();
+    if (gpuIndices != nullptr) {
+        m_EBO = std::make_shared<IndexBuffer>(gpuIndices, static_cast<uint32_t>(gpuIndexCount));
+    } else if (m_lodIndices.empty()) {
         m_EBO = std::make_shared<IndexBuffer>(m_indices.data(), m_indices.size());
-        m_VAO->SetIndexBuffer(m_EBO);
+    } else {
+        std::vector<uint32_t> combined;
+        combined.reserve(count);
+        combined.insert(combined.end(), m_indices.begin(), m_indices.end());
+        combined.insert(combined.end(), m_lodIndices.begin(), m_lodIndices.end());
+        m_EBO = std::make_shared<IndexBuffer>(combined);
+    }
+    m_VAO->SetIndexBuffer(m_EBO);
+}
+
+void Mesh::SetVertexDecodeUniforms(ShaderProgram &shader) const {
+    // Standard data decodes with the snippet's defaults, so a Standard mesh only touches a decoding shader,
+    // to undo the values a compact mesh drawn with the same shader left behind. Lookups are silent, since
+    // other shaders never declare these uniforms and the linker drops any a decoding shader leaves unused.
+    const bool compact = m_vertexFormat != VertexFormat::Standard;
+    if (!compact && !shader.HasUniform("compactVertex")) {
+        return;
     }
 
-    m_isSetup = true;
+    const bool quantized = m_vertexFormat == VertexFormat::CompactQuantized;
+    if (shader.HasUniform("positionScale")) {
+        shader.SetUniform("positionScale",
+                          quantized ? (m_quantizationMax - m_quantizationMin) / 65535.0f : glm::vec3(1.0f));
+    }
+    if (shader.HasUniform("positionOffset")) {
+        shader.SetUniform("positionOffset", quantized ? m_quantizationMin : glm::vec3(0.0f));
+    }
+    if (shader.HasUniform("compactVertex")) {
+        shader.SetUniform("compactVertex", compact);
+    }
 }
 
-void Mesh::BindMaterialTextures(ShaderProgram &shader) {
+void ApplyMaterial(ShaderProgram &shader, const Material &material) {
+    shader.SetUniform("material.ambient", material.ambient);
+    shader.SetUniform("material.diffuse", material.diffuse);
+    shader.SetUniform("material.specular", material.specular);
+    shader.SetUniform("material.shininess", material.shininess);
+
     int textureUnit = 0;
 
-    if (m_material.diffuseTexture) {
+    if (material.diffuseTexture) {
         glActiveTexture(GL_TEXTURE0 + textureUnit);
-        m_material.diffuseTexture->Bind();
+        material.diffuseTexture->Bind();
         shader.SetUniform("material.diffuseTexture", textureUnit);
         shader.SetUniform("material.hasDiffuseTexture", true);
         textureUnit++;
@@ -874,9 +1578,9 @@ void Mesh::BindMaterialTextures(ShaderProgram &shader) {
         shader.SetUniform("material.hasDiffuseTexture", false);
     }
 
-    if (m_material.specularTexture) {
+    if (material.specularTexture) {
         glActiveTexture(GL_TEXTURE0 + textureUnit);
-        m_material.specularTexture->Bind();
+        material.specularTexture->Bind();
         shader.SetUniform("material.specularTexture", textureUnit);
         shader.SetUniform("material.hasSpecularTexture", true);
         textureUnit++;
@@ -884,9 +1588,9 @@ void Mesh::BindMaterialTextures(ShaderProgram &shader) {
         shader.SetUniform("material.hasSpecularTexture", false);
     }
 
-    if (m_material.normalTexture) {
+    if (material.normalTexture) {
         glActiveTexture(GL_TEXTURE0 + textureUnit);
-        m_material.normalTexture->Bind();
+        material.normalTexture->Bind();
         shader.SetUniform("material.normalTexture", textureUnit);
         shader.SetUniform("material.hasNormalTexture", true);
         textureUnit++;
@@ -0,0 +1,131 @@
+// Benchmark for MeshCache.
+// Compares building a procedural mesh the way startup does today (generate,
+// optimize, simplify LODs, upload) with loading the same mesh from a cache file,
+// both cold (file evicted from the page cache where the OS allows it) and warm.
+// Every timing includes the GPU upload and ends with glFinish.
+
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "window.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int BuildRuns = 3;
+constexpr int ColdRuns = 5;
+constexpr int WarmRuns = 20;
+
+using Clock = std::chrono::steady_clock;
+
+double Milliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+agl::Mesh Build(int segments) {
+    agl::Mesh mesh = agl::Mesh::CreateSphere(1.0f, segments, segments / 2);
+    agl::MeshOptimizer::Optimize(mesh);
+    mesh.GenerateLODs();
+    return mesh;
+}
+
+// Drop the file's pages so the next load reads from disk; returns false where unsupported
+bool EvictFromPageCache(const std::string &path) {
+#if defined(__linux__)
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    const bool evicted = fdatasync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return evicted;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    // Optional arguments: sphere segment count and cache file path
+    const int segments = argc > 1 ? std::atoi(argv[1]) : 512;
+    const std::string path = argc > 2 ? argv[2] : "mesh_cache_benchmark.aglmesh";
+
+    // Uploads need a context, but nothing is shown
+    agl::Window::Initialize();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    agl::Window window;
+    if (!window.Create(64, 64, "MeshCache benchmark")) {
+        std::printf("No OpenGL context available\n");
+        return 1;
+    }
+
+    double buildMs = 0.0;
+    size_t triangles = 0;
+    size_t vertices = 0;
+    size_t lods = 0;
+    for (int run = 0; run < BuildRuns; ++run) {
+        const auto start = Clock::now();
+        agl::Mesh mesh = Build(segments);
+        glFinish();
+        buildMs += Milliseconds(start);
+
+        triangles = mesh.GetTriangleCount();
+        vertices = mesh.GetVertexCount();
+        lods = mesh.GetLODCount();
+        if (run == 0 && !agl::MeshCache::Write(mesh, path)) {
+            return 1;
+        }
+    }
+    buildMs /= BuildRuns;
+
+    agl::MeshCacheFile file;
+    file.Open(path);
+    const double megabytes = static_cast<double>(file.GetFileSize()) / (1024.0 * 1024.0);
+    file.Close();
+
+    double coldMs = 0.0;
+    bool evicted = true;
+    for (int run = 0; run < ColdRuns; ++run) {
+        evicted &= EvictFromPageCache(path);
+        agl::Mesh mesh;
+        const auto start = Clock::now();
+        agl::MeshCache::Load(path, mesh);
+        glFinish();
+        coldMs += Milliseconds(start);
+    }
+    coldMs /= ColdRuns;
+
+    double warmMs = 0.0;
+    for (int run = 0; run < WarmRuns; ++run) {
+        agl::Mesh mesh;
+        const auto start = Clock::now();
+        agl::MeshCache::Load(path, mesh);
+        glFinish();
+        warmMs += Milliseconds(start);
+    }
+    warmMs /= WarmRuns;
+
+    std::printf("Sphere: %zu vertices, %zu triangles, %zu LODs, cache file %.2f MB\n\n", vertices, triangles, lods,
+                megabytes);
+    std::printf("%-28s %10s %10s %10s\n", "path", "ms", "MB/s", "speedup");
+    std::printf("%-28s %10.2f %10s %10s\n", "generate+optimize+LODs", buildMs, "-", "1.0x");
+    std::printf("%-28s %10.2f %10.0f %9.1fx\n", evicted ? "cache, cold" : "cache, cold (not evicted)", coldMs,
+                megabytes / (coldMs / 1000.0), buildMs / coldMs);
+    std::printf("%-28s %10.2f %10.0f %9.1fx\n", "cache, warm", warmMs, megabytes / (warmMs / 1000.0),
+                buildMs / warmMs);
+
+    std::remove(path.c_str());
+    window.Destroy();
+    agl::Window::Terminate();
+    return 0;
+}
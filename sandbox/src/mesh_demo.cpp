@@ -24,6 +24,11 @@ private:
     // Wireframe mode
     bool m_wireframe = false;
 
+    // Level of detail drawn last frame, chosen from the projected size
+    bool m_autoLOD = true;
+    int m_currentLOD = 0;
+    float m_projectedSize = 0.0f;
+
     // Material
     agl::Material m_material;
 
@@ -57,77 +62,8 @@ public:
     }
 
     void CreateShader() {
-        // Basic vertex shader
-        const char *vertexShaderSource = R"(
-            #version 330 core
-            layout (location = 0) in vec3 a_Position;
-            layout (location = 1) in vec3 a_Normal;
-            layout (location = 2) in vec2 a_TexCoords;
-
-            uniform mat4 model;
-            uniform mat4 view;
-            uniform mat4 projection;
-            uniform mat3 normalMatrix;
-
-            out vec3 FragPos;
-            out vec3 Normal;
-            out vec2 TexCoords;
-
-            void main() {
-                FragPos = vec3(model * vec4(a_Position, 1.0));
-                Normal = normalMatrix * a_Normal;
-                TexCoords = a_TexCoords;
-
-                gl_Position = projection * view * vec4(FragPos, 1.0);
-            }
-        )";
-
-        // Basic fragment shader with lighting
-        const char *fragmentShaderSource = R"(
-            #version 330 core
-            out vec4 FragColor;
-
-            in vec3 FragPos;
-            in vec3 Normal;
-            in vec2 TexCoords;
-
-            uniform vec3 lightPos;
-            uniform vec3 lightColor;
-            uniform vec3 viewPos;
-
-            struct Material {
-                vec3 ambient;
-                vec3 diffuse;
-                vec3 specular;
-                float shininess;
-                bool hasDiffuseTexture;
-                sampler2D diffuseTexture;
-            };
-
-            uniform Material material;
-
-            void main() {
-                // Ambient
-                vec3 ambient = lightColor * material.ambient;
-
-                // Diffuse
-                vec3 norm = normalize(Normal);
-                vec3 lightDir = normalize(lightPos - FragPos);
-                float diff = max(dot(norm, lightDir), 0.0);
-                vec3 diffuse = lightColor * (diff * material.diffuse);
-
-                // Specular
-                vec3 viewDir = normalize(viewPos - FragPos);
-                vec3 reflectDir = reflect(-lightDir, norm);
-                float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-                vec3 specular = lightColor * (spec * material.specular);
-
-                vec3 result = ambient + diffuse + specular;
-                FragColor = vec4(result, 1.0);
-            }
-        )";
-
-        m_meshShader = agl::ShaderProgram::CreateFromSources(vertexShaderSource, fragmentShaderSource);
+        // Engine mesh shader: decodes every vertex format, so the format can be switched below
+        m_meshShader = agl::ShaderProgram::CreateMeshShader();
     }
 
     void CreateMeshes() {
@@ -141,8 +77,9 @@ public:
         m_cube = std::make_unique<agl::Mesh>(agl::Mesh::CreateCube());
         m_cube->SetMaterial(m_material);
 
-        m_sphere = std::make_unique<agl::Mesh>(agl::Mesh::CreateSphere(1.0f, 32, 16));
+        m_sphere = std::make_unique<agl::Mesh>(agl::Mesh::CreateSphere(1.0f, 64, 32));
         m_sphere->SetMaterial(m_material);
+        m_sphere->GenerateLODs();
 
         m_plane = std::make_unique<agl::Mesh>(agl::Mesh::CreatePlane(2.0f, 2.0f));
         m_plane->SetMaterial(m_material);
@@ -189,6 +126,13 @@ public:
             if (currentMesh) {
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::rotate(model, (float)glfwGetTime() * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+                const float viewportHeight = static_cast<float>(GetWindow()->GetHeight());
+                m_projectedSize = currentMesh->GetProjectedSize(model, view, projection, viewportHeight);
+                if (m_autoLOD) {
+                    m_currentLOD = static_cast<int>(currentMesh->SelectLOD(m_projectedSize, m_currentLOD));
+                }
+                currentMesh->SetActiveLOD(m_currentLOD);
                 currentMesh->Render(*m_meshShader, model);
             }
         }
@@ -251,6 +195,22 @@ public:
         if (currentMesh) {
             ImGui::Text("Vertices: %zu", currentMesh->GetVertexCount());
             ImGui::Text("Triangles: %zu", currentMesh->GetTriangleCount());
+
+            const char *formatNames[] = {"Standard", "Compact", "Compact quantized"};
+            int format = static_cast<int>(currentMesh->GetVertexFormat());
+            if (ImGui::Combo("Vertex format", &format, formatNames, 3)) {
+                currentMesh->SetVertexFormat(static_cast<agl::VertexFormat>(format));
+            }
+            ImGui::Text("Vertex stride: %zu bytes", currentMesh->GetVertexStride());
+
+            const int lodCount = static_cast<int>(currentMesh->GetLODCount());
+            if (lodCount > 1) {
+                const agl::MeshLOD lod = currentMesh->GetLOD(m_currentLOD);
+                ImGui::Checkbox("Automatic LOD", &m_autoLOD);
+                ImGui::SliderInt("LOD", &m_currentLOD, 0, lodCount - 1);
+                ImGui::Text("LOD triangles: %u (error %.4f)", lod.indexCount / 3, lod.error);
+                ImGui::Text("Projected size: %.0f px", m_projectedSize);
+            }
         }
 
         ImGui::Separator();
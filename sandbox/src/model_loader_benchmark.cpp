@@ -0,0 +1,97 @@
+// Headless benchmark for ModelLoader.
+// Writes a textured, displaced grid as an OBJ file (two materials, quads with
+// position/texcoord/normal indices, the way DCC exporters write them) and
+// reports parse throughput in MB/s for thread pools of increasing size.
+// Parsing creates no GL objects, so no window is needed.
+
+#include "ModelLoader.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+constexpr int Runs = 3;
+
+bool WriteGrid(const std::string &path, int size) {
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "# ModelLoader benchmark grid\no grid\n");
+    for (int z = 0; z <= size; ++z) {
+        for (int x = 0; x <= size; ++x) {
+            const float u = static_cast<float>(x) / size;
+            const float v = static_cast<float>(z) / size;
+            const float height = 0.05f * std::sin(u * 40.0f) * std::cos(v * 40.0f);
+            std::fprintf(file, "v %.6f %.6f %.6f\n", u * 2.0f - 1.0f, height, v * 2.0f - 1.0f);
+            std::fprintf(file, "vt %.6f %.6f\n", u, v);
+            std::fprintf(file, "vn %.6f %.6f %.6f\n", 0.0f, 1.0f, height);
+        }
+    }
+    const int stride = size + 1;
+    for (int z = 0; z < size; ++z) {
+        if (z == 0 || z == size / 2) {
+            std::fprintf(file, "usemtl %s\n", z == 0 ? "ground" : "rock");
+        }
+        for (int x = 0; x < size; ++x) {
+            const int a = z * stride + x + 1;
+            const int b = a + 1;
+            const int c = a + stride + 1;
+            const int d = a + stride;
+            std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, d, d, d, c, c, c, b, b, b);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    // Optional arguments: grid size (quads per side) and the OBJ file to write
+    const int size = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const std::string path = argc > 2 ? argv[2] : "model_loader_benchmark.obj";
+
+    if (!WriteGrid(path, size)) {
+        std::printf("Could not write %s\n", path.c_str());
+        return 1;
+    }
+
+    const size_t maxWorkers = agl::ThreadPool::DefaultWorkerCount();
+    std::printf("%-10s %10s %10s %10s %12s %12s\n", "threads", "read ms", "parse ms", "MB/s", "vertices",
+                "triangles");
+
+    double baseline = 0.0;
+    for (size_t workers = 0;; workers = std::max<size_t>(1, workers * 2)) {
+        workers = std::min(workers, maxWorkers);
+        agl::ThreadPool pool(workers);
+
+        agl::ModelLoadStats best;
+        for (int run = 0; run < Runs; ++run) {
+            agl::ModelData data;
+            if (!agl::ModelLoader::Parse(path, data, pool)) {
+                return 1;
+            }
+            if (run == 0 || data.stats.parseMs < best.parseMs) {
+                best = data.stats;
+            }
+        }
+        if (workers == 0) {
+            baseline = best.parseMs;
+        }
+
+        // The calling thread takes part in parsing, so the pool has one thread more than workers
+        std::printf("%-10zu %10.2f %10.2f %10.0f %12zu %12zu  (%.1fx)\n", workers + 1, best.readMs, best.parseMs,
+                    best.GetParseThroughput(), best.vertices, best.triangles, baseline / best.parseMs);
+        if (workers == maxWorkers) {
+            break;
+        }
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Headless benchmark for ParticleSystem.
+// Keeps a steady population of particles alive across many emitters and reports
+// the per-frame cost of the simulation (Update) and of sorting and filling the
+// instance data (BuildDrawBatches) on a single core, for every SIMD path.
+
+#include "ParticleSystem.h"
+#include "Simd.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+constexpr int WarmupFrames = 120;
+constexpr int TimedFrames = 120;
+constexpr float FrameDelta = 1.0f / 60.0f;
+constexpr size_t EmitterCount = 50;
+
+struct FrameTimes {
+    double updateMs;
+    double batchMs;
+    size_t particles;
+    size_t batches;
+};
+
+FrameTimes Run(size_t targetParticles) {
+    agl::ParticleSystem system;
+    system.AddTexture(nullptr); // Stand-ins for fire and smoke pages
+    system.AddTexture(nullptr);
+
+    // Half additive fire, half alpha-blended smoke; steady state is spawnRate * average lifetime
+    const size_t perEmitter = targetParticles / EmitterCount;
+    for (size_t e = 0; e < EmitterCount; ++e) {
+        agl::ParticleEmitterDesc desc;
+        desc.maxParticles = static_cast<uint32_t>(perEmitter * 2);
+        desc.minLifetime = 1.0f;
+        desc.maxLifetime = 3.0f;
+        desc.spawnRate = static_cast<float>(perEmitter) / 2.0f;
+        desc.spreadAngle = 0.6f;
+        desc.minSpeed = 1.0f;
+        desc.maxSpeed = 4.0f;
+        desc.drag = 0.5f;
+        desc.spawnRadius = 0.5f;
+        desc.gravity = glm::vec3(0.0f, e % 2 == 0 ? 2.0f : -1.0f, 0.0f);
+        desc.blendMode = e % 2 == 0 ? agl::ParticleBlendMode::Additive : agl::ParticleBlendMode::Alpha;
+        desc.texture = e % 2 == 0 ? 1 : 2;
+
+        const float x = static_cast<float>(e % 10) * 4.0f - 18.0f;
+        const float z = static_cast<float>(e / 10) * -4.0f;
+        system.CreateEmitter(desc, glm::vec3(x, 0.0f, z));
+    }
+
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 5.0f, 20.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    for (int frame = 0; frame < WarmupFrames; ++frame) {
+        system.Update(FrameDelta);
+    }
+
+    double updateMs = 0.0;
+    double batchMs = 0.0;
+    for (int frame = 0; frame < TimedFrames; ++frame) {
+        const auto start = std::chrono::steady_clock::now();
+        system.Update(FrameDelta);
+        const auto middle = std::chrono::steady_clock::now();
+        system.BuildDrawBatches(view);
+        const auto end = std::chrono::steady_clock::now();
+
+        updateMs += std::chrono::duration<double, std::milli>(middle - start).count();
+        batchMs += std::chrono::duration<double, std::milli>(end - middle).count();
+    }
+
+    return FrameTimes{updateMs / TimedFrames, batchMs / TimedFrames, system.GetTotalParticleCount(),
+                      system.GetDrawBatchCount()};
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    // Optional first argument overrides the target particle count
+    size_t targetParticles = 250000;
+    if (argc > 1) {
+        targetParticles = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    std::printf("ParticleSystem single-core benchmark, %zu emitters, %d timed frames\n\n", EmitterCount, TimedFrames);
+    std::printf("%8s %10s %8s %11s %11s %11s %8s\n", "path", "particles", "batches", "update ms", "batch ms",
+                "total ms", "60 Hz");
+
+    const agl::simd::InstructionSet best = agl::simd::DetectInstructionSet();
+    for (int set = 0; set <= static_cast<int>(best); ++set) {
+        agl::simd::SetInstructionSetLimit(static_cast<agl::simd::InstructionSet>(set));
+        const FrameTimes times = Run(targetParticles);
+        const double total = times.updateMs + times.batchMs;
+        std::printf("%8s %10zu %8zu %11.3f %11.3f %11.3f %8s\n",
+                    agl::simd::GetInstructionSetName(agl::simd::GetInstructionSet()), times.particles, times.batches,
+                    times.updateMs, times.batchMs, total, total < 1000.0 / 60.0 ? "yes" : "NO");
+    }
+
+    return 0;
+}
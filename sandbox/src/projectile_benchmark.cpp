@@ -0,0 +1,113 @@
+// Headless benchmark for ProjectileSystem::Update.
+// Sweeps projectile counts and worker thread counts, reports per-frame update
+// time, speedup over one thread and scaling efficiency, and checks that every
+// thread count leaves the projectiles in the same final order.
+
+#include "ProjectileSystem.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int WarmupFrames = 5;
+constexpr int TimedFrames = 60;
+constexpr float FrameDelta = 1.0f / 60.0f;
+
+void Populate(agl::ProjectileSystem &system, size_t count) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> lifetime(0.2f, 3.0f); // Some expire during the timed frames
+
+    system.ClearAll();
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 position(unit(rng) * 50.0f, unit(rng) * 50.0f, unit(rng) * 50.0f);
+        glm::vec3 direction(unit(rng), unit(rng), unit(rng) + 2.0f);
+        system.FireProjectile(position, direction, static_cast<agl::ProjectileType>(i % agl::ProjectileTypeCount),
+                              20.0f, lifetime(rng));
+    }
+}
+
+struct RunResult {
+    double msPerFrame;
+    std::vector<glm::vec3> finalPositions;
+};
+
+RunResult Run(size_t projectileCount, size_t threadCount) {
+    // The calling thread works too, so N threads means N - 1 pool workers
+    agl::ThreadPool pool(threadCount - 1);
+
+    agl::ProjectileSystem system;
+    system.SetMaxProjectiles(projectileCount);
+    system.SetThreadPool(&pool);
+    system.SetParallelThreshold(threadCount > 1 ? 0 : projectileCount + 1);
+    Populate(system, projectileCount);
+
+    for (int frame = 0; frame < WarmupFrames; ++frame) {
+        system.Update(FrameDelta);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < TimedFrames; ++frame) {
+        system.Update(FrameDelta);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    RunResult result;
+    result.msPerFrame = std::chrono::duration<double, std::milli>(end - start).count() / TimedFrames;
+    result.finalPositions = system.GetProjectiles().positions;
+    return result;
+}
+
+bool SameBits(const std::vector<glm::vec3> &a, const std::vector<glm::vec3> &b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(glm::vec3)) == 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    // Optional first argument overrides the highest thread count to test
+    size_t hardwareThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        hardwareThreads = std::max<size_t>(1, std::strtoul(argv[1], nullptr, 10));
+    }
+    const size_t projectileCounts[] = {50000, 100000, 200000, 400000, 800000};
+
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < hardwareThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(hardwareThreads);
+
+    std::printf("ProjectileSystem::Update benchmark\n");
+    std::printf("SIMD path: %s, max threads: %zu, %d timed frames\n\n",
+                agl::simd::GetInstructionSetName(agl::simd::GetInstructionSet()), hardwareThreads, TimedFrames);
+    std::printf("%12s %8s %12s %10s %11s %14s\n", "projectiles", "threads", "ms/frame", "speedup", "efficiency",
+                "deterministic");
+
+    for (size_t projectileCount : projectileCounts) {
+        RunResult baseline = Run(projectileCount, 1);
+
+        for (size_t threads : threadCounts) {
+            RunResult result = threads == 1 ? baseline : Run(projectileCount, threads);
+            const double speedup = baseline.msPerFrame / result.msPerFrame;
+            const double efficiency = speedup / static_cast<double>(threads);
+            const bool deterministic = SameBits(baseline.finalPositions, result.finalPositions);
+
+            std::printf("%12zu %8zu %12.3f %9.2fx %10.0f%% %14s\n", projectileCount, threads, result.msPerFrame,
+                        speedup, efficiency * 100.0, deterministic ? "yes" : "NO");
+        }
+        std::printf("\n");
+    }
+
+    return 0;
+}
@@ -18,6 +18,7 @@ private:
     float m_autoFireTimer = 0.0f;
     float m_autoFireInterval = 0.5f; // Fire every 0.5 seconds
     bool m_autoFire = false;
+    bool m_instancedRendering = true;
 
     // Current projectile type for firing
     int m_currentProjectileIndex = 0;
@@ -26,6 +27,32 @@ private:
                                                 agl::ProjectileType::Laser, agl::ProjectileType::Plasma,
                                                 agl::ProjectileType::Default};
 
+    // Burst firing
+    int m_burstPatternIndex = 0;
+    const char *m_burstPatternNames[3] = {"Cone", "Ring", "Random"};
+    int m_burstCount = 12;
+    float m_burstSpread = 0.15f;
+
+    // Target collision
+    std::vector<agl::CollisionSphere> m_targets;
+    std::vector<agl::SweptHit> m_hits;
+    std::vector<agl::ProjectileHandle> m_hitHandles;
+    int m_targetHits = 0;
+
+    // Homing missiles
+    std::vector<glm::vec3> m_targetPositions;
+    std::vector<agl::ProjectileHandle> m_burstHandles;
+    float m_missileTurnRate = 2.0f;
+
+    // Tracer and smoke trails behind burst projectiles
+    std::unique_ptr<agl::ProjectileTrails> m_trails;
+    agl::TrailStyle m_tracerStyle;
+    agl::TrailStyle m_smokeStyle;
+
+    // Hit explosions
+    std::unique_ptr<agl::ParticleSystem> m_particleSystem;
+    agl::ParticleEmitterDesc m_explosionDesc;
+
     // Shooter position and direction
     glm::vec3 m_shooterPosition{0.0f, 0.0f, 0.0f};
     glm::vec3 m_shooterDirection{0.0f, 0.0f, -1.0f};
@@ -54,12 +81,75 @@ public:
         m_projectileSystem = std::make_unique<agl::ProjectileSystem>();
         m_projectileSystem->Initialize(1000); // Support up to 1000 projectiles
 
+        // Bullets fly straight and plasma bolts arc under gravity; both are evaluated
+        // in closed form instead of being integrated every frame. Missiles stay
+        // simulated so they can home in on targets.
+        agl::ProjectileMotionModel straight;
+        straight.analytic = true;
+        m_projectileSystem->SetMotionModel(agl::ProjectileType::Bullet, straight);
+
+        agl::ProjectileMotionModel ballistic;
+        ballistic.analytic = true;
+        ballistic.gravity = glm::vec3(0.0f, -4.0f, 0.0f);
+        ballistic.drag = 0.1f;
+        m_projectileSystem->SetMotionModel(agl::ProjectileType::Plasma, ballistic);
+
+        // Lasers hit instantly instead of flying as projectiles
+        agl::ProjectileMotionModel hitscan;
+        hitscan.hitscan = true;
+        m_projectileSystem->SetMotionModel(agl::ProjectileType::Laser, hitscan);
+
         // Create shooter
         m_shooter = std::make_unique<agl::Shooter>(m_projectileSystem.get());
         m_shooter->fireRate = 5.0f; // 5 shots per second
         m_shooter->projectileSpeed = 15.0f;
         m_shooter->projectileLifetime = 10.0f;
 
+        // Bounding spheres of the target grid drawn in RenderTargetGrid
+        for (int x = -3; x <= 3; x += 2) {
+            for (int y = -3; y <= 3; y += 2) {
+                m_targets.emplace_back(glm::vec3(x * 2.0f, y * 2.0f, -20.0f), 0.87f);
+                m_targetPositions.push_back(m_targets.back().center);
+            }
+        }
+        m_projectileSystem->GetHitscanScene().Build(m_targets, {}, {});
+
+        m_trails = std::make_unique<agl::ProjectileTrails>(m_projectileSystem.get(), 512, 32);
+        m_trails->Initialize();
+        m_tracerStyle.headWidth = 0.05f;
+        m_tracerStyle.headColor = glm::vec4(1.0f, 0.9f, 0.5f, 1.0f);
+        m_tracerStyle.tailColor = glm::vec4(1.0f, 0.5f, 0.1f, 0.0f);
+        m_tracerStyle.lifetime = 0.15f;
+        m_smokeStyle.headWidth = 0.1f;
+        m_smokeStyle.tailWidth = 0.4f;
+        m_smokeStyle.headColor = glm::vec4(0.8f, 0.8f, 0.8f, 0.6f);
+        m_smokeStyle.tailColor = glm::vec4(0.5f, 0.5f, 0.5f, 0.0f);
+        m_smokeStyle.lifetime = 1.0f;
+        m_smokeStyle.minSegmentLength = 0.25f;
+
+        // Target hits spawn a one-shot burst of fire particles
+        m_particleSystem = std::make_unique<agl::ParticleSystem>();
+        m_particleSystem->Initialize();
+        auto fireTexture = agl::Texture2D::LoadFromFileStatic("assets/textures/Particles/fire.png");
+        if (fireTexture) {
+            m_explosionDesc.texture = m_particleSystem->AddTexture(std::move(fireTexture));
+        }
+        m_explosionDesc.maxParticles = 256;
+        m_explosionDesc.spawnRate = 0.0f;
+        m_explosionDesc.spreadAngle = 3.14159f;
+        m_explosionDesc.spawnRadius = 0.3f;
+        m_explosionDesc.minSpeed = 2.0f;
+        m_explosionDesc.maxSpeed = 6.0f;
+        m_explosionDesc.minLifetime = 0.4f;
+        m_explosionDesc.maxLifetime = 0.9f;
+        m_explosionDesc.gravity = glm::vec3(0.0f, -2.0f, 0.0f);
+        m_explosionDesc.drag = 2.0f;
+        m_explosionDesc.startColor = glm::vec4(1.0f, 0.8f, 0.3f, 1.0f);
+        m_explosionDesc.endColor = glm::vec4(0.8f, 0.1f, 0.0f, 0.0f);
+        m_explosionDesc.startSize = 0.4f;
+        m_explosionDesc.endSize = 1.2f;
+        m_explosionDesc.blendMode = agl::ParticleBlendMode::Additive;
+
         std::cout << "Projectile Demo initialized successfully!" << std::endl;
         return true;
     }
@@ -68,10 +158,16 @@ public:
         // Update controller
         m_controller->Update(deltaTime);
 
-        // Update projectile system
+        // Update projectile system; missiles steer toward the current target positions
+        m_projectileSystem->SetHomingTargets(m_targetPositions);
         m_projectileSystem->Update(deltaTime);
         m_shooter->Update(deltaTime);
 
+        // Remove projectiles that hit a target
+        CheckTargetHits();
+        m_trails->Update(deltaTime);
+        m_particleSystem->Update(deltaTime);
+
         // Handle input
         HandleInput(deltaTime);
 
@@ -98,10 +194,18 @@ public:
         glEnable(GL_DEPTH_TEST);
 
         // Render projectiles
-        m_projectileSystem->Render(*m_meshShader, view, projection);
+        if (m_instancedRendering) {
+            m_projectileSystem->RenderInstanced(view, projection);
+        } else {
+            m_projectileSystem->Render(*m_meshShader, view, projection);
+        }
 
         // Render a simple target grid
         RenderTargetGrid(view, projection);
+
+        // Trails and particles last, so they blend over the opaque scene
+        m_trails->Render(view, projection);
+        m_particleSystem->Render(view, projection);
     }
 
     void OnImGuiRender() override {
@@ -110,6 +214,17 @@ public:
         // Projectile system stats
         ImGui::Text("Active Projectiles: %zu", m_projectileSystem->GetActiveCount());
         ImGui::Text("Max Projectiles: %zu", m_projectileSystem->GetMaxProjectiles());
+        ImGui::Text("Simulated: %zu, Analytic: %zu", m_projectileSystem->GetSimulatedCount(),
+                    m_projectileSystem->GetActiveCount() - m_projectileSystem->GetSimulatedCount());
+        ImGui::Text("Homing: %zu", m_projectileSystem->GetHomingCount());
+        ImGui::Text("SIMD Path: %s", agl::simd::GetInstructionSetName(agl::simd::GetInstructionSet()));
+
+        const agl::ProjectileRenderStats &renderStats = m_projectileSystem->GetRenderStats();
+        ImGui::Checkbox("Instanced Rendering", &m_instancedRendering);
+        ImGui::Text("Instances: %u, Draw Calls: %u", renderStats.instanceCount, renderStats.drawCalls);
+        ImGui::Text("Target Hits: %d", m_targetHits);
+        ImGui::Text("Particles: %zu", m_particleSystem->GetTotalParticleCount());
+        ImGui::Text("Trails: %zu", m_trails->GetTrailCount());
 
         ImGui::Separator();
 
@@ -137,6 +252,14 @@ public:
         ImGui::SameLine();
         ImGui::Checkbox("Auto Fire", &m_autoFire);
 
+        ImGui::Combo("Burst Pattern", &m_burstPatternIndex, m_burstPatternNames, 3);
+        ImGui::SliderInt("Burst Count", &m_burstCount, 2, 64);
+        ImGui::SliderFloat("Burst Spread", &m_burstSpread, 0.01f, 0.8f, "%.2f rad");
+        ImGui::SliderFloat("Missile Turn Rate", &m_missileTurnRate, 0.1f, 10.0f, "%.1f rad/sec");
+        if (ImGui::Button("Fire Burst") && m_shooter->CanFire()) {
+            FireBurst();
+        }
+
         if (m_autoFire) {
             ImGui::SliderFloat("Auto Fire Interval", &m_autoFireInterval, 0.1f, 5.0f, "%.1f sec");
         }
@@ -284,6 +407,66 @@ private:
         }
     }
 
+    void FireBurst() {
+        agl::ProjectileType type = m_projectileTypes[m_currentProjectileIndex];
+        glm::vec3 cameraFront = m_camera->GetFront();
+        glm::vec3 firePos = m_camera->GetPosition() + cameraFront * 0.5f;
+
+        agl::SpreadPattern pattern(static_cast<agl::SpreadShape>(m_burstPatternIndex), cameraFront, m_burstSpread);
+        m_burstHandles.clear();
+        size_t spawned =
+            m_shooter->FireBatch(firePos, pattern, static_cast<size_t>(m_burstCount), type, &m_burstHandles);
+
+        // Missile bursts spread over the target grid
+        if (type == agl::ProjectileType::Missile) {
+            for (size_t i = 0; i < m_burstHandles.size(); ++i) {
+                const uint32_t target = static_cast<uint32_t>(i % m_targetPositions.size());
+                m_projectileSystem->SetHoming(m_burstHandles[i], agl::HomingParams(m_missileTurnRate, target));
+            }
+        }
+
+        if (type == agl::ProjectileType::Bullet || type == agl::ProjectileType::Missile) {
+            const agl::TrailStyle &style = type == agl::ProjectileType::Bullet ? m_tracerStyle : m_smokeStyle;
+            for (const agl::ProjectileHandle &handle : m_burstHandles) {
+                m_trails->Attach(handle, style);
+            }
+        }
+
+        if (spawned > 0) {
+            std::cout << "Fired burst of " << spawned << " " << m_projectileNames[m_currentProjectileIndex]
+                      << " projectiles!" << std::endl;
+        }
+    }
+
+    void CheckTargetHits() {
+        // Swept test, so fast projectiles cannot skip over a target between two frames
+        m_projectileSystem->SweepTargets(m_targets, {}, {}, m_hits);
+
+        // Resolve indices to handles up front, since every removal moves another projectile
+        m_hitHandles.clear();
+        for (const agl::SweptHit &hit : m_hits) {
+            m_hitHandles.push_back(m_projectileSystem->GetHandle(hit.segmentIndex));
+        }
+
+        m_targetHits += static_cast<int>(m_projectileSystem->RemoveProjectiles(m_hitHandles));
+        for (const agl::SweptHit &hit : m_hits) {
+            SpawnExplosion(m_targets[hit.targetIndex].center);
+        }
+
+        for (const agl::HitscanEvent &event : m_projectileSystem->GetHitscanEvents()) {
+            if (event.targetType != agl::CollisionShapeType::None) {
+                ++m_targetHits;
+                SpawnExplosion(event.origin + event.direction * event.distance);
+            }
+        }
+    }
+
+    void SpawnExplosion(const glm::vec3 &position) {
+        const uint32_t emitter = m_particleSystem->CreateEmitter(m_explosionDesc, position);
+        m_particleSystem->Burst(emitter, 64);
+        m_particleSystem->DestroyEmitterWhenIdle(emitter);
+    }
+
     void RenderTargetGrid(const glm::mat4 &view, const glm::mat4 &projection) {
         // Create a simple grid of cubes as targets
         static std::unique_ptr<agl::Mesh> targetCube = nullptr;
@@ -77,9 +77,12 @@ public:
         m_objects.clear();
         m_objectTransforms.clear();
 
+        // Identical shapes share their geometry through the primitive cache; only the materials differ
+        PrimitiveCache &primitives = PrimitiveCache::Instance();
+
         // Cubes
         for (int i = 0; i < 3; ++i) {
-            auto cube = std::make_unique<Mesh>(Mesh::CreateCube());
+            auto cube = std::make_unique<Mesh>(primitives.CreateMesh(PrimitiveDesc::Cube()));
 
             // Set different materials for variety
             Material material;
@@ -108,7 +111,7 @@ public:
 
         // Spheres
         for (int i = 0; i < 2; ++i) {
-            auto sphere = std::make_unique<Mesh>(Mesh::CreateSphere(0.8f, 24, 12));
+            auto sphere = std::make_unique<Mesh>(primitives.CreateMesh(PrimitiveDesc::Sphere(0.8f, 24, 12)));
 
             Material material;
             if (i == 0) {